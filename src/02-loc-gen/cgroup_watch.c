@@ -0,0 +1,281 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <dirent.h>
+#include <errno.h>
+#include <time.h>
+#include <sys/inotify.h>
+#include "cgroup_watch.h"
+
+#define CGROUP_MIN_GROUPS 64
+#define CGROUP_WATCH_MASK (IN_CREATE | IN_DELETE | IN_MOVED_TO | IN_MOVED_FROM | IN_ONLYDIR)
+
+static void close_fd(int* fd) {
+    if (*fd >= 0) close(*fd);
+    *fd = -1;
+}
+
+static int map_wd(cgroup_watch_t* cw, int wd, int index) {
+    if (wd >= cw->wd_cap) {
+        int cap = cw->wd_cap ? cw->wd_cap : CGROUP_MIN_GROUPS;
+        while (cap <= wd) cap *= 2;
+        int* by_wd = realloc(cw->by_wd, sizeof(int) * (size_t)cap);
+        if (!by_wd) return -1;
+        for (int i = cw->wd_cap; i < cap; i++) by_wd[i] = -1;
+        cw->by_wd = by_wd;
+        cw->wd_cap = cap;
+    }
+    cw->by_wd[wd] = index;
+    return 0;
+}
+
+static int find_index(const cgroup_watch_t* cw, const char* path) {
+    for (int i = 0; i < cw->count; i++) {
+        if (strcmp(cw->groups[i].path, path) == 0) return i;
+    }
+    return -1;
+}
+
+static void release(cgroup_watch_t* cw, int index) {
+    cgroup_t* g = &cw->groups[index];
+    if (g->wd >= 0) {
+        inotify_rm_watch(cw->inotify_fd, g->wd);
+        cw->by_wd[g->wd] = -1;
+    }
+    close_fd(&g->cpu_fd);
+    close_fd(&g->mem_fd);
+    close_fd(&g->memstat_fd);
+    close_fd(&g->io_fd);
+    close_fd(&g->dirfd);
+
+    // Keep the array dense: move the last group into the hole
+    int last = --cw->count;
+    if (index != last) {
+        cw->groups[index] = cw->groups[last];
+        if (cw->groups[index].wd >= 0) cw->by_wd[cw->groups[index].wd] = index;
+    }
+    cw->removed++;
+}
+
+// Forget a group and everything below it
+static void remove_tree(cgroup_watch_t* cw, const char* path) {
+    size_t len = strlen(path);
+    for (int i = cw->count - 1; i >= 0; i--) {
+        const char* p = cw->groups[i].path;
+        // release() moves the last group, already visited, into slot i
+        if (strncmp(p, path, len) == 0 && (p[len] == '\0' || p[len] == '/')) release(cw, i);
+    }
+}
+
+// Returns -1 if the joined path does not fit
+static int join_path(char* out, size_t size, const char* parent, const char* name) {
+    int n = *parent ? snprintf(out, size, "%s/%s", parent, name) : snprintf(out, size, "%s", name);
+    return n >= 0 && (size_t)n < size ? 0 : -1;
+}
+
+// Watch and open one cgroup, then walk its children: they may predate the watch
+static int add_tree(cgroup_watch_t* cw, const char* path) {
+    if (find_index(cw, path) >= 0) return 0;
+    if (cw->count == cw->cap) {
+        int cap = cw->cap ? cw->cap * 2 : CGROUP_MIN_GROUPS;
+        cgroup_t* groups = realloc(cw->groups, sizeof(cgroup_t) * (size_t)cap);
+        if (!groups) return -1;
+        cw->groups = groups;
+        cw->cap = cap;
+    }
+
+    char full[CGROUP_PATH_LEN * 2];
+    if (join_path(full, sizeof(full), cw->root, path) != 0) return 0;
+    int dirfd = open(full, O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (dirfd < 0) return 0;            // already gone
+
+    int index = cw->count++;
+    cgroup_t* g = &cw->groups[index];
+    memset(g, 0, sizeof(*g));
+    snprintf(g->path, sizeof(g->path), "%s", path);
+    g->dirfd = dirfd;
+    g->cpu_fd = openat(dirfd, "cpu.stat", O_RDONLY | O_CLOEXEC);
+    g->mem_fd = openat(dirfd, "memory.current", O_RDONLY | O_CLOEXEC);
+    g->memstat_fd = openat(dirfd, "memory.stat", O_RDONLY | O_CLOEXEC);
+    g->io_fd = openat(dirfd, "io.stat", O_RDONLY | O_CLOEXEC);
+    g->wd = inotify_add_watch(cw->inotify_fd, full, CGROUP_WATCH_MASK);
+    if (g->wd >= 0 && map_wd(cw, g->wd, index) != 0) return -1;
+    if (cw->last_ns) cw->created++;
+
+    int fd = openat(dirfd, ".", O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    DIR* dir = fd >= 0 ? fdopendir(fd) : NULL;
+    if (!dir) {
+        if (fd >= 0) close(fd);
+        return 0;
+    }
+    struct dirent* d;
+    while ((d = readdir(dir)) != NULL) {
+        if (d->d_type != DT_DIR || d->d_name[0] == '.') continue;
+        char child[CGROUP_PATH_LEN];
+        if (join_path(child, sizeof(child), path, d->d_name) != 0) continue;
+        if (add_tree(cw, child) != 0) {
+            closedir(dir);
+            return -1;
+        }
+    }
+    closedir(dir);
+    return 0;
+}
+
+int cgroup_watch_init(cgroup_watch_t* cw, const char* root) {
+    memset(cw, 0, sizeof(*cw));
+    if (strlen(root) >= sizeof(cw->root)) return -1;
+    snprintf(cw->root, sizeof(cw->root), "%s", root);
+    cw->inotify_fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    cw->buf = malloc(CGROUP_BUF_SIZE);
+    if (cw->inotify_fd < 0 || !cw->buf) {
+        perror("inotify_init1");
+        cgroup_watch_free(cw);
+        return -1;
+    }
+    if (add_tree(cw, "") != 0 || cw->count == 0) {
+        fprintf(stderr, "Cannot watch cgroup tree %s\n", root);
+        cgroup_watch_free(cw);
+        return -1;
+    }
+    return 0;
+}
+
+static void rescan(cgroup_watch_t* cw) {
+    while (cw->count > 0) release(cw, cw->count - 1);
+    cw->rescans++;
+    add_tree(cw, "");
+}
+
+// Drain the inotify queue without blocking
+static void apply_events(cgroup_watch_t* cw) {
+    for (;;) {
+        ssize_t n = read(cw->inotify_fd, cw->buf, CGROUP_BUF_SIZE);
+        if (n <= 0) return;
+        for (char* p = cw->buf; p < cw->buf + n;) {
+            struct inotify_event* ev = (struct inotify_event*)p;
+            p += sizeof(*ev) + ev->len;
+            if (ev->mask & IN_Q_OVERFLOW) {
+                rescan(cw);
+                return;
+            }
+            int parent = ev->wd >= 0 && ev->wd < cw->wd_cap ? cw->by_wd[ev->wd] : -1;
+            if (parent < 0 || !(ev->mask & IN_ISDIR) || ev->len == 0) continue;
+
+            char path[CGROUP_PATH_LEN];
+            if (join_path(path, sizeof(path), cw->groups[parent].path, ev->name) != 0) continue;
+            if (ev->mask & (IN_CREATE | IN_MOVED_TO)) {
+                add_tree(cw, path);
+            } else if (ev->mask & (IN_DELETE | IN_MOVED_FROM)) {
+                remove_tree(cw, path);
+            }
+        }
+    }
+}
+
+static int read_fd(cgroup_watch_t* cw, int fd) {
+    if (fd < 0) return -1;
+    ssize_t n = pread(fd, cw->buf, CGROUP_BUF_SIZE - 1, 0);
+    if (n < 0) return -1;
+    cw->buf[n] = '\0';
+    return (int)n;
+}
+
+static double per_sec(uint64_t now, uint64_t before, double seconds) {
+    return now >= before ? (double)(now - before) / seconds : 0;
+}
+
+// Returns -1 if the group disappeared under us
+static int sample_group(cgroup_watch_t* cw, cgroup_t* g, double seconds) {
+    proc_cg_cpu_t cpu = g->cpu;
+    proc_cg_io_t io = g->io;
+    int n;
+
+    if (g->cpu_fd >= 0) {
+        if ((n = read_fd(cw, g->cpu_fd)) < 0) return -1;
+        proc_parse_cg_cpu(cw->buf, (size_t)n, &cpu);
+    }
+    if (g->mem_fd >= 0 && (n = read_fd(cw, g->mem_fd)) > 0) {
+        const char* p = cw->buf;
+        proc_parse_u64(&p, cw->buf + n, &g->memory_current);
+    }
+    if (g->memstat_fd >= 0 && (n = read_fd(cw, g->memstat_fd)) > 0) {
+        proc_parse_cg_memstat(cw->buf, (size_t)n, &g->memstat);
+    }
+    if (g->io_fd >= 0 && (n = read_fd(cw, g->io_fd)) >= 0) {
+        proc_parse_cg_io(cw->buf, (size_t)n, &io);
+    }
+
+    if (g->has_sample && seconds > 0) {
+        double usec = seconds * 1e6;
+        g->cpu_pct = (float)(100.0 * per_sec(cpu.usage_usec, g->cpu.usage_usec, 1.0) / usec);
+        g->throttled_pct = (float)(100.0 * per_sec(cpu.throttled_usec, g->cpu.throttled_usec, 1.0) / usec);
+        g->read_bytes_per_sec = per_sec(io.rbytes, g->io.rbytes, seconds);
+        g->write_bytes_per_sec = per_sec(io.wbytes, g->io.wbytes, seconds);
+    }
+    g->cpu = cpu;
+    g->io = io;
+    g->has_sample = 1;
+    return 0;
+}
+
+int cgroup_watch_sample_at(cgroup_watch_t* cw, uint64_t now_ns) {
+    cw->created = cw->removed = 0;
+    apply_events(cw);
+
+    double seconds = cw->last_ns && now_ns > cw->last_ns ? (now_ns - cw->last_ns) / 1e9 : 0;
+    // Walk backwards so release() only moves groups already sampled. A group
+    // removed before its event was read fails here; the event finds nothing later.
+    for (int i = cw->count - 1; i >= 0; i--) {
+        if (sample_group(cw, &cw->groups[i], seconds) != 0) release(cw, i);
+    }
+    cw->last_ns = now_ns;
+    return cw->count;
+}
+
+int cgroup_watch_sample(cgroup_watch_t* cw) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return cgroup_watch_sample_at(cw, (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec);
+}
+
+const cgroup_t* cgroup_watch_find(const cgroup_watch_t* cw, const char* path) {
+    int i = find_index(cw, path);
+    return i >= 0 ? &cw->groups[i] : NULL;
+}
+
+// The max_groups busiest groups by CPU
+int format_cgroup_watch(const cgroup_watch_t* cw, int max_groups, char* buf, size_t size) {
+    int len = proc_append(buf, size, 0, "%d cgroups under %s (%d created, %d removed)\n",
+                          cw->count, cw->root, cw->created, cw->removed);
+    char* shown = calloc((size_t)cw->count + 1, 1);
+    if (!shown) return -1;
+    for (int k = 0; k < max_groups && k < cw->count; k++) {
+        int best = -1;
+        for (int i = 0; i < cw->count; i++) {
+            if (!shown[i] && (best < 0 || cw->groups[i].cpu_pct > cw->groups[best].cpu_pct)) best = i;
+        }
+        shown[best] = 1;
+        const cgroup_t* g = &cw->groups[best];
+        len = proc_append(buf, size, len,
+                          "%-40s cpu %.1f%% thr %.1f%% mem %llu kB anon %llu kB io r %.1f w %.1f kB/s\n",
+                          *g->path ? g->path : "/", g->cpu_pct, g->throttled_pct,
+                          (unsigned long long)(g->memory_current / 1024),
+                          (unsigned long long)(g->memstat.anon / 1024),
+                          g->read_bytes_per_sec / 1024.0, g->write_bytes_per_sec / 1024.0);
+    }
+    free(shown);
+    return len;
+}
+
+void cgroup_watch_free(cgroup_watch_t* cw) {
+    while (cw->count > 0) release(cw, cw->count - 1);
+    if (cw->inotify_fd >= 0) close(cw->inotify_fd);
+    free(cw->groups);
+    free(cw->by_wd);
+    free(cw->buf);
+    memset(cw, 0, sizeof(*cw));
+    cw->inotify_fd = -1;
+}
@@ -0,0 +1,56 @@
+#ifndef CGROUP_WATCH_H
+#define CGROUP_WATCH_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "proc_parse.h"
+
+#define CGROUP_PATH_LEN 256
+#define CGROUP_BUF_SIZE 8192
+
+// One cgroup in the watched subtree with its stat files held open
+typedef struct {
+    char path[CGROUP_PATH_LEN];     // relative to the watch root, "" for the root
+    int wd;                         // inotify watch on the directory
+    int dirfd;
+    int cpu_fd;                     // -1 when the controller is not enabled
+    int mem_fd;
+    int memstat_fd;
+    int io_fd;
+    int has_sample;
+    proc_cg_cpu_t cpu;
+    proc_cg_io_t io;
+    proc_cg_memstat_t memstat;
+    uint64_t memory_current;
+    // From the last two samples
+    float cpu_pct;                  // 100 = one CPU
+    float throttled_pct;
+    double read_bytes_per_sec;
+    double write_bytes_per_sec;
+} cgroup_t;
+
+typedef struct {
+    char root[CGROUP_PATH_LEN];
+    int inotify_fd;
+    cgroup_t* groups;
+    int count;
+    int cap;
+    int* by_wd;                     // inotify wd -> index in groups, -1 if none
+    int wd_cap;
+    char* buf;
+    uint64_t last_ns;
+    int created;                    // since the previous sample
+    int removed;
+    unsigned long rescans;          // full walks after inotify overflow
+} cgroup_watch_t;
+
+int cgroup_watch_init(cgroup_watch_t* cw, const char* root);
+// Apply pending create/remove events and read every group; returns the
+// number of groups or -1
+int cgroup_watch_sample(cgroup_watch_t* cw);
+int cgroup_watch_sample_at(cgroup_watch_t* cw, uint64_t now_ns);
+const cgroup_t* cgroup_watch_find(const cgroup_watch_t* cw, const char* path);
+int format_cgroup_watch(const cgroup_watch_t* cw, int max_groups, char* buf, size_t size);
+void cgroup_watch_free(cgroup_watch_t* cw);
+
+#endif
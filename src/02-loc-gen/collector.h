@@ -0,0 +1,61 @@
+#ifndef COLLECTOR_H
+#define COLLECTOR_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Collector plugin ABI. A plugin is a shared object exporting
+//
+//     const collector_ops_t* collector_plugin(void);
+//
+// and is loaded from the plugin directory at startup. This header is all a
+// plugin needs; bump COLLECTOR_ABI_VERSION whenever the layout changes.
+
+#define COLLECTOR_ABI_VERSION 1
+#define COLLECTOR_ENTRY_SYMBOL "collector_plugin"
+#define COLLECTOR_MAX_METRICS 32
+
+typedef enum {
+    METRIC_U64 = 1,
+    METRIC_F64
+} metric_type_t;
+
+typedef enum {
+    METRIC_GAUGE = 1,       // reported as sampled
+    METRIC_COUNTER          // monotonic; reported as a per-second rate
+} metric_kind_t;
+
+typedef struct {
+    const char* name;
+    const char* unit;       // of the sampled value, e.g. "kB" or "pages"
+    metric_type_t type;
+    metric_kind_t kind;
+} metric_desc_t;
+
+typedef union {
+    uint64_t u64;
+    double f64;
+} metric_value_t;
+
+typedef struct {
+    uint32_t abi_version;
+    const char* name;                   // room type, e.g. "loadavg-room"
+    const metric_desc_t* metrics;
+    int metric_count;
+    int interval_ms;                    // default sampling period
+    // Per-room state, NULL on failure; target is NULL when none was given
+    void* (*init)(const char* target);
+    // Fill values[metric_count]; returns 0 or -1
+    int (*sample)(void* state, metric_value_t* values);
+    // Optional. Reported values from two samples `seconds` apart; when
+    // NULL counters become per-second rates (as F64) and gauges are copied.
+    int (*diff)(void* state, const metric_value_t* prev, const metric_value_t* cur,
+                double seconds, metric_value_t* out);
+    // Optional, snprintf-style. When NULL each metric prints on its own line.
+    int (*serialise)(void* state, const metric_value_t* values, char* buf, size_t size);
+    void (*teardown)(void* state);
+} collector_ops_t;
+
+typedef const collector_ops_t* (*collector_entry_t)(void);
+
+#endif
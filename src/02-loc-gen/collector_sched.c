@@ -0,0 +1,141 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "collector_sched.h"
+#include "plugin_registry.h"
+
+#define MS 1000000ULL
+
+int collector_task_init(collector_task_t* task, const collector_ops_t* ops, const char* target, int interval_ms) {
+    memset(task, 0, sizeof(*task));
+    task->ops = ops;
+    task->interval_ms = interval_ms > 0 ? interval_ms
+                      : ops->interval_ms > 0 ? ops->interval_ms : COLLECTOR_DEFAULT_INTERVAL_MS;
+    task->state = ops->init(target);
+    return task->state ? 0 : -1;
+}
+
+int collector_task_sample(collector_task_t* task, uint64_t now_ns) {
+    const collector_ops_t* ops = task->ops;
+    memcpy(task->prev, task->cur, sizeof(metric_value_t) * (size_t)ops->metric_count);
+    if (ops->sample(task->state, task->cur) != 0) {
+        memcpy(task->cur, task->prev, sizeof(metric_value_t) * (size_t)ops->metric_count);
+        task->errors++;
+        return -1;
+    }
+    // The first sample reports gauges and zero rates
+    double seconds = task->has_sample && now_ns > task->last_ns ? (now_ns - task->last_ns) / 1e9 : 0;
+    if (plugin_diff(ops, task->state, task->has_sample ? task->prev : task->cur, task->cur,
+                    seconds, task->out) != 0) {
+        task->errors++;
+        return -1;
+    }
+    task->has_rates = task->has_sample;
+    task->has_sample = 1;
+    task->last_ns = now_ns;
+    return 0;
+}
+
+int collector_task_format(const collector_task_t* task, char* buf, size_t size) {
+    return plugin_format(task->ops, task->state, task->out, buf, size);
+}
+
+void collector_task_free(collector_task_t* task) {
+    if (task->state && task->ops->teardown) task->ops->teardown(task->state);
+    task->state = NULL;
+}
+
+void collector_sched_init(collector_sched_t* cs) {
+    memset(cs, 0, sizeof(*cs));
+}
+
+static int find_batch(collector_sched_t* cs, int interval_ms, uint64_t now_ns) {
+    for (int i = 0; i < cs->batch_count; i++) {
+        if (cs->batches[i].interval_ms == interval_ms) return i;
+    }
+    if (cs->batch_count == cs->batch_cap) {
+        int cap = cs->batch_cap ? cs->batch_cap * 2 : 4;
+        collector_batch_t* grown = realloc(cs->batches, sizeof(*grown) * (size_t)cap);
+        if (!grown) return -1;
+        cs->batches = grown;
+        cs->batch_cap = cap;
+    }
+    collector_batch_t* b = &cs->batches[cs->batch_count];
+    memset(b, 0, sizeof(*b));
+    b->interval_ms = interval_ms;
+    b->next_ns = now_ns;
+    return cs->batch_count++;
+}
+
+int collector_sched_add(collector_sched_t* cs, const collector_ops_t* ops, const char* target,
+                        int interval_ms, uint64_t now_ns) {
+    if (cs->count == cs->cap) {
+        int cap = cs->cap ? cs->cap * 2 : 8;
+        collector_task_t* grown = realloc(cs->tasks, sizeof(*grown) * (size_t)cap);
+        if (!grown) return -1;
+        cs->tasks = grown;
+        cs->cap = cap;
+    }
+    collector_task_t* task = &cs->tasks[cs->count];
+    if (collector_task_init(task, ops, target, interval_ms) != 0) return -1;
+    int batch = find_batch(cs, task->interval_ms, now_ns);
+    if (batch < 0) {
+        collector_task_free(task);
+        return -1;
+    }
+    task->batch = batch;
+    cs->batches[batch].members++;
+    return cs->count++;
+}
+
+int collector_sched_run(collector_sched_t* cs, uint64_t now_ns, uint64_t* next_ns) {
+    // Mark the due batches first so the tasks are walked once
+    unsigned char due_stack[64];
+    unsigned char* due = cs->batch_count <= 64 ? due_stack : malloc((size_t)cs->batch_count);
+    if (!due) return -1;
+    int any = 0;
+    for (int b = 0; b < cs->batch_count; b++) {
+        due[b] = cs->batches[b].next_ns <= now_ns;
+        any |= due[b];
+    }
+
+    int sampled = 0;
+    if (any) {
+        for (int i = 0; i < cs->count; i++) {
+            collector_task_t* task = &cs->tasks[i];
+            if (!due[task->batch]) continue;
+            collector_task_sample(task, now_ns);
+            sampled++;
+        }
+    }
+
+    uint64_t earliest = UINT64_MAX;
+    for (int b = 0; b < cs->batch_count; b++) {
+        collector_batch_t* batch = &cs->batches[b];
+        if (due[b]) {
+            // Skip missed periods rather than running them back to back
+            uint64_t period = (uint64_t)batch->interval_ms * MS;
+            batch->next_ns += period;
+            if (batch->next_ns <= now_ns) batch->next_ns = now_ns + period;
+            batch->runs++;
+        }
+        if (batch->members && batch->next_ns < earliest) earliest = batch->next_ns;
+    }
+    if (due != due_stack) free(due);
+    if (next_ns) *next_ns = earliest;
+    return sampled;
+}
+
+const collector_task_t* collector_sched_find(const collector_sched_t* cs, const char* name) {
+    for (int i = 0; i < cs->count; i++) {
+        if (strcmp(cs->tasks[i].ops->name, name) == 0) return &cs->tasks[i];
+    }
+    return NULL;
+}
+
+void collector_sched_free(collector_sched_t* cs) {
+    for (int i = 0; i < cs->count; i++) collector_task_free(&cs->tasks[i]);
+    free(cs->tasks);
+    free(cs->batches);
+    memset(cs, 0, sizeof(*cs));
+}
@@ -0,0 +1,58 @@
+#ifndef COLLECTOR_SCHED_H
+#define COLLECTOR_SCHED_H
+
+#include <stdint.h>
+#include "collector.h"
+
+#define COLLECTOR_DEFAULT_INTERVAL_MS 1000
+
+// One collector instance with its last two samples
+typedef struct {
+    const collector_ops_t* ops;
+    void* state;
+    int interval_ms;
+    int batch;                  // index into collector_sched_t.batches
+    metric_value_t prev[COLLECTOR_MAX_METRICS];
+    metric_value_t cur[COLLECTOR_MAX_METRICS];
+    metric_value_t out[COLLECTOR_MAX_METRICS];  // reported values
+    int has_rates;              // out[] spans two samples
+    int has_sample;
+    uint64_t last_ns;
+    unsigned long errors;
+} collector_task_t;
+
+int collector_task_init(collector_task_t* task, const collector_ops_t* ops, const char* target, int interval_ms);
+// Take a sample and refresh out[]; returns 0 or -1
+int collector_task_sample(collector_task_t* task, uint64_t now_ns);
+int collector_task_format(const collector_task_t* task, char* buf, size_t size);
+void collector_task_free(collector_task_t* task);
+
+// Tasks sharing a sampling period run back to back off one deadline, so N
+// collectors at the same interval cost one wakeup instead of N
+typedef struct {
+    int interval_ms;
+    int members;
+    uint64_t next_ns;
+    unsigned long runs;
+} collector_batch_t;
+
+typedef struct {
+    collector_task_t* tasks;
+    int count;
+    int cap;
+    collector_batch_t* batches;
+    int batch_count;
+    int batch_cap;
+} collector_sched_t;
+
+void collector_sched_init(collector_sched_t* cs);
+// interval_ms <= 0 uses the collector's own period; returns the task index
+int collector_sched_add(collector_sched_t* cs, const collector_ops_t* ops, const char* target,
+                        int interval_ms, uint64_t now_ns);
+// Sample every batch whose deadline has passed. Returns the number of tasks
+// sampled and stores the next deadline in *next_ns.
+int collector_sched_run(collector_sched_t* cs, uint64_t now_ns, uint64_t* next_ns);
+const collector_task_t* collector_sched_find(const collector_sched_t* cs, const char* name);
+void collector_sched_free(collector_sched_t* cs);
+
+#endif
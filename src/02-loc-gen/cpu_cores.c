@@ -0,0 +1,85 @@
+#include <string.h>
+#include "cpu_cores.h"
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+void cpu_cores_init(cpu_cores_t* cores) {
+    memset(cores, 0, sizeof(*cores));
+}
+
+// util[i] = 100 * (busy - prev_busy) / (total - prev_total), four cores per step
+static void compute_util(cpu_cores_t* cores, const uint32_t* busy, const uint32_t* total, int n) {
+    int i = 0;
+#ifdef __SSE2__
+    const __m128 hundred = _mm_set1_ps(100.0f);
+    const __m128 one = _mm_set1_ps(1.0f);
+    for (; i + 4 <= n; i += 4) {
+        __m128i db = _mm_sub_epi32(_mm_loadu_si128((const __m128i*)&busy[i]),
+                                   _mm_loadu_si128((const __m128i*)&cores->busy[i]));
+        __m128i dt = _mm_sub_epi32(_mm_loadu_si128((const __m128i*)&total[i]),
+                                   _mm_loadu_si128((const __m128i*)&cores->total[i]));
+        __m128 fb = _mm_cvtepi32_ps(db);
+        __m128 ft = _mm_max_ps(_mm_cvtepi32_ps(dt), one);
+        __m128 u = _mm_div_ps(_mm_mul_ps(fb, hundred), ft);
+        u = _mm_min_ps(_mm_max_ps(u, _mm_setzero_ps()), hundred);
+        _mm_storeu_ps(&cores->util[i], u);
+    }
+#endif
+    for (; i < n; i++) {
+        float db = (float)(int32_t)(busy[i] - cores->busy[i]);
+        float dt = (float)(int32_t)(total[i] - cores->total[i]);
+        if (dt < 1.0f) dt = 1.0f;
+        float u = db * 100.0f / dt;
+        cores->util[i] = u < 0.0f ? 0.0f : (u > 100.0f ? 100.0f : u);
+    }
+}
+
+int cpu_cores_update(cpu_cores_t* cores, const cpu_snapshot_t* snap) {
+    uint32_t busy[PROC_MAX_CPUS], total[PROC_MAX_CPUS];
+    int n = snap->stat.cpu_count;
+
+    // Gather the AoS parse output into SoA columns
+    for (int i = 0; i < n; i++) {
+        const proc_cpu_times_t* t = &snap->stat.cpu[i];
+        uint64_t b = t->user + t->nice + t->system + t->irq + t->softirq + t->steal;
+        busy[i] = (uint32_t)b;
+        total[i] = (uint32_t)(b + t->idle + t->iowait);
+    }
+
+    // Hotplug changes the core set; start over rather than mix cores
+    int same_set = cores->has_prev && cores->count == n &&
+                   memcmp(cores->cpu_id, snap->stat.cpu_index, sizeof(int) * (size_t)n) == 0;
+    if (same_set) {
+        compute_util(cores, busy, total, n);
+    } else {
+        memset(cores->util, 0, sizeof(cores->util));
+    }
+
+    cores->count = n;
+    memcpy(cores->cpu_id, snap->stat.cpu_index, sizeof(int) * (size_t)n);
+    memcpy(cores->busy, busy, sizeof(uint32_t) * (size_t)n);
+    memcpy(cores->total, total, sizeof(uint32_t) * (size_t)n);
+    cores->has_prev = 1;
+    return same_set ? n : 0;
+}
+
+int cpu_cores_top(const cpu_cores_t* cores, int k, int* cpu_ids, float* utils) {
+    if (k > cores->count) k = cores->count;
+    int found = 0;
+    // Insertion into a k-long sorted list; k is small next to the core count
+    for (int i = 0; i < cores->count; i++) {
+        float u = cores->util[i];
+        if (found == k && (k == 0 || u <= utils[k - 1])) continue;
+        int pos = found < k ? found++ : k - 1;
+        while (pos > 0 && utils[pos - 1] < u) {
+            utils[pos] = utils[pos - 1];
+            cpu_ids[pos] = cpu_ids[pos - 1];
+            pos--;
+        }
+        utils[pos] = u;
+        cpu_ids[pos] = cores->cpu_id[i];
+    }
+    return found;
+}
@@ -0,0 +1,26 @@
+#ifndef CPU_CORES_H
+#define CPU_CORES_H
+
+#include <stdint.h>
+#include "data_collector.h"
+
+// Per-core utilisation kept as struct-of-arrays so every core is updated
+// in one vectorised pass. Counters are stored modulo 2^32: jiffy deltas
+// between two samples are far below that, and unsigned wrap-around keeps
+// the subtraction exact.
+typedef struct {
+    int count;
+    int has_prev;
+    int cpu_id[PROC_MAX_CPUS];          // N from the "cpuN" line
+    uint32_t busy[PROC_MAX_CPUS];       // user+nice+system+irq+softirq+steal
+    uint32_t total[PROC_MAX_CPUS];      // busy + idle + iowait
+    float util[PROC_MAX_CPUS];          // percent over the last interval
+} cpu_cores_t;
+
+void cpu_cores_init(cpu_cores_t* cores);
+// Fold a new sample in; returns the number of cores with a utilisation value
+int cpu_cores_update(cpu_cores_t* cores, const cpu_snapshot_t* snap);
+// Busiest k cores from the last update, highest first; returns how many
+int cpu_cores_top(const cpu_cores_t* cores, int k, int* cpu_ids, float* utils);
+
+#endif
@@ -1,51 +1,212 @@
 #include <stdio.h>
 #include <string.h>
 #include <stdlib.h>
+#include <time.h>
 #include "data_collector.h"
+#include "proc_reader.h"
 
-int read_cpu_stats() {
-    FILE* f = fopen("/proc/stat", "r");
-    if (!f) {
-        perror("Failed to open /proc/stat");
-        return -1;
+// Opened on first use and kept open; each sample is a single pread()
+static proc_file_t stat_file = { .fd = -1 };
+static proc_file_t meminfo_file = { .fd = -1 };
+static proc_file_t diskstats_file = { .fd = -1 };
+
+static uint64_t monotonic_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+static proc_file_t* read_proc(proc_file_t* pf, const char* path) {
+    if (!pf->buf && proc_file_open(pf, path) != 0) {
+        perror("Failed to open procfs file");
+        return NULL;
     }
-    char line[256];
-    while (fgets(line, sizeof(line), f)) {
-        if (strncmp(line, "cpu ", 4) == 0) {
-            printf("CPU stats: %s", line);
-            break;
-        }
+    if (proc_file_read(pf) < 0) {
+        fprintf(stderr, "Failed to read %s\n", path);
+        return NULL;
     }
-    fclose(f);
-    return 0;
+    return pf;
 }
 
-int read_memory_stats() {
-    FILE* f = fopen("/proc/meminfo", "r");
-    if (!f) {
-        perror("Failed to open /proc/meminfo");
+int collect_cpu_stats(cpu_snapshot_t* out) {
+    proc_file_t* pf = read_proc(&stat_file, "/proc/stat");
+    if (!pf) return -1;
+    out->timestamp_ns = monotonic_ns();
+    if (proc_parse_stat(pf->buf, pf->len, &out->stat) != 0) {
+        fprintf(stderr, "Malformed /proc/stat\n");
         return -1;
     }
-    char line[256];
-    printf("Memory stats:\n");
-    while (fgets(line, sizeof(line), f)) {
-        printf("%s", line);
+    return 0;
+}
+
+int collect_memory_stats(memory_snapshot_t* out) {
+    proc_file_t* pf = read_proc(&meminfo_file, "/proc/meminfo");
+    if (!pf) return -1;
+    out->timestamp_ns = monotonic_ns();
+    if (proc_parse_meminfo(pf->buf, pf->len, &out->mem) != 0) {
+        fprintf(stderr, "Malformed /proc/meminfo\n");
+        return -1;
     }
-    fclose(f);
     return 0;
 }
 
-int read_io_stats() {
-    FILE* f = fopen("/proc/diskstats", "r");
-    if (!f) {
-        perror("Failed to open /proc/diskstats");
+int collect_io_stats(io_snapshot_t* out) {
+    proc_file_t* pf = read_proc(&diskstats_file, "/proc/diskstats");
+    if (!pf) return -1;
+    out->timestamp_ns = monotonic_ns();
+    out->disk_count = proc_parse_diskstats(pf->buf, pf->len, out->disks, PROC_MAX_DISKS);
+    if (out->disk_count < 0) {
+        out->disk_count = 0;
+        fprintf(stderr, "Malformed /proc/diskstats\n");
         return -1;
     }
-    char line[256];
-    printf("IO stats:\n");
-    while (fgets(line, sizeof(line), f)) {
-        printf("%s", line);
+    return 0;
+}
+
+static const proc_cpu_times_t* find_cpu(const cpu_snapshot_t* snap, int cpu) {
+    if (cpu < 0) return &snap->stat.total;
+    for (int i = 0; i < snap->stat.cpu_count; i++) {
+        if (snap->stat.cpu_index[i] == cpu) return &snap->stat.cpu[i];
+    }
+    return NULL;
+}
+
+double cpu_busy_percent(const cpu_snapshot_t* prev, const cpu_snapshot_t* cur, int cpu) {
+    const proc_cpu_times_t* a = find_cpu(prev, cpu);
+    const proc_cpu_times_t* b = find_cpu(cur, cpu);
+    if (!a || !b) return -1;
+
+    // guest time is already counted in user/nice
+    uint64_t idle_a = a->idle + a->iowait;
+    uint64_t idle_b = b->idle + b->iowait;
+    uint64_t total_a = a->user + a->nice + a->system + idle_a + a->irq + a->softirq + a->steal;
+    uint64_t total_b = b->user + b->nice + b->system + idle_b + b->irq + b->softirq + b->steal;
+    if (total_b <= total_a) return -1;
+    uint64_t idle = idle_b >= idle_a ? idle_b - idle_a : 0;
+    uint64_t total = total_b - total_a;
+    if (idle > total) idle = total;
+    return 100.0 * (double)(total - idle) / (double)total;
+}
+
+int io_snapshot_diff(const io_snapshot_t* prev, const io_snapshot_t* cur, io_snapshot_t* delta) {
+    delta->timestamp_ns = cur->timestamp_ns - prev->timestamp_ns;
+    delta->disk_count = cur->disk_count;
+    const int counters = 11;
+    for (int i = 0; i < cur->disk_count; i++) {
+        const proc_disk_t* now = &cur->disks[i];
+        proc_disk_t* out = &delta->disks[i];
+        *out = *now;
+
+        const proc_disk_t* before = NULL;
+        // Devices usually keep their position, so try the same index first
+        if (i < prev->disk_count && prev->disks[i].major == now->major &&
+            prev->disks[i].minor == now->minor) {
+            before = &prev->disks[i];
+        }
+        for (int j = 0; !before && j < prev->disk_count; j++) {
+            if (prev->disks[j].major == now->major && prev->disks[j].minor == now->minor) {
+                before = &prev->disks[j];
+            }
+        }
+        if (!before) continue;
+
+        const uint64_t* a = &before->reads;
+        const uint64_t* b = &now->reads;
+        uint64_t* d = &out->reads;
+        for (int k = 0; k < counters; k++) {
+            d[k] = b[k] >= a[k] ? b[k] - a[k] : 0;
+        }
+        // io_in_progress is a gauge, not a counter
+        out->io_in_progress = now->io_in_progress;
+    }
+    return delta->disk_count;
+}
+
+static int format_cpu_line(char* buf, size_t size, int len, const char* label,
+                           const proc_cpu_times_t* t) {
+    return proc_append(buf, size, len,
+                       "%-6s user %llu nice %llu system %llu idle %llu iowait %llu irq %llu softirq %llu steal %llu\n",
+                       label, (unsigned long long)t->user, (unsigned long long)t->nice,
+                       (unsigned long long)t->system, (unsigned long long)t->idle,
+                       (unsigned long long)t->iowait, (unsigned long long)t->irq,
+                       (unsigned long long)t->softirq, (unsigned long long)t->steal);
+}
+
+int format_cpu_snapshot(const cpu_snapshot_t* snap, char* buf, size_t size) {
+    int len = format_cpu_line(buf, size, 0, "cpu", &snap->stat.total);
+    for (int i = 0; i < snap->stat.cpu_count; i++) {
+        char label[16];
+        snprintf(label, sizeof(label), "cpu%d", snap->stat.cpu_index[i]);
+        len = format_cpu_line(buf, size, len, label, &snap->stat.cpu[i]);
     }
-    fclose(f);
+    return proc_append(buf, size, len, "procs_running %u procs_blocked %u ctxt %llu\n",
+                       snap->stat.procs_running, snap->stat.procs_blocked,
+                       (unsigned long long)snap->stat.ctxt);
+}
+
+int format_memory_snapshot(const memory_snapshot_t* snap, char* buf, size_t size) {
+    const proc_meminfo_t* m = &snap->mem;
+    return proc_append(buf, size, 0,
+                       "MemTotal: %llu kB\nMemFree: %llu kB\nMemAvailable: %llu kB\n"
+                       "Buffers: %llu kB\nCached: %llu kB\nSwapTotal: %llu kB\nSwapFree: %llu kB\n"
+                       "Dirty: %llu kB\nShmem: %llu kB\nSlab: %llu kB\n",
+                       (unsigned long long)m->mem_total, (unsigned long long)m->mem_free,
+                       (unsigned long long)m->mem_available, (unsigned long long)m->buffers,
+                       (unsigned long long)m->cached, (unsigned long long)m->swap_total,
+                       (unsigned long long)m->swap_free, (unsigned long long)m->dirty,
+                       (unsigned long long)m->shmem, (unsigned long long)m->slab);
+}
+
+int format_io_snapshot(const io_snapshot_t* snap, char* buf, size_t size) {
+    int len = 0;
+    for (int i = 0; i < snap->disk_count; i++) {
+        const proc_disk_t* d = &snap->disks[i];
+        len = proc_append(buf, size, len,
+                          "%-12s reads %llu sectors_read %llu writes %llu sectors_written %llu in_flight %llu io_ms %llu\n",
+                          d->name, (unsigned long long)d->reads, (unsigned long long)d->sectors_read,
+                          (unsigned long long)d->writes, (unsigned long long)d->sectors_written,
+                          (unsigned long long)d->io_in_progress, (unsigned long long)d->io_ms);
+    }
+    return len;
+}
+
+// Print a formatted snapshot, growing the buffer for large machines
+static int print_formatted(const void* snap, int (*format)(const void*, char*, size_t)) {
+    char small[4096];
+    int len = format(snap, small, sizeof(small));
+    if (len < (int)sizeof(small)) {
+        fputs(small, stdout);
+        return 0;
+    }
+    char* big = malloc((size_t)len + 1);
+    if (!big) return -1;
+    format(snap, big, (size_t)len + 1);
+    fputs(big, stdout);
+    free(big);
     return 0;
 }
+
+static int format_cpu_any(const void* s, char* b, size_t n) { return format_cpu_snapshot(s, b, n); }
+static int format_memory_any(const void* s, char* b, size_t n) { return format_memory_snapshot(s, b, n); }
+static int format_io_any(const void* s, char* b, size_t n) { return format_io_snapshot(s, b, n); }
+
+int read_cpu_stats() {
+    static cpu_snapshot_t snap;
+    if (collect_cpu_stats(&snap) != 0) return -1;
+    printf("CPU stats:\n");
+    return print_formatted(&snap, format_cpu_any);
+}
+
+int read_memory_stats() {
+    memory_snapshot_t snap;
+    if (collect_memory_stats(&snap) != 0) return -1;
+    printf("Memory stats:\n");
+    return print_formatted(&snap, format_memory_any);
+}
+
+int read_io_stats() {
+    static io_snapshot_t snap;
+    if (collect_io_stats(&snap) != 0) return -1;
+    printf("IO stats:\n");
+    return print_formatted(&snap, format_io_any);
+}
@@ -1,6 +1,45 @@
 #ifndef DATA_COLLECTOR_H
 #define DATA_COLLECTOR_H
 
+#include <stddef.h>
+#include <stdint.h>
+#include "proc_parse.h"
+
+// Typed samples; timestamps are CLOCK_MONOTONIC nanoseconds
+typedef struct {
+    uint64_t timestamp_ns;
+    proc_stat_t stat;           // aggregate and per-core jiffies
+} cpu_snapshot_t;
+
+typedef struct {
+    uint64_t timestamp_ns;
+    proc_meminfo_t mem;         // kB
+} memory_snapshot_t;
+
+typedef struct {
+    uint64_t timestamp_ns;
+    int disk_count;
+    proc_disk_t disks[PROC_MAX_DISKS];
+} io_snapshot_t;
+
+int collect_cpu_stats(cpu_snapshot_t* out);
+int collect_memory_stats(memory_snapshot_t* out);
+int collect_io_stats(io_snapshot_t* out);
+
+// Busy percentage between two samples; cpu < 0 selects the aggregate line.
+// Returns -1 if the CPU is missing from either sample or no time passed.
+double cpu_busy_percent(const cpu_snapshot_t* prev, const cpu_snapshot_t* cur, int cpu);
+
+// Per-device counter deltas (matched by major:minor); devices that
+// appeared since `prev` are reported with their absolute counters
+int io_snapshot_diff(const io_snapshot_t* prev, const io_snapshot_t* cur, io_snapshot_t* delta);
+
+// snprintf-style formatters; return the length that would be written
+int format_cpu_snapshot(const cpu_snapshot_t* snap, char* buf, size_t size);
+int format_memory_snapshot(const memory_snapshot_t* snap, char* buf, size_t size);
+int format_io_snapshot(const io_snapshot_t* snap, char* buf, size_t size);
+
+// Collect and print, as used by the loc_gen CLI
 int read_cpu_stats();
 int read_memory_stats();
 int read_io_stats();
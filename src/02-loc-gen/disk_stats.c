@@ -0,0 +1,210 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fnmatch.h>
+#include <time.h>
+#include "disk_stats.h"
+
+#define DISK_TABLE_MIN 64
+#define DISK_PARSE_MIN 64
+
+static uint32_t dev_key(uint32_t major, uint32_t minor) {
+    return (major << 20) | (minor & 0xFFFFF);
+}
+
+static size_t dev_hash(uint32_t key, size_t mask) {
+    return (size_t)((key * 2654435761u) >> 7) & mask;
+}
+
+static int split_patterns(const char* list, char patterns[][PROC_NAME_LEN]) {
+    int count = 0;
+    if (!list) return 0;
+    const char* p = list;
+    while (*p && count < DISK_FILTER_MAX) {
+        const char* comma = strchr(p, ',');
+        size_t n = comma ? (size_t)(comma - p) : strlen(p);
+        if (n > 0 && n < PROC_NAME_LEN) {
+            memcpy(patterns[count], p, n);
+            patterns[count][n] = '\0';
+            count++;
+        }
+        if (!comma) break;
+        p = comma + 1;
+    }
+    return count;
+}
+
+int disk_stats_init(disk_stats_t* ds, const char* include, const char* exclude) {
+    memset(ds, 0, sizeof(*ds));
+    ds->file.fd = -1;
+    ds->include_count = split_patterns(include, ds->include);
+    ds->exclude_count = split_patterns(exclude, ds->exclude);
+    ds->table = calloc(DISK_TABLE_MIN, sizeof(disk_entry_t));
+    if (!ds->table) return -1;
+    ds->table_size = DISK_TABLE_MIN;
+    return 0;
+}
+
+static int wanted(const disk_stats_t* ds, const char* name) {
+    for (int i = 0; i < ds->exclude_count; i++) {
+        if (fnmatch(ds->exclude[i], name, 0) == 0) return 0;
+    }
+    if (ds->include_count == 0) return 1;
+    for (int i = 0; i < ds->include_count; i++) {
+        if (fnmatch(ds->include[i], name, 0) == 0) return 1;
+    }
+    return 0;
+}
+
+static disk_entry_t* lookup(disk_entry_t* table, size_t size, uint32_t key) {
+    size_t mask = size - 1;
+    size_t i = dev_hash(key, mask);
+    while (table[i].dev != 0 && table[i].dev != key) i = (i + 1) & mask;
+    return &table[i];
+}
+
+// Rebuild into a table sized for `live` entries, dropping those not seen
+static int rebuild(disk_stats_t* ds, size_t live) {
+    size_t size = DISK_TABLE_MIN;
+    while (size < live * 2) size *= 2;
+    disk_entry_t* table = calloc(size, sizeof(disk_entry_t));
+    if (!table) return -1;
+    size_t used = 0;
+    for (size_t i = 0; i < ds->table_size; i++) {
+        if (ds->table[i].dev != 0 && ds->table[i].seen) {
+            *lookup(table, size, ds->table[i].dev) = ds->table[i];
+            used++;
+        }
+    }
+    free(ds->table);
+    ds->table = table;
+    ds->table_size = size;
+    ds->used = used;
+    return 0;
+}
+
+static double per_sec(uint64_t delta, double seconds) {
+    return (double)delta / seconds;
+}
+
+static uint64_t diff(uint64_t now, uint64_t before) {
+    return now >= before ? now - before : 0;
+}
+
+int disk_stats_update(disk_stats_t* ds, const char* buf, size_t len, uint64_t now_ns) {
+    // Parse everything; grow the scratch array until the whole file fits
+    int count;
+    for (;;) {
+        if (ds->parsed_cap == 0 || !ds->parsed) {
+            ds->parsed_cap = DISK_PARSE_MIN;
+            ds->parsed = malloc(sizeof(proc_disk_t) * (size_t)ds->parsed_cap);
+            ds->rates = malloc(sizeof(disk_rate_t) * (size_t)ds->parsed_cap);
+            if (!ds->parsed || !ds->rates) return -1;
+        }
+        count = proc_parse_diskstats(buf, len, ds->parsed, ds->parsed_cap);
+        if (count < 0) return -1;
+        if (count < ds->parsed_cap) break;
+        int cap = ds->parsed_cap * 2;
+        proc_disk_t* parsed = realloc(ds->parsed, sizeof(proc_disk_t) * (size_t)cap);
+        if (!parsed) return -1;
+        ds->parsed = parsed;
+        disk_rate_t* rates = realloc(ds->rates, sizeof(disk_rate_t) * (size_t)cap);
+        if (!rates) return -1;
+        ds->rates = rates;
+        ds->parsed_cap = cap;
+    }
+
+    if ((ds->used + (size_t)count) * 2 > ds->table_size) {
+        for (size_t i = 0; i < ds->table_size; i++) ds->table[i].seen = 1;
+        if (rebuild(ds, ds->used + (size_t)count) != 0) return -1;
+    }
+    for (size_t i = 0; i < ds->table_size; i++) ds->table[i].seen = 0;
+
+    double seconds = ds->last_ns && now_ns > ds->last_ns ? (now_ns - ds->last_ns) / 1e9 : 0;
+    double elapsed_ms = seconds * 1000.0;
+    int rates = 0;
+    size_t seen = 0;
+
+    for (int i = 0; i < count; i++) {
+        const proc_disk_t* d = &ds->parsed[i];
+        uint32_t key = dev_key(d->major, d->minor);
+        if (key == 0) continue;
+        disk_entry_t* e = lookup(ds->table, ds->table_size, key);
+        int fresh = e->dev == 0;
+        if (fresh) {
+            e->dev = key;
+            e->keep = (uint8_t)wanted(ds, d->name);
+            memcpy(e->name, d->name, sizeof(e->name));
+            ds->used++;
+        }
+        e->seen = 1;
+        seen++;
+        if (!e->keep) continue;
+
+        if (!fresh && seconds > 0) {
+            disk_rate_t* r = &ds->rates[rates++];
+            uint64_t reads = diff(d->reads, e->reads);
+            uint64_t writes = diff(d->writes, e->writes);
+            uint64_t wait_ms = diff(d->read_ms, e->read_ms) + diff(d->write_ms, e->write_ms);
+            r->major = d->major;
+            r->minor = d->minor;
+            memcpy(r->name, e->name, sizeof(r->name));
+            r->read_iops = per_sec(reads, seconds);
+            r->write_iops = per_sec(writes, seconds);
+            r->read_bytes_per_sec = per_sec(diff(d->sectors_read, e->sectors_read) * DISK_SECTOR_BYTES, seconds);
+            r->write_bytes_per_sec = per_sec(diff(d->sectors_written, e->sectors_written) * DISK_SECTOR_BYTES, seconds);
+            r->util_pct = 100.0 * (double)diff(d->io_ms, e->io_ms) / elapsed_ms;
+            if (r->util_pct > 100.0) r->util_pct = 100.0;
+            r->await_ms = reads + writes ? (double)wait_ms / (double)(reads + writes) : 0;
+        }
+        e->reads = d->reads;
+        e->writes = d->writes;
+        e->sectors_read = d->sectors_read;
+        e->sectors_written = d->sectors_written;
+        e->read_ms = d->read_ms;
+        e->write_ms = d->write_ms;
+        e->io_ms = d->io_ms;
+    }
+
+    // Forget devices that went away
+    if (seen < ds->used && rebuild(ds, seen) != 0) return -1;
+
+    ds->rate_count = rates;
+    ds->last_ns = now_ns;
+    return rates;
+}
+
+int disk_stats_sample(disk_stats_t* ds) {
+    if (!ds->file.buf && proc_file_open_paged(&ds->file, "/proc/diskstats") != 0) return -1;
+    if (proc_file_read(&ds->file) < 0) return -1;
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    uint64_t now = (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+    return disk_stats_update(ds, ds->file.buf, ds->file.len, now);
+}
+
+int format_disk_rates(const disk_stats_t* ds, char* buf, size_t size) {
+    size_t used = 0;
+    int len = 0;
+    for (int i = 0; i < ds->rate_count; i++) {
+        const disk_rate_t* r = &ds->rates[i];
+        int n = snprintf(buf ? buf + used : NULL, size - used,
+                         "%-12s r/s %.1f w/s %.1f rkB/s %.1f wkB/s %.1f await %.2fms util %.1f%%\n",
+                         r->name, r->read_iops, r->write_iops,
+                         r->read_bytes_per_sec / 1024.0, r->write_bytes_per_sec / 1024.0,
+                         r->await_ms, r->util_pct);
+        if (n < 0) break;
+        len += n;
+        used = (size_t)len < size ? (size_t)len : size;
+    }
+    return len;
+}
+
+void disk_stats_free(disk_stats_t* ds) {
+    free(ds->table);
+    free(ds->parsed);
+    free(ds->rates);
+    if (ds->file.buf) proc_file_close(&ds->file);
+    memset(ds, 0, sizeof(*ds));
+    ds->file.fd = -1;
+}
@@ -0,0 +1,68 @@
+#ifndef DISK_STATS_H
+#define DISK_STATS_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "proc_parse.h"
+#include "proc_reader.h"
+
+#define DISK_FILTER_MAX 8
+#define DISK_SECTOR_BYTES 512
+
+// Per-device rates between the last two samples
+typedef struct {
+    uint32_t major;
+    uint32_t minor;
+    char name[PROC_NAME_LEN];
+    double read_iops;
+    double write_iops;
+    double read_bytes_per_sec;
+    double write_bytes_per_sec;
+    double util_pct;            // time the device had I/O in flight
+    double await_ms;            // mean time per completed request
+} disk_rate_t;
+
+// Known device, keyed by major:minor. The filter verdict is cached here so
+// names are only matched when a device first appears.
+typedef struct {
+    uint32_t dev;               // major << 20 | minor; 0 marks an empty slot
+    uint8_t keep;
+    uint8_t seen;
+    char name[PROC_NAME_LEN];
+    uint64_t reads;
+    uint64_t writes;
+    uint64_t sectors_read;
+    uint64_t sectors_written;
+    uint64_t read_ms;
+    uint64_t write_ms;
+    uint64_t io_ms;
+} disk_entry_t;
+
+typedef struct {
+    disk_entry_t* table;        // open addressing, power-of-two size
+    size_t table_size;
+    size_t used;
+    proc_disk_t* parsed;        // scratch for the parser
+    int parsed_cap;
+    disk_rate_t* rates;
+    int rate_count;
+    uint64_t last_ns;
+    char include[DISK_FILTER_MAX][PROC_NAME_LEN];   // fnmatch patterns
+    int include_count;
+    char exclude[DISK_FILTER_MAX][PROC_NAME_LEN];
+    int exclude_count;
+    proc_file_t file;
+} disk_stats_t;
+
+// Patterns are comma-separated fnmatch globs ("sd*,nvme*"); NULL or "" for none.
+// With no include patterns every device not excluded is kept.
+int disk_stats_init(disk_stats_t* ds, const char* include, const char* exclude);
+// Fold one /proc/diskstats buffer taken at now_ns; returns the number of
+// devices with rates (0 on the first sample) or -1 on error
+int disk_stats_update(disk_stats_t* ds, const char* buf, size_t len, uint64_t now_ns);
+// Read /proc/diskstats and update
+int disk_stats_sample(disk_stats_t* ds);
+int format_disk_rates(const disk_stats_t* ds, char* buf, size_t size);
+void disk_stats_free(disk_stats_t* ds);
+
+#endif
@@ -1,7 +1,9 @@
 #include <stdio.h>
 #include <string.h>
 #include <stdlib.h>
+#include <unistd.h>
 #include "room_manager.h"
+#include "plugin_registry.h"
 
 int main(int argc, char* argv[]) {
     if (argc < 2) {
@@ -10,9 +12,17 @@ int main(int argc, char* argv[]) {
     }
     const char* cmd = argv[1];
 
-    if (strcmp(cmd, "create") == 0) {
+    // Site-specific room types; a missing directory just means none
+    const char* plugin_dir = getenv("LOC_GEN_PLUGIN_DIR");
+    plugin_load_dir(plugin_dir ? plugin_dir : PLUGIN_DEFAULT_DIR);
+
+    if (strcmp(cmd, "create") == 0 && argc == 5) {
+        create_targeted_room(argv[2], argv[3], atoi(argv[4]));
+    } else if (strcmp(cmd, "types") == 0) {
+        list_room_types();
+    } else if (strcmp(cmd, "create") == 0) {
         if (argc != 4) {
-            printf("Usage: ./loc_gen create <room_type> <interval_ms>\n");
+            printf("Usage: ./loc_gen create <room_type> [target] <interval_ms>, e.g. create pid-room <pid|name> <interval_ms> | create cgroup-room <path> <interval_ms>\n");
             return 1;
         }
         const char* room_type = argv[2];
@@ -39,9 +49,25 @@ int main(int argc, char* argv[]) {
         }
         int id = atoi(argv[2]);
         stop_monitoring(id);
+    } else if (strcmp(cmd, "show") == 0 && argc == 4) {
+        // show top-cpu|top-mem <N>: two scans a second apart, then the ranking
+        int id = create_room("process-room", 1000);
+        if (id < 0) return 1;
+        show_room_data(id);
+        sleep(1);
+        if (refresh_room(id) != 0) return 1;
+        if (show_room_top(id, argv[2], atoi(argv[3])) < 0) return 1;
+    } else if (strcmp(cmd, "pressure") == 0 && argc == 3) {
+        // pressure <timeout_ms>: sleep until the kernel reports a stall, then show it
+        int id = create_room("psi-room", 0);
+        if (id < 0) return 1;
+        int fired = wait_room_pressure(id, atoi(argv[2]));
+        if (fired < 0) return 1;
+        if (fired == 0) printf("No stall within %s ms\n", argv[2]);
+        show_room_data(id);
     } else if (strcmp(cmd, "show") == 0) {
         if (argc != 3) {
-            printf("Usage: ./loc_gen show <room_id>\n");
+            printf("Usage: ./loc_gen show <room_id> | show {top-cpu|top-mem} <N>\n");
             return 1;
         }
         int id = atoi(argv[2]);
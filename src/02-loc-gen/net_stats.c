@@ -0,0 +1,315 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <errno.h>
+#include <time.h>
+#include <sys/socket.h>
+#include <linux/netlink.h>
+#include <linux/rtnetlink.h>
+#include <linux/if_link.h>
+#include "net_stats.h"
+
+#define NET_TABLE_MIN 32
+#define NET_IFACE_MIN 32
+#define NET_NL_BUF_SIZE 32768
+
+static uint32_t name_hash(const char* name) {
+    uint32_t h = 2166136261u;
+    for (; *name; name++) {
+        h ^= (unsigned char)*name;
+        h *= 16777619u;
+    }
+    return h ? h : 1;
+}
+
+static net_entry_t* lookup(net_entry_t* table, size_t size, uint32_t hash, const char* name) {
+    size_t mask = size - 1;
+    size_t i = hash & mask;
+    while (table[i].hash != 0 && (table[i].hash != hash || strcmp(table[i].name, name) != 0)) {
+        i = (i + 1) & mask;
+    }
+    return &table[i];
+}
+
+// Rebuild into a table sized for `live` entries, dropping those not seen
+static int rebuild(net_stats_t* ns, size_t live) {
+    size_t size = NET_TABLE_MIN;
+    while (size < live * 2) size *= 2;
+    net_entry_t* table = calloc(size, sizeof(net_entry_t));
+    if (!table) return -1;
+    size_t used = 0;
+    for (size_t i = 0; i < ns->table_size; i++) {
+        net_entry_t* e = &ns->table[i];
+        if (e->hash != 0 && e->seen) {
+            *lookup(table, size, e->hash, e->name) = *e;
+            used++;
+        }
+    }
+    free(ns->table);
+    ns->table = table;
+    ns->table_size = size;
+    ns->used = used;
+    return 0;
+}
+
+static int reserve_ifaces(net_stats_t* ns, int needed) {
+    if (needed <= ns->iface_cap) return 0;
+    int cap = ns->iface_cap ? ns->iface_cap : NET_IFACE_MIN;
+    while (cap < needed) cap *= 2;
+    proc_netdev_t* ifaces = realloc(ns->ifaces, sizeof(proc_netdev_t) * (size_t)cap);
+    if (!ifaces) return -1;
+    ns->ifaces = ifaces;
+    net_rate_t* rates = realloc(ns->rates, sizeof(net_rate_t) * (size_t)cap);
+    if (!rates) return -1;
+    ns->rates = rates;
+    ns->iface_cap = cap;
+    return 0;
+}
+
+static int open_netlink(net_stats_t* ns) {
+    int fd = socket(AF_NETLINK, SOCK_RAW | SOCK_CLOEXEC, NETLINK_ROUTE);
+    if (fd < 0) return -1;
+    struct sockaddr_nl addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.nl_family = AF_NETLINK;
+    if (bind(fd, (struct sockaddr*)&addr, sizeof(addr)) != 0) {
+        close(fd);
+        return -1;
+    }
+    ns->nl_buf = malloc(NET_NL_BUF_SIZE);
+    if (!ns->nl_buf) {
+        close(fd);
+        return -1;
+    }
+    ns->nl_fd = fd;
+    return 0;
+}
+
+int net_stats_init(net_stats_t* ns) {
+    memset(ns, 0, sizeof(*ns));
+    ns->file.fd = -1;
+    ns->nl_fd = -1;
+    ns->table = calloc(NET_TABLE_MIN, sizeof(net_entry_t));
+    if (!ns->table) return -1;
+    ns->table_size = NET_TABLE_MIN;
+    ns->source = open_netlink(ns) == 0 ? NET_SOURCE_NETLINK : NET_SOURCE_PROCFS;
+    return 0;
+}
+
+static void from_link_stats(proc_netdev_t* dev, const struct rtnl_link_stats64* s) {
+    dev->rx_bytes = s->rx_bytes;
+    dev->rx_packets = s->rx_packets;
+    dev->rx_errs = s->rx_errors;
+    dev->rx_drop = s->rx_dropped;
+    dev->rx_fifo = s->rx_fifo_errors;
+    dev->rx_frame = s->rx_frame_errors;
+    dev->rx_compressed = s->rx_compressed;
+    dev->rx_multicast = s->multicast;
+    dev->tx_bytes = s->tx_bytes;
+    dev->tx_packets = s->tx_packets;
+    dev->tx_errs = s->tx_errors;
+    dev->tx_drop = s->tx_dropped;
+    dev->tx_fifo = s->tx_fifo_errors;
+    dev->tx_colls = s->collisions;
+    dev->tx_carrier = s->tx_carrier_errors;
+    dev->tx_compressed = s->tx_compressed;
+}
+
+// Returns 1 on RTM_NEWLINK with stats, 0 to skip, -1 on malformed messages
+static int parse_link(const struct nlmsghdr* nh, proc_netdev_t* dev) {
+    if (nh->nlmsg_len < NLMSG_LENGTH(sizeof(struct ifinfomsg))) return -1;
+    struct ifinfomsg* ifi = NLMSG_DATA(nh);
+    int len = (int)IFLA_PAYLOAD(nh);
+    int have_name = 0, have_stats = 0;
+    memset(dev, 0, sizeof(*dev));
+
+    for (struct rtattr* rta = IFLA_RTA(ifi); RTA_OK(rta, len); rta = RTA_NEXT(rta, len)) {
+        size_t payload = RTA_PAYLOAD(rta);
+        if (rta->rta_type == IFLA_IFNAME) {
+            size_t n = strnlen(RTA_DATA(rta), payload);
+            if (n >= sizeof(dev->name)) n = sizeof(dev->name) - 1;
+            memcpy(dev->name, RTA_DATA(rta), n);
+            dev->name[n] = '\0';
+            have_name = 1;
+        } else if (rta->rta_type == IFLA_STATS64) {
+            struct rtnl_link_stats64 s;
+            memset(&s, 0, sizeof(s));
+            memcpy(&s, RTA_DATA(rta), payload < sizeof(s) ? payload : sizeof(s));
+            from_link_stats(dev, &s);
+            have_stats = 1;
+        }
+    }
+    return have_name && have_stats;
+}
+
+static int collect_netlink(net_stats_t* ns) {
+    struct {
+        struct nlmsghdr nh;
+        struct ifinfomsg ifi;
+    } req;
+    memset(&req, 0, sizeof(req));
+    req.nh.nlmsg_len = NLMSG_LENGTH(sizeof(req.ifi));
+    req.nh.nlmsg_type = RTM_GETLINK;
+    req.nh.nlmsg_flags = NLM_F_REQUEST | NLM_F_DUMP;
+    req.nh.nlmsg_seq = ++ns->nl_seq;
+    req.ifi.ifi_family = AF_UNSPEC;
+    if (send(ns->nl_fd, &req, req.nh.nlmsg_len, 0) < 0) return -1;
+
+    int count = 0;
+    for (;;) {
+        ssize_t n = recv(ns->nl_fd, ns->nl_buf, NET_NL_BUF_SIZE, 0);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            return -1;
+        }
+        int len = (int)n;
+        for (struct nlmsghdr* nh = (struct nlmsghdr*)ns->nl_buf; NLMSG_OK(nh, len);
+             nh = NLMSG_NEXT(nh, len)) {
+            // Replies to an earlier, abandoned dump
+            if (nh->nlmsg_seq != ns->nl_seq) continue;
+            if (nh->nlmsg_type == NLMSG_DONE) return count;
+            if (nh->nlmsg_type == NLMSG_ERROR) return -1;
+            if (nh->nlmsg_type != RTM_NEWLINK) continue;
+            if (reserve_ifaces(ns, count + 1) != 0) return -1;
+            int rc = parse_link(nh, &ns->ifaces[count]);
+            if (rc < 0) return -1;
+            count += rc;
+        }
+    }
+}
+
+static int collect_procfs(net_stats_t* ns) {
+    if (!ns->file.buf && proc_file_open_paged(&ns->file, "/proc/net/dev") != 0) return -1;
+    if (proc_file_read(&ns->file) < 0) return -1;
+    if (reserve_ifaces(ns, NET_IFACE_MIN) != 0) return -1;
+    for (;;) {
+        int count = proc_parse_netdev(ns->file.buf, ns->file.len, ns->ifaces, ns->iface_cap);
+        if (count < ns->iface_cap) return count;
+        if (reserve_ifaces(ns, ns->iface_cap * 2) != 0) return -1;
+    }
+}
+
+int net_stats_collect(net_stats_t* ns, int source) {
+    int count;
+    if (source == NET_SOURCE_NETLINK) {
+        if (ns->nl_fd < 0) return -1;
+        count = collect_netlink(ns);
+    } else {
+        count = collect_procfs(ns);
+    }
+    ns->iface_count = count < 0 ? 0 : count;
+    return count;
+}
+
+static double per_sec(uint64_t now, uint64_t before, double seconds) {
+    return now >= before ? (double)(now - before) / seconds : 0;
+}
+
+int net_stats_update(net_stats_t* ns, const proc_netdev_t* ifaces, int count, uint64_t now_ns) {
+    if (count < 0) return -1;
+    if (reserve_ifaces(ns, count) != 0) return -1;
+    if ((ns->used + (size_t)count) * 2 > ns->table_size) {
+        for (size_t i = 0; i < ns->table_size; i++) ns->table[i].seen = 1;
+        if (rebuild(ns, ns->used + (size_t)count) != 0) return -1;
+    }
+    for (size_t i = 0; i < ns->table_size; i++) ns->table[i].seen = 0;
+
+    double seconds = ns->last_ns && now_ns > ns->last_ns ? (now_ns - ns->last_ns) / 1e9 : 0;
+    int rates = 0;
+    size_t seen = 0;
+    ns->added = 0;
+
+    for (int i = 0; i < count; i++) {
+        const proc_netdev_t* d = &ifaces[i];
+        uint32_t hash = name_hash(d->name);
+        net_entry_t* e = lookup(ns->table, ns->table_size, hash, d->name);
+        int fresh = e->hash == 0;
+        if (fresh) {
+            e->hash = hash;
+            memcpy(e->name, d->name, sizeof(e->name));
+            ns->used++;
+            if (ns->last_ns) ns->added++;
+        } else if (e->seen) {
+            continue;           // duplicate name in one sample
+        }
+        e->seen = 1;
+        seen++;
+
+        // A recreated interface restarts its counters; wait for the next sample
+        int reset = d->rx_bytes < e->rx_bytes || d->tx_bytes < e->tx_bytes;
+        if (!fresh && !reset && seconds > 0) {
+            net_rate_t* r = &ns->rates[rates++];
+            memcpy(r->name, e->name, sizeof(r->name));
+            r->rx_bytes_per_sec = per_sec(d->rx_bytes, e->rx_bytes, seconds);
+            r->tx_bytes_per_sec = per_sec(d->tx_bytes, e->tx_bytes, seconds);
+            r->rx_packets_per_sec = per_sec(d->rx_packets, e->rx_packets, seconds);
+            r->tx_packets_per_sec = per_sec(d->tx_packets, e->tx_packets, seconds);
+            r->rx_errors_per_sec = per_sec(d->rx_errs, e->rx_errs, seconds);
+            r->tx_errors_per_sec = per_sec(d->tx_errs, e->tx_errs, seconds);
+            r->rx_drops_per_sec = per_sec(d->rx_drop, e->rx_drop, seconds);
+            r->tx_drops_per_sec = per_sec(d->tx_drop, e->tx_drop, seconds);
+        }
+        e->rx_bytes = d->rx_bytes;
+        e->tx_bytes = d->tx_bytes;
+        e->rx_packets = d->rx_packets;
+        e->tx_packets = d->tx_packets;
+        e->rx_errs = d->rx_errs;
+        e->tx_errs = d->tx_errs;
+        e->rx_drop = d->rx_drop;
+        e->tx_drop = d->tx_drop;
+    }
+
+    // Forget interfaces that went away
+    ns->removed = (int)(ns->used - seen);
+    if (ns->removed > 0 && rebuild(ns, seen) != 0) return -1;
+
+    ns->rate_count = rates;
+    ns->last_ns = now_ns;
+    return rates;
+}
+
+int net_stats_sample(net_stats_t* ns) {
+    int count = net_stats_collect(ns, ns->source);
+    if (count < 0 && ns->source == NET_SOURCE_NETLINK) {
+        fprintf(stderr, "rtnetlink link dump failed, using /proc/net/dev\n");
+        ns->source = NET_SOURCE_PROCFS;
+        count = net_stats_collect(ns, ns->source);
+    }
+    if (count < 0) return -1;
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    uint64_t now = (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+    return net_stats_update(ns, ns->ifaces, count, now);
+}
+
+int format_net_rates(const net_stats_t* ns, char* buf, size_t size) {
+    size_t used = 0;
+    int len = 0;
+    for (int i = 0; i < ns->rate_count; i++) {
+        const net_rate_t* r = &ns->rates[i];
+        int n = snprintf(buf ? buf + used : NULL, size - used,
+                         "%-16s rx %.1f kB/s %.1f pkt/s tx %.1f kB/s %.1f pkt/s "
+                         "err %.1f/%.1f drop %.1f/%.1f\n",
+                         r->name, r->rx_bytes_per_sec / 1024.0, r->rx_packets_per_sec,
+                         r->tx_bytes_per_sec / 1024.0, r->tx_packets_per_sec,
+                         r->rx_errors_per_sec, r->tx_errors_per_sec,
+                         r->rx_drops_per_sec, r->tx_drops_per_sec);
+        if (n < 0) break;
+        len += n;
+        used = (size_t)len < size ? (size_t)len : size;
+    }
+    return len;
+}
+
+void net_stats_free(net_stats_t* ns) {
+    free(ns->table);
+    free(ns->ifaces);
+    free(ns->rates);
+    free(ns->nl_buf);
+    if (ns->nl_fd >= 0) close(ns->nl_fd);
+    if (ns->file.buf) proc_file_close(&ns->file);
+    memset(ns, 0, sizeof(*ns));
+    ns->file.fd = -1;
+    ns->nl_fd = -1;
+}
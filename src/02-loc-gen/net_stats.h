@@ -0,0 +1,71 @@
+#ifndef NET_STATS_H
+#define NET_STATS_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "proc_parse.h"
+#include "proc_reader.h"
+
+#define NET_SOURCE_NETLINK 0
+#define NET_SOURCE_PROCFS  1
+
+// Per-interface rates between the last two samples
+typedef struct {
+    char name[PROC_NAME_LEN];
+    double rx_bytes_per_sec;
+    double tx_bytes_per_sec;
+    double rx_packets_per_sec;
+    double tx_packets_per_sec;
+    double rx_errors_per_sec;
+    double tx_errors_per_sec;
+    double rx_drops_per_sec;
+    double tx_drops_per_sec;
+} net_rate_t;
+
+// Known interface, keyed by name
+typedef struct {
+    uint32_t hash;              // 0 marks an empty slot
+    uint8_t seen;
+    char name[PROC_NAME_LEN];
+    uint64_t rx_bytes;
+    uint64_t tx_bytes;
+    uint64_t rx_packets;
+    uint64_t tx_packets;
+    uint64_t rx_errs;
+    uint64_t tx_errs;
+    uint64_t rx_drop;
+    uint64_t tx_drop;
+} net_entry_t;
+
+typedef struct {
+    net_entry_t* table;         // open addressing, power-of-two size
+    size_t table_size;
+    size_t used;
+    proc_netdev_t* ifaces;      // counters from the last collect
+    int iface_count;
+    int iface_cap;
+    net_rate_t* rates;
+    int rate_count;
+    int added;                  // interfaces that appeared / went away
+    int removed;                // in the last update
+    uint64_t last_ns;
+    int source;                 // NET_SOURCE_*
+    int nl_fd;
+    uint32_t nl_seq;
+    char* nl_buf;
+    proc_file_t file;
+} net_stats_t;
+
+// Uses an rtnetlink socket when one can be opened, /proc/net/dev otherwise
+int net_stats_init(net_stats_t* ns);
+// Fill ns->ifaces from the given source; returns the interface count or -1
+int net_stats_collect(net_stats_t* ns, int source);
+// Fold a set of interface counters taken at now_ns; returns the number of
+// interfaces with rates (0 on the first sample) or -1 on error
+int net_stats_update(net_stats_t* ns, const proc_netdev_t* ifaces, int count, uint64_t now_ns);
+// Collect from the preferred source and update, falling back to procfs
+int net_stats_sample(net_stats_t* ns);
+int format_net_rates(const net_stats_t* ns, char* buf, size_t size);
+void net_stats_free(net_stats_t* ns);
+
+#endif
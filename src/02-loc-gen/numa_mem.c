@@ -0,0 +1,144 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <dirent.h>
+#include <errno.h>
+#include <time.h>
+#include "numa_mem.h"
+
+static int compare_ids(const void* a, const void* b) {
+    return *(const int*)a - *(const int*)b;
+}
+
+// "node12" -> 12, anything else -> -1
+static int node_id(const char* name) {
+    if (strncmp(name, "node", 4) != 0 || name[4] == '\0') return -1;
+    int id = 0;
+    for (const char* p = name + 4; *p; p++) {
+        if (*p < '0' || *p > '9' || id > 100000) return -1;
+        id = id * 10 + (*p - '0');
+    }
+    return id;
+}
+
+int numa_mem_init(numa_mem_t* nm, const char* root) {
+    memset(nm, 0, sizeof(*nm));
+    DIR* dir = opendir(root);
+    if (!dir) return -1;
+    int ids[NUMA_MAX_NODES];
+    int count = 0;
+    struct dirent* de;
+    while ((de = readdir(dir)) != NULL && count < NUMA_MAX_NODES) {
+        int id = node_id(de->d_name);
+        if (id >= 0) ids[count++] = id;
+    }
+    closedir(dir);
+    if (count == 0) {
+        errno = ENOENT;
+        return -1;
+    }
+    qsort(ids, (size_t)count, sizeof(int), compare_ids);
+
+    nm->nodes = calloc((size_t)count, sizeof(numa_node_t));
+    if (!nm->nodes) return -1;
+    for (int i = 0; i < count; i++) {
+        numa_node_t* node = &nm->nodes[i];
+        char path[256];
+        node->id = ids[i];
+        snprintf(path, sizeof(path), "%s/node%d/meminfo", root, ids[i]);
+        if (proc_file_open(&node->meminfo, path) != 0) {
+            numa_mem_free(nm);
+            return -1;
+        }
+        snprintf(path, sizeof(path), "%s/node%d/numastat", root, ids[i]);
+        if (proc_file_open(&node->numastat, path) != 0) {
+            proc_file_close(&node->meminfo);
+            numa_mem_free(nm);
+            return -1;
+        }
+        nm->count++;
+    }
+    return nm->count;
+}
+
+static double rate(uint64_t cur, uint64_t prev, double seconds) {
+    return cur >= prev ? (cur - prev) / seconds : 0;
+}
+
+int numa_mem_sample_at(numa_mem_t* nm, uint64_t now_ns) {
+    double seconds = nm->last_ns && now_ns > nm->last_ns ? (now_ns - nm->last_ns) / 1e9 : 0;
+    int read_count = 0;
+    for (int i = 0; i < nm->count; i++) {
+        numa_node_t* node = &nm->nodes[i];
+        proc_numastat_t prev = node->stat;
+        if (proc_file_read(&node->meminfo) < 0 ||
+            proc_parse_node_meminfo(node->meminfo.buf, node->meminfo.len, &node->meminfo_offs, &node->mem) != 0 ||
+            proc_file_read(&node->numastat) < 0 ||
+            proc_parse_numastat(node->numastat.buf, node->numastat.len, &node->numastat_offs, &node->stat) != 0) {
+            continue;
+        }
+        // Older kernels leave out MemUsed
+        if (!node->mem.mem_used && node->mem.mem_total >= node->mem.mem_free) {
+            node->mem.mem_used = node->mem.mem_total - node->mem.mem_free;
+        }
+        node->used_pct = node->mem.mem_total ? (float)(node->mem.mem_used * 100.0 / node->mem.mem_total) : 0;
+        if (nm->has_sample && seconds > 0) {
+            node->hit_per_sec = rate(node->stat.numa_hit, prev.numa_hit, seconds);
+            node->miss_per_sec = rate(node->stat.numa_miss, prev.numa_miss, seconds);
+            node->foreign_per_sec = rate(node->stat.numa_foreign, prev.numa_foreign, seconds);
+            node->other_per_sec = rate(node->stat.other_node, prev.other_node, seconds);
+            double allocs = node->hit_per_sec + node->miss_per_sec;
+            node->miss_pct = allocs > 0 ? (float)(node->miss_per_sec * 100.0 / allocs) : 0;
+        }
+        read_count++;
+    }
+    if (read_count == 0) return -1;
+    nm->has_sample = 1;
+    nm->last_ns = now_ns;
+    return read_count;
+}
+
+int numa_mem_sample(numa_mem_t* nm) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return numa_mem_sample_at(nm, (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec);
+}
+
+int numa_mem_tightest(const numa_mem_t* nm) {
+    int best = -1;
+    for (int i = 0; i < nm->count; i++) {
+        if (nm->nodes[i].mem.mem_total && (best < 0 || nm->nodes[i].used_pct > nm->nodes[best].used_pct)) {
+            best = i;
+        }
+    }
+    return best;
+}
+
+int format_numa_mem(const numa_mem_t* nm, char* buf, size_t size) {
+    int len = proc_append(buf, size, 0, "%-6s %10s %10s %6s %10s %10s %10s %10s %6s\n",
+                          "NODE", "FREE(kB)", "USED(kB)", "USED%",
+                          "HIT/s", "MISS/s", "FOREIGN/s", "OTHER/s", "MISS%");
+    for (int i = 0; i < nm->count; i++) {
+        const numa_node_t* node = &nm->nodes[i];
+        len = proc_append(buf, size, len,
+                          "node%-2d %10llu %10llu %5.1f%% %10.0f %10.0f %10.0f %10.0f %5.1f%%\n", node->id,
+                          (unsigned long long)node->mem.mem_free, (unsigned long long)node->mem.mem_used,
+                          node->used_pct, node->hit_per_sec, node->miss_per_sec, node->foreign_per_sec,
+                          node->other_per_sec, node->miss_pct);
+    }
+    int tight = numa_mem_tightest(nm);
+    if (nm->count > 1 && tight >= 0) {
+        len = proc_append(buf, size, len, "Tightest: node%d at %.1f%% used\n",
+                          nm->nodes[tight].id, nm->nodes[tight].used_pct);
+    }
+    return len;
+}
+
+void numa_mem_free(numa_mem_t* nm) {
+    for (int i = 0; i < nm->count; i++) {
+        proc_file_close(&nm->nodes[i].meminfo);
+        proc_file_close(&nm->nodes[i].numastat);
+    }
+    free(nm->nodes);
+    memset(nm, 0, sizeof(*nm));
+}
@@ -0,0 +1,45 @@
+#ifndef NUMA_MEM_H
+#define NUMA_MEM_H
+
+#include <stdint.h>
+#include "proc_parse.h"
+#include "proc_reader.h"
+
+#define NUMA_SYSFS_ROOT "/sys/devices/system/node"
+#define NUMA_MAX_NODES 64
+
+// One memory node with its meminfo and numastat held open
+typedef struct {
+    int id;
+    proc_file_t meminfo;
+    proc_file_t numastat;
+    proc_offsets_t meminfo_offs;
+    proc_offsets_t numastat_offs;
+    proc_node_meminfo_t mem;
+    proc_numastat_t stat;
+    float used_pct;
+    // Pages per second from the last two samples
+    double hit_per_sec;
+    double miss_per_sec;        // allocated here although another node was preferred
+    double foreign_per_sec;     // meant for here but placed on another node
+    double other_per_sec;       // allocated here by a task running on another node
+    float miss_pct;             // miss / (hit + miss)
+} numa_node_t;
+
+typedef struct {
+    numa_node_t* nodes;         // ascending node id
+    int count;
+    int has_sample;
+    uint64_t last_ns;
+} numa_mem_t;
+
+// Open every nodeN under root; returns the node count or -1
+int numa_mem_init(numa_mem_t* nm, const char* root);
+int numa_mem_sample(numa_mem_t* nm);
+int numa_mem_sample_at(numa_mem_t* nm, uint64_t now_ns);
+// Node with the least free memory relative to its size, or -1
+int numa_mem_tightest(const numa_mem_t* nm);
+int format_numa_mem(const numa_mem_t* nm, char* buf, size_t size);
+void numa_mem_free(numa_mem_t* nm);
+
+#endif
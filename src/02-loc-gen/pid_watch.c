@@ -0,0 +1,225 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <errno.h>
+#include <time.h>
+#include <sys/syscall.h>
+#include "pid_watch.h"
+
+#define PID_WATCH_DENTS_SIZE 4096
+
+struct linux_dirent64 {
+    uint64_t d_ino;
+    int64_t d_off;
+    unsigned short d_reclen;
+    unsigned char d_type;
+    char d_name[];
+};
+
+static void close_fd(int* fd) {
+    if (*fd >= 0) close(*fd);
+    *fd = -1;
+}
+
+static void detach(pid_watch_t* pw) {
+    close_fd(&pw->stat_fd);
+    close_fd(&pw->status_fd);
+    close_fd(&pw->io_fd);
+    close_fd(&pw->fd_dirfd);
+    close_fd(&pw->dirfd);
+    pw->pid = 0;
+    pw->last_ns = 0;
+}
+
+static int read_fd(pid_watch_t* pw, int fd) {
+    ssize_t n = pread(fd, pw->buf, PID_WATCH_BUF_SIZE - 1, 0);
+    pw->syscalls++;
+    if (n <= 0) return -1;
+    pw->buf[n] = '\0';
+    return (int)n;
+}
+
+// Open the files once; status and stat are required, io and fd may be denied
+static int attach(pid_watch_t* pw, int32_t pid) {
+    char path[32];
+    snprintf(path, sizeof(path), "/proc/%d", pid);
+    pw->dirfd = open(path, O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (pw->dirfd < 0) return -1;
+    pw->stat_fd = openat(pw->dirfd, "stat", O_RDONLY | O_CLOEXEC);
+    pw->status_fd = openat(pw->dirfd, "status", O_RDONLY | O_CLOEXEC);
+    pw->io_fd = openat(pw->dirfd, "io", O_RDONLY | O_CLOEXEC);
+    pw->fd_dirfd = openat(pw->dirfd, "fd", O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (pw->stat_fd < 0 || pw->status_fd < 0) {
+        detach(pw);
+        return -1;
+    }
+    pw->pid = pid;
+    pw->start_time = 0;
+    return 0;
+}
+
+// Lowest PID whose comm matches the target name
+static int32_t find_by_name(pid_watch_t* pw) {
+    int dirfd = open("/proc", O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (dirfd < 0) return 0;
+    int32_t found = 0;
+    char* dents = malloc(PID_WATCH_DENTS_SIZE);
+    long n;
+    while (dents && (n = syscall(SYS_getdents64, dirfd, dents, PID_WATCH_DENTS_SIZE)) > 0) {
+        for (long off = 0; off < n;) {
+            struct linux_dirent64* d = (struct linux_dirent64*)(dents + off);
+            off += d->d_reclen;
+            if (d->d_name[0] < '1' || d->d_name[0] > '9') continue;
+            char path[32];
+            snprintf(path, sizeof(path), "%s/comm", d->d_name);
+            int fd = openat(dirfd, path, O_RDONLY | O_CLOEXEC);
+            if (fd < 0) continue;
+            ssize_t len = read(fd, pw->buf, PID_WATCH_BUF_SIZE - 1);
+            close(fd);
+            if (len <= 0) continue;
+            if (pw->buf[len - 1] == '\n') len--;
+            pw->buf[len] = '\0';
+            int32_t pid = (int32_t)atoi(d->d_name);
+            if (strcmp(pw->buf, pw->target) == 0 && (found == 0 || pid < found)) found = pid;
+        }
+    }
+    free(dents);
+    close(dirfd);
+    return found;
+}
+
+int pid_watch_init(pid_watch_t* pw, const char* target) {
+    memset(pw, 0, sizeof(*pw));
+    pw->dirfd = pw->stat_fd = pw->status_fd = pw->io_fd = pw->fd_dirfd = -1;
+    pw->fd_count = -1;
+    if (!target || !*target || strlen(target) >= sizeof(pw->target)) return -1;
+    snprintf(pw->target, sizeof(pw->target), "%s", target);
+    pw->by_name = strspn(target, "0123456789") != strlen(target);
+    pw->buf = malloc(PID_WATCH_BUF_SIZE);
+    if (!pw->buf) return -1;
+    if (!pw->by_name && attach(pw, (int32_t)atoi(target)) != 0) {
+        fprintf(stderr, "No process %s\n", target);
+        pid_watch_free(pw);
+        return -1;
+    }
+    return 0;
+}
+
+static int count_fds(pid_watch_t* pw) {
+    if (pw->fd_dirfd < 0) return -1;
+    if (lseek(pw->fd_dirfd, 0, SEEK_SET) < 0) return -1;
+    pw->syscalls++;
+    int count = 0;
+    for (;;) {
+        long n = syscall(SYS_getdents64, pw->fd_dirfd, pw->buf, PID_WATCH_BUF_SIZE);
+        pw->syscalls++;
+        if (n < 0) return -1;
+        if (n == 0) break;
+        for (long off = 0; off < n;) {
+            struct linux_dirent64* d = (struct linux_dirent64*)(pw->buf + off);
+            off += d->d_reclen;
+            if (d->d_name[0] != '.') count++;
+        }
+    }
+    return count;
+}
+
+static double per_sec(uint64_t now, uint64_t before, double seconds) {
+    return now >= before ? (double)(now - before) / seconds : 0;
+}
+
+int pid_watch_sample_at(pid_watch_t* pw, uint64_t now_ns) {
+    static long clock_ticks = 0;
+    if (!clock_ticks) clock_ticks = sysconf(_SC_CLK_TCK);
+    pw->syscalls = 0;
+
+    if (pw->pid == 0) {
+        if (!pw->by_name) return 0;
+        int32_t pid = find_by_name(pw);
+        if (pid == 0 || attach(pw, pid) != 0) return 0;
+    }
+
+    // A read on the descriptors of an exited process fails with ESRCH; a
+    // different start time means the PID now belongs to someone else
+    proc_pid_stat_t stat;
+    int n = read_fd(pw, pw->stat_fd);
+    if (n < 0 || proc_parse_pid_stat(pw->buf, (size_t)n, &stat) != 0 ||
+        (pw->start_time && stat.start_time != pw->start_time)) {
+        int was_running = pw->start_time != 0;
+        detach(pw);
+        if (!pw->by_name || !was_running) return 0;
+        // Look for the restarted process once
+        pw->restarts++;
+        return pid_watch_sample_at(pw, now_ns) > 0 ? 1 : 0;
+    }
+
+    n = read_fd(pw, pw->status_fd);
+    if (n < 0 || proc_parse_pid_status(pw->buf, (size_t)n, &pw->status) != 0) return -1;
+
+    proc_pid_io_t io;
+    int has_io = pw->io_fd >= 0 && (n = read_fd(pw, pw->io_fd)) >= 0 &&
+                 proc_parse_pid_io(pw->buf, (size_t)n, &io) == 0;
+
+    double seconds = pw->last_ns && now_ns > pw->last_ns ? (now_ns - pw->last_ns) / 1e9 : 0;
+    if (seconds > 0 && pw->start_time) {
+        uint64_t ticks = stat.utime + stat.stime;
+        uint64_t prev = pw->stat.utime + pw->stat.stime;
+        pw->cpu_pct = ticks >= prev ? (float)(100.0 * (double)(ticks - prev) / (seconds * clock_ticks)) : 0;
+        if (has_io && pw->has_io) {
+            pw->read_bytes_per_sec = per_sec(io.read_bytes, pw->io.read_bytes, seconds);
+            pw->write_bytes_per_sec = per_sec(io.write_bytes, pw->io.write_bytes, seconds);
+        }
+    }
+    pw->stat = stat;
+    pw->start_time = stat.start_time;
+    pw->has_io = has_io;
+    if (has_io) pw->io = io;
+    pw->fd_count = count_fds(pw);
+    pw->last_ns = now_ns;
+    return 1;
+}
+
+int pid_watch_sample(pid_watch_t* pw) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return pid_watch_sample_at(pw, (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec);
+}
+
+int format_pid_watch(const pid_watch_t* pw, char* buf, size_t size) {
+    if (pw->pid == 0) {
+        return snprintf(buf, size, "%s: not running (restarts %d)\n", pw->target, pw->restarts);
+    }
+    int len = snprintf(buf, size,
+                       "pid %d (%s) %c cpu %.1f%% rss %llu kB swap %llu kB threads %llu "
+                       "ctxt %llu/%llu\n",
+                       pw->pid, pw->stat.comm, pw->stat.state, pw->cpu_pct,
+                       (unsigned long long)pw->status.vm_rss_kb,
+                       (unsigned long long)pw->status.vm_swap_kb,
+                       (unsigned long long)pw->stat.threads,
+                       (unsigned long long)pw->status.voluntary_ctxt_switches,
+                       (unsigned long long)pw->status.nonvoluntary_ctxt_switches);
+    size_t used = len > 0 && (size_t)len < size ? (size_t)len : size;
+    int more;
+    if (pw->has_io) {
+        more = snprintf(buf + used, size - used, "io read %.1f kB/s write %.1f kB/s",
+                        pw->read_bytes_per_sec / 1024.0, pw->write_bytes_per_sec / 1024.0);
+    } else {
+        more = snprintf(buf + used, size - used, "io n/a");
+    }
+    len += more;
+    used = (size_t)len < size ? (size_t)len : size;
+    if (pw->fd_count >= 0) {
+        more = snprintf(buf + used, size - used, " fds %d restarts %d\n", pw->fd_count, pw->restarts);
+    } else {
+        more = snprintf(buf + used, size - used, " fds n/a restarts %d\n", pw->restarts);
+    }
+    return len + more;
+}
+
+void pid_watch_free(pid_watch_t* pw) {
+    detach(pw);
+    free(pw->buf);
+    pw->buf = NULL;
+}
@@ -0,0 +1,47 @@
+#ifndef PID_WATCH_H
+#define PID_WATCH_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "proc_parse.h"
+
+#define PID_WATCH_TARGET_LEN 32
+#define PID_WATCH_BUF_SIZE 4096
+
+// One watched process. The /proc/<pid> files stay open between samples and
+// are re-read with pread(); a name target follows the process across restarts.
+typedef struct {
+    char target[PID_WATCH_TARGET_LEN];  // PID or process name as given
+    int by_name;
+    int32_t pid;                        // 0 while no process matches
+    int dirfd;                          // /proc/<pid>
+    int stat_fd;
+    int status_fd;
+    int io_fd;                          // -1 if not permitted
+    int fd_dirfd;                       // /proc/<pid>/fd, -1 if not permitted
+    char* buf;
+    uint64_t start_time;
+    uint64_t last_ns;
+    proc_pid_stat_t stat;
+    proc_pid_status_t status;
+    proc_pid_io_t io;
+    int has_io;
+    // From the last two samples
+    float cpu_pct;
+    double read_bytes_per_sec;
+    double write_bytes_per_sec;
+    int fd_count;                       // -1 if not permitted
+    int restarts;                       // times a name target changed PID
+    unsigned long syscalls;             // issued by the last sample
+} pid_watch_t;
+
+// target is a PID or a process name (matched against comm)
+int pid_watch_init(pid_watch_t* pw, const char* target);
+// Returns 1 with fresh values, 0 if the process is gone (a name target
+// keeps looking for it), or -1 on error
+int pid_watch_sample(pid_watch_t* pw);
+int pid_watch_sample_at(pid_watch_t* pw, uint64_t now_ns);
+int format_pid_watch(const pid_watch_t* pw, char* buf, size_t size);
+void pid_watch_free(pid_watch_t* pw);
+
+#endif
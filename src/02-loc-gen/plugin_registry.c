@@ -0,0 +1,147 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <dirent.h>
+#include <dlfcn.h>
+#include "plugin_registry.h"
+#include "proc_parse.h"
+
+static const collector_ops_t* collectors[PLUGIN_MAX_COLLECTORS];
+static void* handles[PLUGIN_MAX_COLLECTORS];    // NULL for collectors built into the host
+static int collector_total = 0;
+
+static int valid_schema(const collector_ops_t* ops) {
+    if (!ops->name || !*ops->name || !ops->metrics || ops->metric_count <= 0 ||
+        ops->metric_count > COLLECTOR_MAX_METRICS || ops->interval_ms < 0 ||
+        !ops->init || !ops->sample) {
+        return 0;
+    }
+    for (int i = 0; i < ops->metric_count; i++) {
+        const metric_desc_t* m = &ops->metrics[i];
+        if (!m->name || (m->type != METRIC_U64 && m->type != METRIC_F64) ||
+            (m->kind != METRIC_GAUGE && m->kind != METRIC_COUNTER)) {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+int plugin_register(const collector_ops_t* ops) {
+    if (!ops || ops->abi_version != COLLECTOR_ABI_VERSION) {
+        fprintf(stderr, "Collector %s: ABI version %u, expected %d\n",
+                ops && ops->name ? ops->name : "?", ops ? ops->abi_version : 0, COLLECTOR_ABI_VERSION);
+        return -1;
+    }
+    if (!valid_schema(ops)) {
+        fprintf(stderr, "Collector %s: malformed metric schema or callbacks\n", ops->name ? ops->name : "?");
+        return -1;
+    }
+    if (plugin_find(ops->name)) {
+        fprintf(stderr, "Collector %s already registered\n", ops->name);
+        return -1;
+    }
+    if (collector_total >= PLUGIN_MAX_COLLECTORS) {
+        fprintf(stderr, "Collector table full, skipping %s\n", ops->name);
+        return -1;
+    }
+    collectors[collector_total] = ops;
+    handles[collector_total] = NULL;
+    return collector_total++;
+}
+
+static int has_suffix(const char* name, const char* suffix) {
+    size_t n = strlen(name), s = strlen(suffix);
+    return n > s && strcmp(name + n - s, suffix) == 0;
+}
+
+int plugin_load_dir(const char* dir) {
+    DIR* d = opendir(dir);
+    if (!d) return -1;
+    int loaded = 0;
+    struct dirent* de;
+    while ((de = readdir(d)) != NULL) {
+        if (!has_suffix(de->d_name, ".so")) continue;
+        char path[512];
+        if (snprintf(path, sizeof(path), "%s/%s", dir, de->d_name) >= (int)sizeof(path)) continue;
+
+        void* handle = dlopen(path, RTLD_NOW | RTLD_LOCAL);
+        if (!handle) {
+            fprintf(stderr, "Cannot load plugin %s: %s\n", path, dlerror());
+            continue;
+        }
+        collector_entry_t entry;
+        // POSIX blesses this cast for dlsym() results
+        *(void**)&entry = dlsym(handle, COLLECTOR_ENTRY_SYMBOL);
+        const collector_ops_t* ops = entry ? entry() : NULL;
+        int index = ops ? plugin_register(ops) : -1;
+        if (index < 0) {
+            if (!entry) fprintf(stderr, "Plugin %s has no %s()\n", path, COLLECTOR_ENTRY_SYMBOL);
+            dlclose(handle);
+            continue;
+        }
+        handles[index] = handle;
+        loaded++;
+    }
+    closedir(d);
+    return loaded;
+}
+
+const collector_ops_t* plugin_find(const char* name) {
+    for (int i = 0; i < collector_total; i++) {
+        if (strcmp(collectors[i]->name, name) == 0) return collectors[i];
+    }
+    return NULL;
+}
+
+int plugin_count(void) {
+    return collector_total;
+}
+
+const collector_ops_t* plugin_at(int index) {
+    return index >= 0 && index < collector_total ? collectors[index] : NULL;
+}
+
+void plugin_unload_all(void) {
+    for (int i = collector_total - 1; i >= 0; i--) {
+        if (handles[i]) dlclose(handles[i]);
+        collectors[i] = NULL;
+        handles[i] = NULL;
+    }
+    collector_total = 0;
+}
+
+int plugin_diff(const collector_ops_t* ops, void* state, const metric_value_t* prev,
+                const metric_value_t* cur, double seconds, metric_value_t* out) {
+    if (ops->diff) return ops->diff(state, prev, cur, seconds, out);
+    for (int i = 0; i < ops->metric_count; i++) {
+        const metric_desc_t* m = &ops->metrics[i];
+        if (m->kind == METRIC_GAUGE) {
+            out[i] = cur[i];
+        } else if (m->type == METRIC_U64) {
+            // A counter that went backwards was reset: no rate this time
+            out[i].f64 = seconds > 0 && cur[i].u64 >= prev[i].u64 ? (cur[i].u64 - prev[i].u64) / seconds : 0;
+        } else {
+            out[i].f64 = seconds > 0 && cur[i].f64 >= prev[i].f64 ? (cur[i].f64 - prev[i].f64) / seconds : 0;
+        }
+    }
+    return 0;
+}
+
+int plugin_format(const collector_ops_t* ops, void* state, const metric_value_t* values,
+                  char* buf, size_t size) {
+    if (ops->serialise) return ops->serialise(state, values, buf, size);
+    int len = 0;
+    for (int i = 0; i < ops->metric_count; i++) {
+        const metric_desc_t* m = &ops->metrics[i];
+        const char* unit = m->unit ? m->unit : "";
+        if (m->kind == METRIC_COUNTER) {
+            len = proc_append(buf, size, len, "%-24s %14.2f %s/s\n", m->name, values[i].f64, unit);
+        } else if (m->type == METRIC_U64) {
+            len = proc_append(buf, size, len, "%-24s %14llu %s\n",
+                              m->name, (unsigned long long)values[i].u64, unit);
+        } else {
+            len = proc_append(buf, size, len, "%-24s %14.2f %s\n", m->name, values[i].f64, unit);
+        }
+    }
+    return len;
+}
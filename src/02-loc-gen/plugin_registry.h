@@ -0,0 +1,31 @@
+#ifndef PLUGIN_REGISTRY_H
+#define PLUGIN_REGISTRY_H
+
+#include "collector.h"
+
+#define PLUGIN_MAX_COLLECTORS 32
+#define PLUGIN_DEFAULT_DIR "plugins"
+
+// Collectors are registered at startup, before any sampling thread runs;
+// lookups afterwards need no locking.
+
+// Check the ABI version and schema and add `ops`; returns its index, or -1
+// if it is malformed, the table is full or the name is taken
+int plugin_register(const collector_ops_t* ops);
+// dlopen() every *.so in `dir` and register its collector. Returns the
+// number registered, or -1 if the directory cannot be read.
+int plugin_load_dir(const char* dir);
+const collector_ops_t* plugin_find(const char* name);
+int plugin_count(void);
+const collector_ops_t* plugin_at(int index);
+// Forget every collector and dlclose() the loaded objects
+void plugin_unload_all(void);
+
+// Reported values from two samples through ops->diff or the default rules
+int plugin_diff(const collector_ops_t* ops, void* state, const metric_value_t* prev,
+                const metric_value_t* cur, double seconds, metric_value_t* out);
+// Text for reported values through ops->serialise or "name value unit" lines
+int plugin_format(const collector_ops_t* ops, void* state, const metric_value_t* values,
+                  char* buf, size_t size);
+
+#endif
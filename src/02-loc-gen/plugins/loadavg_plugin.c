@@ -0,0 +1,89 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include "../collector.h"
+
+// Example collector: load averages from /proc/loadavg and the fork rate
+// from /proc/stat. Build with -shared -fPIC and drop the .so into the
+// plugin directory; it only depends on collector.h.
+
+enum { LOAD1, LOAD5, LOAD15, RUNNABLE, THREADS, FORKS, METRIC_COUNT };
+
+static const metric_desc_t metrics[METRIC_COUNT] = {
+    { "load1", "", METRIC_F64, METRIC_GAUGE },
+    { "load5", "", METRIC_F64, METRIC_GAUGE },
+    { "load15", "", METRIC_F64, METRIC_GAUGE },
+    { "runnable", "tasks", METRIC_U64, METRIC_GAUGE },
+    { "threads", "tasks", METRIC_U64, METRIC_GAUGE },
+    { "forks", "tasks", METRIC_U64, METRIC_COUNTER },
+};
+
+typedef struct {
+    int loadavg_fd;
+    int stat_fd;
+    char buf[16384];
+} loadavg_state_t;
+
+static void* loadavg_init(const char* target) {
+    (void)target;
+    loadavg_state_t* s = malloc(sizeof(*s));
+    if (!s) return NULL;
+    s->loadavg_fd = open("/proc/loadavg", O_RDONLY | O_CLOEXEC);
+    s->stat_fd = open("/proc/stat", O_RDONLY | O_CLOEXEC);
+    if (s->loadavg_fd < 0 || s->stat_fd < 0) {
+        if (s->loadavg_fd >= 0) close(s->loadavg_fd);
+        if (s->stat_fd >= 0) close(s->stat_fd);
+        free(s);
+        return NULL;
+    }
+    return s;
+}
+
+static int read_fd(loadavg_state_t* s, int fd) {
+    ssize_t n = pread(fd, s->buf, sizeof(s->buf) - 1, 0);
+    if (n <= 0) return -1;
+    s->buf[n] = '\0';
+    return 0;
+}
+
+static int loadavg_sample(void* state, metric_value_t* values) {
+    loadavg_state_t* s = state;
+    unsigned long long running, total;
+    if (read_fd(s, s->loadavg_fd) != 0 ||
+        sscanf(s->buf, "%lf %lf %lf %llu/%llu", &values[LOAD1].f64, &values[LOAD5].f64,
+               &values[LOAD15].f64, &running, &total) != 5) {
+        return -1;
+    }
+    values[RUNNABLE].u64 = running;
+    values[THREADS].u64 = total;
+
+    if (read_fd(s, s->stat_fd) != 0) return -1;
+    const char* p = strstr(s->buf, "\nprocesses ");
+    if (!p) return -1;
+    values[FORKS].u64 = strtoull(p + 11, NULL, 10);
+    return 0;
+}
+
+static void loadavg_teardown(void* state) {
+    loadavg_state_t* s = state;
+    close(s->loadavg_fd);
+    close(s->stat_fd);
+    free(s);
+}
+
+static const collector_ops_t ops = {
+    .abi_version = COLLECTOR_ABI_VERSION,
+    .name = "loadavg-room",
+    .metrics = metrics,
+    .metric_count = METRIC_COUNT,
+    .interval_ms = 1000,
+    .init = loadavg_init,
+    .sample = loadavg_sample,
+    .teardown = loadavg_teardown,
+};
+
+const collector_ops_t* collector_plugin(void) {
+    return &ops;
+}
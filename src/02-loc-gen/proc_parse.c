@@ -0,0 +1,634 @@
+#include <stdio.h>
+#include <stdarg.h>
+#include <string.h>
+#include "proc_parse.h"
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+#define PROC_PARSE_SWAR 1
+#endif
+
+// Next '\n' at or after p, or end. Sixteen bytes per compare with SSE2.
+const char* proc_find_newline(const char* p, const char* end) {
+#ifdef __SSE2__
+    const __m128i newline = _mm_set1_epi8('\n');
+    while (end - p >= 16) {
+        __m128i chunk = _mm_loadu_si128((const __m128i*)p);
+        int mask = _mm_movemask_epi8(_mm_cmpeq_epi8(chunk, newline));
+        if (mask) return p + __builtin_ctz(mask);
+        p += 16;
+    }
+#endif
+    while (p < end && *p != '\n') p++;
+    return p;
+}
+
+static const char* skip_blanks(const char* p, const char* end) {
+    while (p < end && (*p == ' ' || *p == '\t')) p++;
+    return p;
+}
+
+static int is_digit(char c) {
+    return c >= '0' && c <= '9';
+}
+
+#ifdef PROC_PARSE_SWAR
+// Value of up to eight leading digits of `chunk`; *digits gets how many
+// bytes were digits. Lemire's 8-digit multiply trick on the left-padded word.
+static uint64_t swar_digits(uint64_t chunk, int* digits) {
+    uint64_t t = chunk ^ 0x3030303030303030ULL;     // '0'..'9' -> 0..9
+    uint64_t nondigit = ((t + 0x7676767676767676ULL) | t) & 0x8080808080808080ULL;
+    int n = nondigit ? __builtin_ctzll(nondigit) >> 3 : 8;
+    *digits = n;
+    if (n == 0) return 0;
+
+    uint64_t v = t;
+    if (n < 8) v <<= 8 * (8 - n);                     // leading zero digits
+    v = (v * 10) + (v >> 8);
+    v = (((v & 0x000000FF000000FFULL) * (100 + (1000000ULL << 32))) +
+         (((v >> 16) & 0x000000FF000000FFULL) * (1 + (10000ULL << 32)))) >> 32;
+    return v;
+}
+#endif
+
+// Skip blanks and parse an unsigned decimal. Fails without digits or on overflow.
+int proc_parse_u64(const char** pp, const char* end, uint64_t* out) {
+    static const uint64_t pow10[9] = {
+        1, 10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000
+    };
+    const char* p = skip_blanks(*pp, end);
+    const char* start = p;
+    uint64_t value = 0;
+
+#ifdef PROC_PARSE_SWAR
+    while (end - p >= 8) {
+        uint64_t chunk;
+        int n;
+        memcpy(&chunk, p, sizeof(chunk));
+        uint64_t part = swar_digits(chunk, &n);
+        if (n == 0) break;
+        if (__builtin_mul_overflow(value, pow10[n], &value) ||
+            __builtin_add_overflow(value, part, &value)) {
+            return -1;
+        }
+        p += n;
+        if (n < 8) goto done;
+    }
+#endif
+    while (p < end && is_digit(*p)) {
+        if (__builtin_mul_overflow(value, 10, &value) ||
+            __builtin_add_overflow(value, (uint64_t)(*p - '0'), &value)) {
+            return -1;
+        }
+        p++;
+    }
+#ifdef PROC_PARSE_SWAR
+done:
+#endif
+    if (p == start) return -1;
+    *out = value;
+    *pp = p;
+    return 0;
+}
+
+static int parse_u32(const char** pp, const char* end, uint32_t* out) {
+    uint64_t v;
+    if (proc_parse_u64(pp, end, &v) != 0 || v > UINT32_MAX) return -1;
+    *out = (uint32_t)v;
+    return 0;
+}
+
+// "123" or "123.45"
+static int parse_decimal(const char** pp, const char* end, double* out) {
+    uint64_t whole;
+    if (proc_parse_u64(pp, end, &whole) != 0) return -1;
+    double value = (double)whole;
+    const char* p = *pp;
+    if (p < end && *p == '.') {
+        p++;
+        double scale = 0.1;
+        while (p < end && is_digit(*p)) {
+            value += (*p - '0') * scale;
+            scale *= 0.1;
+            p++;
+        }
+    }
+    *out = value;
+    *pp = p;
+    return 0;
+}
+
+// Copy a token ending at a blank, ':' or newline into a fixed buffer
+static int parse_name(const char** pp, const char* end, char* name, size_t size) {
+    const char* p = skip_blanks(*pp, end);
+    const char* start = p;
+    while (p < end && *p != ' ' && *p != '\t' && *p != ':' && *p != '\n') p++;
+    size_t n = (size_t)(p - start);
+    if (n == 0 || n >= size) return -1;
+    memcpy(name, start, n);
+    name[n] = '\0';
+    *pp = p;
+    return 0;
+}
+
+static int starts_with(const char* p, const char* end, const char* word, size_t n) {
+    return (size_t)(end - p) >= n && memcmp(p, word, n) == 0;
+}
+
+// Parse up to `max` numbers into consecutive uint64_t fields; returns how many
+static int parse_counters(const char** pp, const char* end, uint64_t* fields, int max) {
+    int n = 0;
+    while (n < max && proc_parse_u64(pp, end, &fields[n]) == 0) n++;
+    return n;
+}
+
+int proc_parse_stat(const char* buf, size_t len, proc_stat_t* out) {
+    const char* p = buf;
+    const char* end = buf + len;
+    int have_total = 0;
+    // cpu[] is large; entries are cleared as they are filled
+    memset(&out->total, 0, sizeof(out->total));
+    out->cpu_count = 0;
+    out->ctxt = out->btime = out->processes = 0;
+    out->procs_running = out->procs_blocked = 0;
+
+    while (p < end) {
+        const char* eol = proc_find_newline(p, end);
+        if (starts_with(p, eol, "cpu", 3)) {
+            const char* q = p + 3;
+            proc_cpu_times_t* times = NULL;
+            if (q < eol && is_digit(*q)) {
+                uint32_t index;
+                if (parse_u32(&q, eol, &index) != 0) return -1;
+                if (out->cpu_count < PROC_MAX_CPUS) {
+                    out->cpu_index[out->cpu_count] = (int)index;
+                    times = &out->cpu[out->cpu_count++];
+                }
+            } else {
+                times = &out->total;
+                have_total = 1;
+            }
+            if (times) memset(times, 0, sizeof(*times));
+            if (times && parse_counters(&q, eol, (uint64_t*)times,
+                                        sizeof(*times) / sizeof(uint64_t)) < 4) {
+                return -1;
+            }
+        } else if (starts_with(p, eol, "ctxt ", 5)) {
+            const char* q = p + 5;
+            if (proc_parse_u64(&q, eol, &out->ctxt) != 0) return -1;
+        } else if (starts_with(p, eol, "btime ", 6)) {
+            const char* q = p + 6;
+            if (proc_parse_u64(&q, eol, &out->btime) != 0) return -1;
+        } else if (starts_with(p, eol, "processes ", 10)) {
+            const char* q = p + 10;
+            if (proc_parse_u64(&q, eol, &out->processes) != 0) return -1;
+        } else if (starts_with(p, eol, "procs_running ", 14)) {
+            const char* q = p + 14;
+            if (parse_u32(&q, eol, &out->procs_running) != 0) return -1;
+        } else if (starts_with(p, eol, "procs_blocked ", 14)) {
+            const char* q = p + 14;
+            if (parse_u32(&q, eol, &out->procs_blocked) != 0) return -1;
+        }
+        p = eol + 1;
+    }
+    return have_total ? 0 : -1;
+}
+
+typedef struct {
+    const char* key;
+    size_t len;
+    size_t offset;
+} meminfo_key_t;
+
+#define MEMINFO_KEY(name, field) { name, sizeof(name) - 1, offsetof(proc_meminfo_t, field) }
+
+static const meminfo_key_t meminfo_keys[] = {
+    MEMINFO_KEY("MemTotal", mem_total),
+    MEMINFO_KEY("MemFree", mem_free),
+    MEMINFO_KEY("MemAvailable", mem_available),
+    MEMINFO_KEY("Buffers", buffers),
+    MEMINFO_KEY("Cached", cached),
+    MEMINFO_KEY("SwapCached", swap_cached),
+    MEMINFO_KEY("Active", active),
+    MEMINFO_KEY("Inactive", inactive),
+    MEMINFO_KEY("SwapTotal", swap_total),
+    MEMINFO_KEY("SwapFree", swap_free),
+    MEMINFO_KEY("Dirty", dirty),
+    MEMINFO_KEY("Shmem", shmem),
+    MEMINFO_KEY("Slab", slab),
+};
+
+// "Key<sep>value" lines; fills the fields of `out` named by `keys` and
+// returns how many were found, or -1 if a known key has a malformed value
+static int parse_keyed(const char* buf, size_t len, char sep, const meminfo_key_t* keys,
+                       size_t key_count, void* out) {
+    const char* p = buf;
+    const char* end = buf + len;
+    int found = 0;
+
+    while (p < end) {
+        const char* eol = proc_find_newline(p, end);
+        const char* colon = memchr(p, sep, (size_t)(eol - p));
+        if (colon) {
+            size_t key_len = (size_t)(colon - p);
+            for (size_t i = 0; i < key_count; i++) {
+                const meminfo_key_t* k = &keys[i];
+                if (k->len == key_len && memcmp(p, k->key, key_len) == 0) {
+                    const char* q = colon + 1;
+                    uint64_t* field = (uint64_t*)((char*)out + k->offset);
+                    if (proc_parse_u64(&q, eol, field) != 0) return -1;
+                    found++;
+                    break;
+                }
+            }
+        }
+        p = eol + 1;
+    }
+    return found;
+}
+
+int proc_parse_meminfo(const char* buf, size_t len, proc_meminfo_t* out) {
+    memset(out, 0, sizeof(*out));
+    int found = parse_keyed(buf, len, ':', meminfo_keys, sizeof(meminfo_keys) / sizeof(meminfo_keys[0]), out);
+    return found > 0 ? 0 : -1;
+}
+
+int proc_parse_loadavg(const char* buf, size_t len, proc_loadavg_t* out) {
+    const char* p = buf;
+    const char* end = buf + len;
+    memset(out, 0, sizeof(*out));
+
+    if (parse_decimal(&p, end, &out->load1) != 0 ||
+        parse_decimal(&p, end, &out->load5) != 0 ||
+        parse_decimal(&p, end, &out->load15) != 0 ||
+        parse_u32(&p, end, &out->running) != 0 ||
+        p >= end || *p++ != '/' ||
+        parse_u32(&p, end, &out->total) != 0) {
+        return -1;
+    }
+    // Last PID is optional for our purposes
+    parse_u32(&p, end, &out->last_pid);
+    return 0;
+}
+
+int proc_parse_diskstats(const char* buf, size_t len, proc_disk_t* out, int max) {
+    const char* p = buf;
+    const char* end = buf + len;
+    int count = 0;
+
+    while (p < end && count < max) {
+        const char* eol = proc_find_newline(p, end);
+        const char* q = p;
+        proc_disk_t* disk = &out[count];
+        memset(disk, 0, sizeof(*disk));
+        if (skip_blanks(q, eol) != eol) {
+            if (parse_u32(&q, eol, &disk->major) != 0 ||
+                parse_u32(&q, eol, &disk->minor) != 0 ||
+                parse_name(&q, eol, disk->name, sizeof(disk->name)) != 0 ||
+                parse_counters(&q, eol, &disk->reads, 11) < 11) {
+                return -1;
+            }
+            count++;
+        }
+        p = eol + 1;
+    }
+    return count;
+}
+
+int proc_parse_netdev(const char* buf, size_t len, proc_netdev_t* out, int max) {
+    const char* p = buf;
+    const char* end = buf + len;
+    int count = 0;
+
+    while (p < end && count < max) {
+        const char* eol = proc_find_newline(p, end);
+        // Header lines have no ':'
+        const char* colon = memchr(p, ':', (size_t)(eol - p));
+        if (colon) {
+            proc_netdev_t* dev = &out[count];
+            memset(dev, 0, sizeof(*dev));
+            const char* q = p;
+            if (parse_name(&q, colon, dev->name, sizeof(dev->name)) != 0 || q != colon) {
+                return -1;
+            }
+            q = colon + 1;
+            if (parse_counters(&q, eol, &dev->rx_bytes, 16) < 16) return -1;
+            count++;
+        }
+        p = eol + 1;
+    }
+    return count;
+}
+
+int proc_parse_sysmon(const char* buf, size_t len, proc_sysmon_t* out) {
+    const char* p = buf;
+    const char* end = buf + len;
+    memset(out, 0, sizeof(*out));
+
+    while (p < end) {
+        while (p < end && (*p == ' ' || *p == '\t' || *p == '\n')) p++;
+        if (p >= end) break;
+        const char* q = p;
+        if (starts_with(p, end, "cpu_usage:", 10)) {
+            q = p + 10;
+            if (parse_decimal(&q, end, &out->cpu_usage) == 0) out->found |= PROC_SYSMON_CPU;
+        } else if (starts_with(p, end, "memory_free:", 12)) {
+            q = p + 12;
+            if (proc_parse_u64(&q, end, &out->memory_free) == 0) out->found |= PROC_SYSMON_MEMFREE;
+        } else if (starts_with(p, end, "processes:", 10)) {
+            q = p + 10;
+            if (parse_u32(&q, end, &out->processes) == 0) out->found |= PROC_SYSMON_PROCS;
+        }
+        // Skip the rest of the token
+        while (q < end && *q != ' ' && *q != '\t' && *q != '\n') q++;
+        p = q;
+    }
+    return out->found ? 0 : -1;
+}
+
+static const char* skip_fields(const char* p, const char* end, int count) {
+    while (count-- > 0) {
+        while (p < end && *p == ' ') p++;
+        while (p < end && *p != ' ') p++;
+    }
+    return p;
+}
+
+// "pid (comm) S ppid ... utime stime ... num_threads itrealvalue starttime vsize rss"
+// comm may itself contain spaces and ')', so it ends at the last ')'
+int proc_parse_pid_stat(const char* buf, size_t len, proc_pid_stat_t* out) {
+    const char* end = buf + len;
+    const char* open = memchr(buf, '(', len);
+    const char* close = end;
+    while (close > buf && *--close != ')') {}
+    if (!open || *close != ')' || close < open || end - close < 4) return -1;
+
+    size_t comm_len = (size_t)(close - open - 1);
+    if (comm_len >= PROC_COMM_LEN) comm_len = PROC_COMM_LEN - 1;
+    memcpy(out->comm, open + 1, comm_len);
+    out->comm[comm_len] = '\0';
+    out->state = close[2];
+
+    // Field 3 is the state; utime is field 14
+    const char* p = skip_fields(close + 3, end, 10);
+    if (proc_parse_u64(&p, end, &out->utime) != 0 || proc_parse_u64(&p, end, &out->stime) != 0) {
+        return -1;
+    }
+    p = skip_fields(p, end, 4);                 // cutime cstime priority nice
+    if (proc_parse_u64(&p, end, &out->threads) != 0) return -1;
+    p = skip_fields(p, end, 1);                 // itrealvalue
+    if (proc_parse_u64(&p, end, &out->start_time) != 0 ||
+        proc_parse_u64(&p, end, &out->vsize) != 0 ||
+        proc_parse_u64(&p, end, &out->rss) != 0) {
+        return -1;
+    }
+    return 0;
+}
+
+#define PID_IO_KEY(name, field) { name, sizeof(name) - 1, offsetof(proc_pid_io_t, field) }
+
+static const meminfo_key_t pid_io_keys[] = {
+    PID_IO_KEY("rchar", rchar),
+    PID_IO_KEY("wchar", wchar),
+    PID_IO_KEY("read_bytes", read_bytes),
+    PID_IO_KEY("write_bytes", write_bytes),
+};
+
+int proc_parse_pid_io(const char* buf, size_t len, proc_pid_io_t* out) {
+    memset(out, 0, sizeof(*out));
+    size_t count = sizeof(pid_io_keys) / sizeof(pid_io_keys[0]);
+    return parse_keyed(buf, len, ':', pid_io_keys, count, out) == (int)count ? 0 : -1;
+}
+
+#define PID_STATUS_KEY(name, field) { name, sizeof(name) - 1, offsetof(proc_pid_status_t, field) }
+
+static const meminfo_key_t pid_status_keys[] = {
+    PID_STATUS_KEY("VmRSS", vm_rss_kb),
+    PID_STATUS_KEY("VmSwap", vm_swap_kb),
+    PID_STATUS_KEY("voluntary_ctxt_switches", voluntary_ctxt_switches),
+    PID_STATUS_KEY("nonvoluntary_ctxt_switches", nonvoluntary_ctxt_switches),
+};
+
+// Kernel threads have no Vm* lines, so only the context switches are required
+int proc_parse_pid_status(const char* buf, size_t len, proc_pid_status_t* out) {
+    memset(out, 0, sizeof(*out));
+    int found = parse_keyed(buf, len, ':', pid_status_keys,
+                            sizeof(pid_status_keys) / sizeof(pid_status_keys[0]), out);
+    return found >= 2 ? 0 : -1;
+}
+
+#define CG_CPU_KEY(name, field) { name, sizeof(name) - 1, offsetof(proc_cg_cpu_t, field) }
+
+static const meminfo_key_t cg_cpu_keys[] = {
+    CG_CPU_KEY("usage_usec", usage_usec),
+    CG_CPU_KEY("user_usec", user_usec),
+    CG_CPU_KEY("system_usec", system_usec),
+    CG_CPU_KEY("nr_throttled", nr_throttled),
+    CG_CPU_KEY("throttled_usec", throttled_usec),
+};
+
+// cgroup v2 cpu.stat; only usage_usec is always present
+int proc_parse_cg_cpu(const char* buf, size_t len, proc_cg_cpu_t* out) {
+    memset(out, 0, sizeof(*out));
+    int found = parse_keyed(buf, len, ' ', cg_cpu_keys, sizeof(cg_cpu_keys) / sizeof(cg_cpu_keys[0]), out);
+    return found > 0 ? 0 : -1;
+}
+
+#define CG_MEM_KEY(name, field) { name, sizeof(name) - 1, offsetof(proc_cg_memstat_t, field) }
+
+static const meminfo_key_t cg_mem_keys[] = {
+    CG_MEM_KEY("anon", anon),
+    CG_MEM_KEY("file", file),
+    CG_MEM_KEY("kernel", kernel),
+    CG_MEM_KEY("sock", sock),
+    CG_MEM_KEY("shmem", shmem),
+    CG_MEM_KEY("pgfault", pgfault),
+    CG_MEM_KEY("pgmajfault", pgmajfault),
+};
+
+int proc_parse_cg_memstat(const char* buf, size_t len, proc_cg_memstat_t* out) {
+    memset(out, 0, sizeof(*out));
+    int found = parse_keyed(buf, len, ' ', cg_mem_keys, sizeof(cg_mem_keys) / sizeof(cg_mem_keys[0]), out);
+    return found > 0 ? 0 : -1;
+}
+
+// "8:0 rbytes=1 wbytes=2 rios=3 wios=4 dbytes=0 dios=0" per device, summed;
+// an empty file means no I/O yet
+int proc_parse_cg_io(const char* buf, size_t len, proc_cg_io_t* out) {
+    static const struct { const char* key; size_t len; size_t offset; } keys[] = {
+        { "rbytes=", 7, offsetof(proc_cg_io_t, rbytes) },
+        { "wbytes=", 7, offsetof(proc_cg_io_t, wbytes) },
+        { "rios=", 5, offsetof(proc_cg_io_t, rios) },
+        { "wios=", 5, offsetof(proc_cg_io_t, wios) },
+    };
+    const char* p = buf;
+    const char* end = buf + len;
+    memset(out, 0, sizeof(*out));
+
+    while (p < end) {
+        const char* eol = proc_find_newline(p, end);
+        const char* q = memchr(p, ' ', (size_t)(eol - p));
+        while (q && q < eol) {
+            q = skip_blanks(q, eol);
+            for (size_t k = 0; k < sizeof(keys) / sizeof(keys[0]); k++) {
+                if (starts_with(q, eol, keys[k].key, keys[k].len)) {
+                    const char* v = q + keys[k].len;
+                    uint64_t value;
+                    if (proc_parse_u64(&v, eol, &value) != 0) return -1;
+                    *(uint64_t*)((char*)out + keys[k].offset) += value;
+                    break;
+                }
+            }
+            while (q < eol && *q != ' ') q++;
+        }
+        p = eol + 1;
+    }
+    return 0;
+}
+
+// "<key>=<decimal>" with the key expected at this position
+static int parse_psi_field(const char** pp, const char* end, const char* key, size_t n, double* out) {
+    const char* p = skip_blanks(*pp, end);
+    if (!starts_with(p, end, key, n)) return -1;
+    p += n;
+    if (parse_decimal(&p, end, out) != 0) return -1;
+    *pp = p;
+    return 0;
+}
+
+// "some avg10=0.12 avg60=0.05 avg300=0.01 total=12345" and the same for
+// "full"; the system-wide cpu file only gained its "full" line in 5.13
+int proc_parse_psi(const char* buf, size_t len, proc_psi_t* out) {
+    const char* p = buf;
+    const char* end = buf + len;
+    int lines = 0;
+    memset(out, 0, sizeof(*out));
+
+    while (p < end) {
+        const char* eol = proc_find_newline(p, end);
+        proc_psi_line_t* line = NULL;
+        const char* q = p;
+        if (starts_with(q, eol, "some ", 5)) {
+            line = &out->some;
+        } else if (starts_with(q, eol, "full ", 5)) {
+            line = &out->full;
+            out->has_full = 1;
+        }
+        if (line) {
+            q += 5;
+            if (parse_psi_field(&q, eol, "avg10=", 6, &line->avg10) != 0 ||
+                parse_psi_field(&q, eol, "avg60=", 6, &line->avg60) != 0 ||
+                parse_psi_field(&q, eol, "avg300=", 7, &line->avg300) != 0) {
+                return -1;
+            }
+            q = skip_blanks(q, eol);
+            if (!starts_with(q, eol, "total=", 6)) return -1;
+            q += 6;
+            if (proc_parse_u64(&q, eol, &line->total) != 0) return -1;
+            lines++;
+        }
+        p = eol + 1;
+    }
+    return lines ? 0 : -1;
+}
+
+#define NODE_MEMINFO_KEY(name, field) { name, sizeof(name) - 1, offsetof(proc_node_meminfo_t, field) }
+#define NUMASTAT_KEY(name, field) { name, sizeof(name) - 1, offsetof(proc_numastat_t, field) }
+
+// Keys include their terminator so "Active:" cannot match "Active(anon):"
+static const meminfo_key_t node_meminfo_keys[] = {
+    NODE_MEMINFO_KEY("MemTotal:", mem_total),
+    NODE_MEMINFO_KEY("MemFree:", mem_free),
+    NODE_MEMINFO_KEY("MemUsed:", mem_used),
+    NODE_MEMINFO_KEY("FilePages:", file_pages),
+    NODE_MEMINFO_KEY("AnonPages:", anon_pages),
+    NODE_MEMINFO_KEY("Slab:", slab),
+};
+
+static const meminfo_key_t numastat_keys[] = {
+    NUMASTAT_KEY("numa_hit ", numa_hit),
+    NUMASTAT_KEY("numa_miss ", numa_miss),
+    NUMASTAT_KEY("numa_foreign ", numa_foreign),
+    NUMASTAT_KEY("interleave_hit ", interleave_hit),
+    NUMASTAT_KEY("local_node ", local_node),
+    NUMASTAT_KEY("other_node ", other_node),
+};
+
+// `key` starts a word at `at`: the start of the buffer or after a blank
+static int key_at(const char* buf, size_t len, size_t at, const meminfo_key_t* k) {
+    return at + k->len <= len && (at == 0 || buf[at - 1] == ' ' || buf[at - 1] == '\n') &&
+           memcmp(buf + at, k->key, k->len) == 0;
+}
+
+// Full scan: record the offset of every key, matched at any word start so
+// prefixes such as "Node 0 " need no special casing
+static void learn_offsets(const char* buf, size_t len, const meminfo_key_t* keys, size_t key_count,
+                          proc_offsets_t* offs) {
+    int any = 0;
+    memset(offs->found, 0, sizeof(offs->found));
+    for (size_t at = 0; at < len; at++) {
+        if (at > 0 && buf[at - 1] != ' ' && buf[at - 1] != '\n') continue;
+        for (size_t i = 0; i < key_count; i++) {
+            if (!offs->found[i] && buf[at] == keys[i].key[0] && key_at(buf, len, at, &keys[i])) {
+                offs->at[i] = (uint32_t)at;
+                offs->found[i] = 1;
+                any = 1;
+                break;
+            }
+        }
+    }
+    if (offs->learned) offs->relearns++;
+    // Nothing to check in place yet: scan again next time
+    offs->learned = any;
+}
+
+static int parse_at_offsets(const char* buf, size_t len, proc_offsets_t* offs,
+                            const meminfo_key_t* keys, size_t key_count, void* out) {
+    proc_offsets_t scratch;
+    if (!offs) {
+        memset(&scratch, 0, sizeof(scratch));
+        offs = &scratch;
+    }
+    int stale = !offs->learned;
+    for (size_t i = 0; i < key_count && !stale; i++) {
+        stale = offs->found[i] && !key_at(buf, len, offs->at[i], &keys[i]);
+    }
+    if (stale) learn_offsets(buf, len, keys, key_count, offs);
+
+    const char* end = buf + len;
+    int found = 0;
+    for (size_t i = 0; i < key_count; i++) {
+        if (!offs->found[i]) continue;
+        const char* q = buf + offs->at[i] + keys[i].len;
+        uint64_t* field = (uint64_t*)((char*)out + keys[i].offset);
+        if (proc_parse_u64(&q, proc_find_newline(q, end), field) != 0) return -1;
+        found++;
+    }
+    return found;
+}
+
+int proc_parse_node_meminfo(const char* buf, size_t len, proc_offsets_t* offs, proc_node_meminfo_t* out) {
+    memset(out, 0, sizeof(*out));
+    int found = parse_at_offsets(buf, len, offs, node_meminfo_keys,
+                                 sizeof(node_meminfo_keys) / sizeof(node_meminfo_keys[0]), out);
+    return found > 0 ? 0 : -1;
+}
+
+int proc_parse_numastat(const char* buf, size_t len, proc_offsets_t* offs, proc_numastat_t* out) {
+    memset(out, 0, sizeof(*out));
+    int found = parse_at_offsets(buf, len, offs, numastat_keys,
+                                 sizeof(numastat_keys) / sizeof(numastat_keys[0]), out);
+    return found > 0 ? 0 : -1;
+}
+
+int proc_append(char* buf, size_t size, int len, const char* fmt, ...) {
+    va_list ap;
+    va_start(ap, fmt);
+    size_t used = (size_t)len < size ? (size_t)len : size;
+    int n = vsnprintf(buf ? buf + used : NULL, size - used, fmt, ap);
+    va_end(ap);
+    return n < 0 ? len : len + n;
+}
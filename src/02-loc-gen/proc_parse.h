@@ -0,0 +1,248 @@
+#ifndef PROC_PARSE_H
+#define PROC_PARSE_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Single-pass parsers for procfs buffers. They read `len` bytes of `buf`
+// in place, never allocate, and fill caller-owned structs. Each returns 0
+// (or an entry count) on success and -1 if the input is malformed.
+
+#define PROC_MAX_CPUS 256
+#define PROC_MAX_DISKS 128
+#define PROC_MAX_NET_IFACES 64
+#define PROC_NAME_LEN 32
+
+// Jiffies for one line of /proc/stat
+typedef struct {
+    uint64_t user;
+    uint64_t nice;
+    uint64_t system;
+    uint64_t idle;
+    uint64_t iowait;
+    uint64_t irq;
+    uint64_t softirq;
+    uint64_t steal;
+    uint64_t guest;
+    uint64_t guest_nice;
+} proc_cpu_times_t;
+
+typedef struct {
+    proc_cpu_times_t total;
+    proc_cpu_times_t cpu[PROC_MAX_CPUS];
+    int cpu_count;              // per-CPU lines stored in cpu[]
+    int cpu_index[PROC_MAX_CPUS];   // N of the "cpuN" line each entry came from
+    uint64_t ctxt;
+    uint64_t btime;
+    uint64_t processes;
+    uint32_t procs_running;
+    uint32_t procs_blocked;
+} proc_stat_t;
+
+// Selected /proc/meminfo fields, in kB
+typedef struct {
+    uint64_t mem_total;
+    uint64_t mem_free;
+    uint64_t mem_available;
+    uint64_t buffers;
+    uint64_t cached;
+    uint64_t swap_cached;
+    uint64_t active;
+    uint64_t inactive;
+    uint64_t swap_total;
+    uint64_t swap_free;
+    uint64_t dirty;
+    uint64_t shmem;
+    uint64_t slab;
+} proc_meminfo_t;
+
+typedef struct {
+    double load1;
+    double load5;
+    double load15;
+    uint32_t running;
+    uint32_t total;
+    uint32_t last_pid;
+} proc_loadavg_t;
+
+// One /proc/diskstats line (the first 11 counters)
+typedef struct {
+    uint32_t major;
+    uint32_t minor;
+    char name[PROC_NAME_LEN];
+    uint64_t reads;
+    uint64_t reads_merged;
+    uint64_t sectors_read;
+    uint64_t read_ms;
+    uint64_t writes;
+    uint64_t writes_merged;
+    uint64_t sectors_written;
+    uint64_t write_ms;
+    uint64_t io_in_progress;
+    uint64_t io_ms;
+    uint64_t weighted_io_ms;
+} proc_disk_t;
+
+// One /proc/net/dev interface
+typedef struct {
+    char name[PROC_NAME_LEN];
+    uint64_t rx_bytes;
+    uint64_t rx_packets;
+    uint64_t rx_errs;
+    uint64_t rx_drop;
+    uint64_t rx_fifo;
+    uint64_t rx_frame;
+    uint64_t rx_compressed;
+    uint64_t rx_multicast;
+    uint64_t tx_bytes;
+    uint64_t tx_packets;
+    uint64_t tx_errs;
+    uint64_t tx_drop;
+    uint64_t tx_fifo;
+    uint64_t tx_colls;
+    uint64_t tx_carrier;
+    uint64_t tx_compressed;
+} proc_netdev_t;
+
+// /proc/<pid>/stat fields the process rooms use
+#define PROC_COMM_LEN 16
+
+typedef struct {
+    char comm[PROC_COMM_LEN];
+    char state;
+    uint64_t utime;
+    uint64_t stime;
+    uint64_t threads;
+    uint64_t start_time;        // clock ticks after boot
+    uint64_t vsize;             // bytes
+    uint64_t rss;               // pages
+} proc_pid_stat_t;
+
+// /proc/<pid>/io
+typedef struct {
+    uint64_t rchar;
+    uint64_t wchar;
+    uint64_t read_bytes;
+    uint64_t write_bytes;
+} proc_pid_io_t;
+
+// /proc/<pid>/status lines the pid room reports
+typedef struct {
+    uint64_t vm_rss_kb;
+    uint64_t vm_swap_kb;
+    uint64_t voluntary_ctxt_switches;
+    uint64_t nonvoluntary_ctxt_switches;
+} proc_pid_status_t;
+
+// cgroup v2 cpu.stat, memory.stat and io.stat (summed over devices)
+typedef struct {
+    uint64_t usage_usec;
+    uint64_t user_usec;
+    uint64_t system_usec;
+    uint64_t nr_throttled;
+    uint64_t throttled_usec;
+} proc_cg_cpu_t;
+
+typedef struct {
+    uint64_t anon;
+    uint64_t file;
+    uint64_t kernel;
+    uint64_t sock;
+    uint64_t shmem;
+    uint64_t pgfault;
+    uint64_t pgmajfault;
+} proc_cg_memstat_t;
+
+typedef struct {
+    uint64_t rbytes;
+    uint64_t wbytes;
+    uint64_t rios;
+    uint64_t wios;
+} proc_cg_io_t;
+
+// One line of /proc/pressure/{cpu,memory,io}; total is stalled time in us
+typedef struct {
+    double avg10;
+    double avg60;
+    double avg300;
+    uint64_t total;
+} proc_psi_line_t;
+
+typedef struct {
+    proc_psi_line_t some;
+    proc_psi_line_t full;       // zero where the kernel has no "full" line
+    int has_full;
+} proc_psi_t;
+
+// Selected fields of a NUMA node's sysfs meminfo, in kB
+typedef struct {
+    uint64_t mem_total;
+    uint64_t mem_free;
+    uint64_t mem_used;
+    uint64_t file_pages;
+    uint64_t anon_pages;
+    uint64_t slab;
+} proc_node_meminfo_t;
+
+// A NUMA node's numastat page counters
+typedef struct {
+    uint64_t numa_hit;
+    uint64_t numa_miss;
+    uint64_t numa_foreign;
+    uint64_t interleave_hit;
+    uint64_t local_node;
+    uint64_t other_node;
+} proc_numastat_t;
+
+// Where each wanted key sat in the previous read of a file whose layout is
+// stable. Learned by one full scan; later reads only check the key at each
+// offset and rescan when one has moved (a value grew a digit, say).
+#define PROC_OFFSETS_MAX 8
+
+typedef struct {
+    uint32_t at[PROC_OFFSETS_MAX];
+    uint8_t found[PROC_OFFSETS_MAX];
+    int learned;
+    unsigned long relearns;     // rescans after the first
+} proc_offsets_t;
+
+// "cpu_usage:45.2 memory_free:2048 processes:123" from the kernel module
+#define PROC_SYSMON_CPU     0x1
+#define PROC_SYSMON_MEMFREE 0x2
+#define PROC_SYSMON_PROCS   0x4
+
+typedef struct {
+    double cpu_usage;
+    uint64_t memory_free;
+    uint32_t processes;
+    unsigned found;             // PROC_SYSMON_* bits for the keys seen
+} proc_sysmon_t;
+
+int proc_parse_stat(const char* buf, size_t len, proc_stat_t* out);
+int proc_parse_meminfo(const char* buf, size_t len, proc_meminfo_t* out);
+int proc_parse_loadavg(const char* buf, size_t len, proc_loadavg_t* out);
+int proc_parse_diskstats(const char* buf, size_t len, proc_disk_t* out, int max);
+int proc_parse_netdev(const char* buf, size_t len, proc_netdev_t* out, int max);
+int proc_parse_sysmon(const char* buf, size_t len, proc_sysmon_t* out);
+int proc_parse_pid_stat(const char* buf, size_t len, proc_pid_stat_t* out);
+int proc_parse_pid_io(const char* buf, size_t len, proc_pid_io_t* out);
+int proc_parse_pid_status(const char* buf, size_t len, proc_pid_status_t* out);
+int proc_parse_cg_cpu(const char* buf, size_t len, proc_cg_cpu_t* out);
+int proc_parse_cg_memstat(const char* buf, size_t len, proc_cg_memstat_t* out);
+int proc_parse_cg_io(const char* buf, size_t len, proc_cg_io_t* out);
+int proc_parse_psi(const char* buf, size_t len, proc_psi_t* out);
+// `offs` may be NULL to scan the whole buffer every time
+int proc_parse_node_meminfo(const char* buf, size_t len, proc_offsets_t* offs, proc_node_meminfo_t* out);
+int proc_parse_numastat(const char* buf, size_t len, proc_offsets_t* offs, proc_numastat_t* out);
+
+// Building blocks, exposed for tests and other procfs sources
+const char* proc_find_newline(const char* p, const char* end);
+int proc_parse_u64(const char** p, const char* end, uint64_t* out);
+
+// Append to buf like snprintf and return the new length, which keeps
+// counting past `size` so callers can report the space they needed.
+// buf may be NULL to measure only.
+__attribute__((format(printf, 4, 5)))
+int proc_append(char* buf, size_t size, int len, const char* fmt, ...);
+
+#endif
@@ -0,0 +1,153 @@
+#include <stdlib.h>
+#include <string.h>
+#include "proc_rank.h"
+
+int proc_rank_init(proc_rank_t* rank, int32_t cap) {
+    memset(rank, 0, sizeof(*rank));
+    return proc_rank_reserve(rank, cap);
+}
+
+int proc_rank_reserve(proc_rank_t* rank, int32_t cap) {
+    if (cap <= rank->cap) return 0;
+    int32_t* heap = realloc(rank->heap, sizeof(int32_t) * (size_t)cap);
+    if (!heap) return -1;
+    rank->heap = heap;
+    int32_t* pos = realloc(rank->pos, sizeof(int32_t) * (size_t)cap);
+    if (!pos) return -1;
+    rank->pos = pos;
+    double* key = realloc(rank->key, sizeof(double) * (size_t)cap);
+    if (!key) return -1;
+    rank->key = key;
+    for (int32_t i = rank->cap; i < cap; i++) rank->pos[i] = -1;
+    rank->cap = cap;
+    return 0;
+}
+
+static void place(proc_rank_t* rank, int32_t i, int32_t slot) {
+    rank->heap[i] = slot;
+    rank->pos[slot] = i;
+}
+
+static void sift_up(proc_rank_t* rank, int32_t i) {
+    int32_t slot = rank->heap[i];
+    double key = rank->key[slot];
+    while (i > 0) {
+        int32_t parent = (i - 1) / 2;
+        if (rank->key[rank->heap[parent]] >= key) break;
+        place(rank, i, rank->heap[parent]);
+        i = parent;
+    }
+    place(rank, i, slot);
+}
+
+static void sift_down(proc_rank_t* rank, int32_t i) {
+    int32_t slot = rank->heap[i];
+    double key = rank->key[slot];
+    for (;;) {
+        int32_t child = 2 * i + 1;
+        if (child >= rank->size) break;
+        if (child + 1 < rank->size && rank->key[rank->heap[child + 1]] > rank->key[rank->heap[child]]) {
+            child++;
+        }
+        if (rank->key[rank->heap[child]] <= key) break;
+        place(rank, i, rank->heap[child]);
+        i = child;
+    }
+    place(rank, i, slot);
+}
+
+void proc_rank_update(proc_rank_t* rank, int32_t slot, double key) {
+    if (slot < 0 || slot >= rank->cap) return;
+    int32_t i = rank->pos[slot];
+    if (i < 0) {
+        rank->key[slot] = key;
+        place(rank, rank->size++, slot);
+        sift_up(rank, rank->size - 1);
+        return;
+    }
+    double old = rank->key[slot];
+    if (key == old) return;
+    rank->key[slot] = key;
+    if (key > old) {
+        sift_up(rank, i);
+    } else {
+        sift_down(rank, i);
+    }
+}
+
+void proc_rank_remove(proc_rank_t* rank, int32_t slot) {
+    if (slot < 0 || slot >= rank->cap || rank->pos[slot] < 0) return;
+    int32_t i = rank->pos[slot];
+    rank->pos[slot] = -1;
+    int32_t last = rank->heap[--rank->size];
+    if (i == rank->size) return;
+    place(rank, i, last);
+    sift_up(rank, i);
+    sift_down(rank, rank->pos[last]);
+}
+
+// Frontier of heap indices ordered by key, itself a small binary heap
+typedef struct {
+    const proc_rank_t* rank;
+    int32_t* items;
+    int size;
+} frontier_t;
+
+static double frontier_key(const frontier_t* f, int i) {
+    return f->rank->key[f->rank->heap[f->items[i]]];
+}
+
+static void frontier_swap(frontier_t* f, int a, int b) {
+    int32_t tmp = f->items[a];
+    f->items[a] = f->items[b];
+    f->items[b] = tmp;
+}
+
+static void frontier_push(frontier_t* f, int32_t index) {
+    int i = f->size++;
+    f->items[i] = index;
+    while (i > 0 && frontier_key(f, (i - 1) / 2) < frontier_key(f, i)) {
+        frontier_swap(f, i, (i - 1) / 2);
+        i = (i - 1) / 2;
+    }
+}
+
+static int32_t frontier_pop(frontier_t* f) {
+    int32_t top = f->items[0];
+    f->items[0] = f->items[--f->size];
+    int i = 0;
+    for (;;) {
+        int child = 2 * i + 1;
+        if (child >= f->size) break;
+        if (child + 1 < f->size && frontier_key(f, child + 1) > frontier_key(f, child)) child++;
+        if (frontier_key(f, child) <= frontier_key(f, i)) break;
+        frontier_swap(f, i, child);
+        i = child;
+    }
+    return top;
+}
+
+// Best-first walk from the root: the next largest key is always the root of
+// a subtree on the frontier, and each pop adds at most two children
+int proc_rank_top(const proc_rank_t* rank, int n, int32_t* slots) {
+    if (n <= 0 || rank->size == 0) return 0;
+    frontier_t f = { rank, malloc(sizeof(int32_t) * ((size_t)n + 2)), 0 };
+    if (!f.items) return -1;
+    int count = 0;
+    frontier_push(&f, 0);
+    while (count < n && f.size > 0) {
+        int32_t i = frontier_pop(&f);
+        slots[count++] = rank->heap[i];
+        if (2 * i + 1 < rank->size) frontier_push(&f, 2 * i + 1);
+        if (2 * i + 2 < rank->size) frontier_push(&f, 2 * i + 2);
+    }
+    free(f.items);
+    return count;
+}
+
+void proc_rank_free(proc_rank_t* rank) {
+    free(rank->heap);
+    free(rank->pos);
+    free(rank->key);
+    memset(rank, 0, sizeof(*rank));
+}
@@ -0,0 +1,25 @@
+#ifndef PROC_RANK_H
+#define PROC_RANK_H
+
+#include <stdint.h>
+
+// Indexed max-heap over slot numbers. Each slot's position is tracked so a
+// changed key is fixed up in O(log n) and top-N reads never sort everything.
+typedef struct {
+    int32_t* heap;      // slots, largest key first
+    int32_t* pos;       // slot -> heap index, -1 when absent
+    double* key;        // slot -> key
+    int32_t size;
+    int32_t cap;        // slots addressable
+} proc_rank_t;
+
+int proc_rank_init(proc_rank_t* rank, int32_t cap);
+int proc_rank_reserve(proc_rank_t* rank, int32_t cap);
+// Insert the slot or move it to its new key
+void proc_rank_update(proc_rank_t* rank, int32_t slot, double key);
+void proc_rank_remove(proc_rank_t* rank, int32_t slot);
+// Up to n slots with the largest keys, largest first; O(n log n)
+int proc_rank_top(const proc_rank_t* rank, int n, int32_t* slots);
+void proc_rank_free(proc_rank_t* rank);
+
+#endif
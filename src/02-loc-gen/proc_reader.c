@@ -0,0 +1,90 @@
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <errno.h>
+#include "proc_reader.h"
+
+static int reopen(proc_file_t* pf) {
+    if (pf->fd >= 0) close(pf->fd);
+    pf->fd = open(pf->path, O_RDONLY | O_CLOEXEC);
+    pf->opens++;
+    return pf->fd >= 0 ? 0 : -1;
+}
+
+int proc_file_open(proc_file_t* pf, const char* path) {
+    memset(pf, 0, sizeof(*pf));
+    pf->fd = -1;
+    if (strlen(path) >= sizeof(pf->path)) {
+        errno = ENAMETOOLONG;
+        return -1;
+    }
+    strcpy(pf->path, path);
+    pf->buf = malloc(PROC_READER_INITIAL_SIZE);
+    if (!pf->buf) return -1;
+    pf->cap = PROC_READER_INITIAL_SIZE;
+    pf->buf[0] = '\0';
+    // A missing file is not fatal: proc_file_read() keeps trying to reopen it
+    reopen(pf);
+    return 0;
+}
+
+// Record tables such as /proc/net/tcp, /proc/net/dev and /proc/diskstats
+// return about a page per read however large the buffer, so a short read
+// is not the end of the file there
+int proc_file_open_paged(proc_file_t* pf, const char* path) {
+    if (proc_file_open(pf, path) != 0) return -1;
+    pf->paged = 1;
+    return 0;
+}
+
+// Fill the buffer from offset 0. Most procfs files hand back everything that
+// fits in one read, so a short read is the end of the file and only a full
+// buffer needs another pread() after growing it. Paged files are read until
+// pread() returns 0.
+static ssize_t read_whole(proc_file_t* pf) {
+    size_t off = 0;
+    for (;;) {
+        size_t want = pf->cap - 1 - off;
+        ssize_t n = pread(pf->fd, pf->buf + off, want, (off_t)off);
+        pf->reads++;
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            return -1;
+        }
+        off += (size_t)n;
+        if (pf->paged ? n == 0 : (size_t)n < want) break;
+        if ((size_t)n < want) continue;
+
+        char* grown = realloc(pf->buf, pf->cap * 2);
+        if (!grown) return -1;
+        pf->buf = grown;
+        pf->cap *= 2;
+    }
+    pf->buf[off] = '\0';
+    pf->len = off;
+    return (ssize_t)off;
+}
+
+// Re-read the file; reopens once if the descriptor went bad (e.g. the
+// file was recreated). Returns the length read or -1 with errno set.
+ssize_t proc_file_read(proc_file_t* pf) {
+    if (!pf->buf) {
+        errno = EINVAL;
+        return -1;
+    }
+    if (pf->fd >= 0) {
+        ssize_t n = read_whole(pf);
+        if (n >= 0) return n;
+    }
+    if (reopen(pf) != 0) return -1;
+    return read_whole(pf);
+}
+
+void proc_file_close(proc_file_t* pf) {
+    if (pf->fd >= 0) close(pf->fd);
+    free(pf->buf);
+    pf->fd = -1;
+    pf->buf = NULL;
+    pf->len = pf->cap = 0;
+}
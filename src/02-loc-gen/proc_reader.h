@@ -0,0 +1,26 @@
+#ifndef PROC_READER_H
+#define PROC_READER_H
+
+#include <stddef.h>
+#include <sys/types.h>
+
+#define PROC_READER_INITIAL_SIZE 4096
+
+// A procfs file kept open between samples and re-read with pread()
+typedef struct {
+    char path[128];
+    int fd;
+    char* buf;          // NUL-terminated contents of the last read
+    size_t len;
+    size_t cap;
+    unsigned long reads;    // pread() calls issued
+    unsigned long opens;    // open() calls, including the first
+    int paged;              // read until EOF, see proc_file_open_paged()
+} proc_file_t;
+
+int proc_file_open(proc_file_t* pf, const char* path);
+int proc_file_open_paged(proc_file_t* pf, const char* path);
+ssize_t proc_file_read(proc_file_t* pf);
+void proc_file_close(proc_file_t* pf);
+
+#endif
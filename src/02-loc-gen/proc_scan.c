@@ -0,0 +1,340 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <errno.h>
+#include <time.h>
+#include <sys/syscall.h>
+#include "proc_scan.h"
+#include "proc_parse.h"
+
+#define PROC_SCAN_DENTS_SIZE 65536
+#define PROC_SCAN_MIN_TASKS 1024
+#define PROC_SCAN_CHUNK 256
+#define PROC_SCAN_READ_SIZE 1024
+
+struct linux_dirent64 {
+    uint64_t d_ino;
+    int64_t d_off;
+    unsigned short d_reclen;
+    unsigned char d_type;
+    char d_name[];
+};
+
+static size_t pid_hash(int32_t pid, size_t mask) {
+    return (size_t)((uint32_t)pid * 2654435761u) & mask;
+}
+
+static int32_t* index_slot(const proc_scan_t* ps, int32_t pid) {
+    size_t mask = ps->index_size - 1;
+    size_t i = pid_hash(pid, mask);
+    while (ps->index[i] != 0 && ps->tasks[ps->index[i] - 1].pid != pid) i = (i + 1) & mask;
+    return &ps->index[i];
+}
+
+// Linear-probing delete: shift later members of the cluster back so
+// lookups never stop at a hole
+static void index_remove(proc_scan_t* ps, int32_t pid) {
+    size_t mask = ps->index_size - 1;
+    size_t hole = (size_t)(index_slot(ps, pid) - ps->index);
+    if (ps->index[hole] == 0) return;
+    ps->index[hole] = 0;
+    for (size_t i = (hole + 1) & mask; ps->index[i] != 0; i = (i + 1) & mask) {
+        size_t home = pid_hash(ps->tasks[ps->index[i] - 1].pid, mask);
+        // Move it if its home is not cyclically within (hole, i]
+        if ((i > hole && (home <= hole || home > i)) || (i < hole && home <= hole && home > i)) {
+            ps->index[hole] = ps->index[i];
+            ps->index[i] = 0;
+            hole = i;
+        }
+    }
+}
+
+static int grow_tasks(proc_scan_t* ps, int32_t cap) {
+    proc_task_t* tasks = realloc(ps->tasks, sizeof(proc_task_t) * (size_t)cap);
+    if (!tasks) return -1;
+    int32_t* work = realloc(ps->work, sizeof(int32_t) * (size_t)cap);
+    if (!work) {
+        ps->tasks = tasks;
+        return -1;
+    }
+    for (int32_t i = cap - 1; i >= ps->task_cap; i--) {
+        tasks[i].pid = 0;
+        tasks[i].next_free = ps->free_head;
+        ps->free_head = i;
+    }
+    ps->tasks = tasks;
+    ps->work = work;
+    ps->task_cap = cap;
+    if (proc_rank_reserve(&ps->by_cpu, cap) != 0 || proc_rank_reserve(&ps->by_mem, cap) != 0) {
+        return -1;
+    }
+
+    // Keep the index at most half full
+    size_t size = ps->index_size ? ps->index_size : 2 * PROC_SCAN_MIN_TASKS;
+    while (size < (size_t)cap * 2) size *= 2;
+    if (size != ps->index_size) {
+        int32_t* index = calloc(size, sizeof(int32_t));
+        if (!index) return -1;
+        int32_t* old = ps->index;
+        size_t old_size = ps->index_size;
+        ps->index = index;
+        ps->index_size = size;
+        for (size_t i = 0; i < old_size; i++) {
+            if (old[i]) *index_slot(ps, ps->tasks[old[i] - 1].pid) = old[i];
+        }
+        free(old);
+    }
+    return 0;
+}
+
+static int32_t task_for_pid(proc_scan_t* ps, int32_t pid) {
+    int32_t* slot = index_slot(ps, pid);
+    if (*slot) return *slot - 1;
+    if (ps->free_head < 0) {
+        if (grow_tasks(ps, ps->task_cap * 2) != 0) return -1;
+        slot = index_slot(ps, pid);
+    }
+    int32_t t = ps->free_head;
+    ps->free_head = ps->tasks[t].next_free;
+    memset(&ps->tasks[t], 0, sizeof(proc_task_t));
+    ps->tasks[t].pid = pid;
+    ps->tasks[t].next_free = -1;
+    *slot = t + 1;
+    ps->task_count++;
+    return t;
+}
+
+static void release_task(proc_scan_t* ps, int32_t t) {
+    proc_rank_remove(&ps->by_cpu, t);
+    proc_rank_remove(&ps->by_mem, t);
+    index_remove(ps, ps->tasks[t].pid);
+    ps->tasks[t].pid = 0;
+    ps->tasks[t].next_free = ps->free_head;
+    ps->free_head = t;
+    ps->task_count--;
+}
+
+static int read_at(int dirfd, const char* path, char* buf, size_t size) {
+    int fd = openat(dirfd, path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) return -1;
+    ssize_t n = read(fd, buf, size - 1);
+    close(fd);
+    if (n <= 0) return -1;
+    buf[n] = '\0';
+    return (int)n;
+}
+
+static void refresh_task(proc_scan_t* ps, proc_task_t* task, char* buf) {
+    char path[32];
+    proc_pid_stat_t stat;
+
+    snprintf(path, sizeof(path), "%d/stat", task->pid);
+    int n = read_at(ps->dirfd, path, buf, PROC_SCAN_READ_SIZE);
+    if (n < 0 || proc_parse_pid_stat(buf, (size_t)n, &stat) != 0) {
+        task->failed = 1;
+        return;
+    }
+    uint64_t cpu_ticks = stat.utime + stat.stime;
+    uint64_t start_time = stat.start_time;
+    memcpy(task->comm, stat.comm, sizeof(task->comm));
+    task->state = stat.state;
+    task->threads = (uint32_t)stat.threads;
+    task->vsize = stat.vsize;
+
+    // A new process, or a new one that reused the PID, has no previous sample
+    if (task->start_time == start_time && ps->elapsed_ticks > 0 && cpu_ticks >= task->cpu_ticks) {
+        task->cpu_pct = (float)(100.0 * (double)(cpu_ticks - task->cpu_ticks) / ps->elapsed_ticks);
+    } else {
+        task->cpu_pct = 0;
+    }
+    task->cpu_ticks = cpu_ticks;
+    task->start_time = start_time;
+
+    snprintf(path, sizeof(path), "%d/statm", task->pid);
+    n = read_at(ps->dirfd, path, buf, PROC_SCAN_READ_SIZE);
+    const char* p = buf;
+    uint64_t size;
+    if (n < 0 || proc_parse_u64(&p, buf + n, &size) != 0 ||
+        proc_parse_u64(&p, buf + n, &task->rss_pages) != 0) {
+        task->failed = 1;
+    }
+}
+
+static void run_chunks(proc_scan_t* ps) {
+    char buf[PROC_SCAN_READ_SIZE];
+    for (;;) {
+        int start = __atomic_fetch_add(&ps->next_chunk, PROC_SCAN_CHUNK, __ATOMIC_RELAXED);
+        if (start >= ps->work_count) break;
+        int stop = start + PROC_SCAN_CHUNK < ps->work_count ? start + PROC_SCAN_CHUNK : ps->work_count;
+        for (int i = start; i < stop; i++) refresh_task(ps, &ps->tasks[ps->work[i]], buf);
+    }
+}
+
+static void* worker_main(void* arg) {
+    proc_scan_worker_t* worker = arg;
+    proc_scan_t* ps = worker->scan;
+    uint32_t seen = 0;
+
+    pthread_mutex_lock(&ps->lock);
+    for (;;) {
+        while (!ps->stop && ps->round == seen) pthread_cond_wait(&ps->start, &ps->lock);
+        if (ps->stop) break;
+        seen = ps->round;
+        pthread_mutex_unlock(&ps->lock);
+
+        run_chunks(ps);
+
+        pthread_mutex_lock(&ps->lock);
+        if (--ps->running == 0) pthread_cond_signal(&ps->done);
+    }
+    pthread_mutex_unlock(&ps->lock);
+    return NULL;
+}
+
+int proc_scan_init(proc_scan_t* ps, const char* root, int workers) {
+    memset(ps, 0, sizeof(*ps));
+    ps->free_head = -1;
+    pthread_mutex_init(&ps->lock, NULL);
+    pthread_cond_init(&ps->start, NULL);
+    pthread_cond_init(&ps->done, NULL);
+    ps->dirfd = open(root, O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (ps->dirfd < 0) {
+        perror("open proc root");
+        return -1;
+    }
+    ps->dents = malloc(PROC_SCAN_DENTS_SIZE);
+    if (!ps->dents || grow_tasks(ps, PROC_SCAN_MIN_TASKS) != 0) {
+        proc_scan_free(ps);
+        return -1;
+    }
+
+    if (workers > PROC_SCAN_MAX_WORKERS) workers = PROC_SCAN_MAX_WORKERS;
+    for (int i = 0; i < workers; i++) {
+        ps->workers[i].scan = ps;
+        if (pthread_create(&ps->workers[i].thread, NULL, worker_main, &ps->workers[i]) != 0) {
+            break;
+        }
+        ps->worker_count++;
+    }
+    return 0;
+}
+
+static int is_pid_name(const char* name) {
+    if (*name < '1' || *name > '9') return 0;
+    for (name++; *name; name++) {
+        if (*name < '0' || *name > '9') return 0;
+    }
+    return 1;
+}
+
+// List the numeric entries of the root and queue their slots in `work`
+static int list_pids(proc_scan_t* ps) {
+    if (lseek(ps->dirfd, 0, SEEK_SET) < 0) return -1;
+    ps->work_count = 0;
+    for (;;) {
+        long n = syscall(SYS_getdents64, ps->dirfd, ps->dents, PROC_SCAN_DENTS_SIZE);
+        if (n < 0) return -1;
+        if (n == 0) break;
+        for (long off = 0; off < n;) {
+            struct linux_dirent64* d = (struct linux_dirent64*)(ps->dents + off);
+            off += d->d_reclen;
+            if (!is_pid_name(d->d_name)) continue;
+            int32_t t = task_for_pid(ps, (int32_t)atoi(d->d_name));
+            if (t < 0) return -1;
+            proc_task_t* task = &ps->tasks[t];
+            task->generation = ps->generation;
+            task->failed = 0;
+            ps->work[ps->work_count++] = t;
+        }
+    }
+    return 0;
+}
+
+int proc_scan_tick_at(proc_scan_t* ps, uint64_t now_ns) {
+    static long clock_ticks = 0;
+    if (!clock_ticks) clock_ticks = sysconf(_SC_CLK_TCK);
+
+    ps->generation++;
+    if (list_pids(ps) != 0) return -1;
+    ps->elapsed_ticks = ps->last_ns && now_ns > ps->last_ns
+                            ? (double)(now_ns - ps->last_ns) / 1e9 * (double)clock_ticks
+                            : 0;
+
+    ps->next_chunk = 0;
+    if (ps->worker_count > 0 && ps->work_count > PROC_SCAN_CHUNK) {
+        pthread_mutex_lock(&ps->lock);
+        ps->running = ps->worker_count;
+        ps->round++;
+        pthread_cond_broadcast(&ps->start);
+        pthread_mutex_unlock(&ps->lock);
+
+        run_chunks(ps);
+
+        pthread_mutex_lock(&ps->lock);
+        while (ps->running > 0) pthread_cond_wait(&ps->done, &ps->lock);
+        pthread_mutex_unlock(&ps->lock);
+    } else {
+        run_chunks(ps);
+    }
+
+    // Drop processes that exited, whether before or during the scan
+    ps->total_threads = 0;
+    for (int32_t t = 0; t < ps->task_cap; t++) {
+        proc_task_t* task = &ps->tasks[t];
+        if (task->pid == 0) continue;
+        if (task->generation != ps->generation || task->failed) {
+            release_task(ps, t);
+        } else {
+            ps->total_threads += task->threads;
+            proc_rank_update(&ps->by_cpu, t, task->cpu_pct);
+            proc_rank_update(&ps->by_mem, t, (double)task->rss_pages);
+        }
+    }
+    ps->last_ns = now_ns;
+    return ps->task_count;
+}
+
+int proc_scan_tick(proc_scan_t* ps) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return proc_scan_tick_at(ps, (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec);
+}
+
+const proc_task_t* proc_scan_find(const proc_scan_t* ps, int32_t pid) {
+    int32_t slot = *index_slot(ps, pid);
+    return slot ? &ps->tasks[slot - 1] : NULL;
+}
+
+int proc_scan_top(const proc_scan_t* ps, int by, int n, const proc_task_t** out) {
+    if (n <= 0) return 0;
+    int32_t* slots = malloc(sizeof(int32_t) * (size_t)n);
+    if (!slots) return -1;
+    int count = proc_rank_top(by == PROC_SCAN_BY_MEM ? &ps->by_mem : &ps->by_cpu, n, slots);
+    for (int i = 0; i < count; i++) out[i] = &ps->tasks[slots[i]];
+    free(slots);
+    return count;
+}
+
+void proc_scan_free(proc_scan_t* ps) {
+    if (ps->worker_count > 0) {
+        pthread_mutex_lock(&ps->lock);
+        ps->stop = 1;
+        pthread_cond_broadcast(&ps->start);
+        pthread_mutex_unlock(&ps->lock);
+        for (int i = 0; i < ps->worker_count; i++) pthread_join(ps->workers[i].thread, NULL);
+    }
+    pthread_mutex_destroy(&ps->lock);
+    pthread_cond_destroy(&ps->start);
+    pthread_cond_destroy(&ps->done);
+    if (ps->dirfd >= 0) close(ps->dirfd);
+    free(ps->dents);
+    free(ps->tasks);
+    free(ps->index);
+    free(ps->work);
+    proc_rank_free(&ps->by_cpu);
+    proc_rank_free(&ps->by_mem);
+    memset(ps, 0, sizeof(*ps));
+    ps->dirfd = -1;
+}
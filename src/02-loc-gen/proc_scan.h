@@ -0,0 +1,80 @@
+#ifndef PROC_SCAN_H
+#define PROC_SCAN_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <pthread.h>
+#include "proc_rank.h"
+#include "proc_parse.h"
+
+#define PROC_SCAN_MAX_WORKERS 16
+
+#define PROC_SCAN_BY_CPU 0
+#define PROC_SCAN_BY_MEM 1
+
+// One live process, kept across ticks so CPU% comes from per-PID deltas
+typedef struct {
+    int32_t pid;
+    char state;
+    uint8_t failed;             // vanished while being read this tick
+    char comm[PROC_COMM_LEN];
+    uint32_t threads;
+    uint32_t generation;        // last tick the PID was listed
+    uint64_t start_time;        // clock ticks after boot; detects PID reuse
+    uint64_t cpu_ticks;         // utime + stime
+    uint64_t vsize;             // bytes
+    uint64_t rss_pages;         // from statm
+    float cpu_pct;              // since the previous tick, 100 = one CPU
+    int32_t next_free;
+} proc_task_t;
+
+typedef struct proc_scan proc_scan_t;
+
+typedef struct {
+    proc_scan_t* scan;
+    pthread_t thread;
+} proc_scan_worker_t;
+
+struct proc_scan {
+    int dirfd;                  // the procfs root, for getdents64 and openat
+    char* dents;                // getdents64 buffer
+    proc_task_t* tasks;         // stable slots; `free_head` chains unused ones
+    int32_t task_cap;
+    int32_t free_head;
+    int32_t task_count;
+    int32_t* index;             // open addressing pid -> slot + 1, 0 = empty
+    size_t index_size;
+    int32_t* work;              // slots to read this tick
+    int32_t work_count;
+    uint32_t generation;
+    uint64_t last_ns;
+    double elapsed_ticks;       // clock ticks between the last two scans
+    uint64_t total_threads;
+    // Slots ranked by CPU% and RSS; only processes whose value changed are
+    // re-sifted each tick
+    proc_rank_t by_cpu;
+    proc_rank_t by_mem;
+    // Worker pool: each tick hands out `work` in chunks through next_chunk
+    proc_scan_worker_t workers[PROC_SCAN_MAX_WORKERS];
+    int worker_count;
+    pthread_mutex_t lock;
+    pthread_cond_t start;
+    pthread_cond_t done;
+    uint32_t round;
+    int running;
+    int stop;
+    int next_chunk;
+};
+
+// root is normally "/proc"; workers <= 0 scans on the calling thread only
+int proc_scan_init(proc_scan_t* ps, const char* root, int workers);
+// List the root and refresh every process; returns the process count or -1
+int proc_scan_tick(proc_scan_t* ps);
+// Same with an explicit monotonic timestamp, for tests
+int proc_scan_tick_at(proc_scan_t* ps, uint64_t now_ns);
+const proc_task_t* proc_scan_find(const proc_scan_t* ps, int32_t pid);
+// Up to n processes with the most CPU% or RSS (PROC_SCAN_BY_*), largest first
+int proc_scan_top(const proc_scan_t* ps, int by, int n, const proc_task_t** out);
+void proc_scan_free(proc_scan_t* ps);
+
+#endif
@@ -0,0 +1,217 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <errno.h>
+#include <poll.h>
+#include <time.h>
+#include "psi_watch.h"
+
+static const char* const resource_names[PSI_RESOURCES] = { "cpu", "memory", "io" };
+
+const char* psi_resource_name(psi_resource_t resource) {
+    return (unsigned)resource < PSI_RESOURCES ? resource_names[resource] : "?";
+}
+
+int psi_resource_from_name(const char* name) {
+    for (int r = 0; r < PSI_RESOURCES; r++) {
+        if (strcmp(name, resource_names[r]) == 0) return r;
+    }
+    return -1;
+}
+
+static int resource_path(const psi_watch_t* pw, psi_resource_t resource, char* path, size_t size) {
+    int n = snprintf(path, size, "%s/%s", pw->root, resource_names[resource]);
+    return n < 0 || (size_t)n >= size ? -1 : 0;
+}
+
+int psi_watch_init(psi_watch_t* pw, const char* root) {
+    memset(pw, 0, sizeof(*pw));
+    pw->wake_pipe[0] = pw->wake_pipe[1] = -1;
+    for (int r = 0; r < PSI_RESOURCES; r++) pw->files[r].fd = -1;
+    if (strlen(root) >= sizeof(pw->root)) {
+        errno = ENAMETOOLONG;
+        return -1;
+    }
+    strcpy(pw->root, root);
+
+    int available = 0;
+    for (int r = 0; r < PSI_RESOURCES; r++) {
+        char path[128];
+        if (resource_path(pw, r, path, sizeof(path)) != 0 ||
+            proc_file_open(&pw->files[r], path) != 0) {
+            psi_watch_free(pw);
+            return -1;
+        }
+        if (pw->files[r].fd >= 0) available++;
+    }
+    // Kernels built without CONFIG_PSI, or booted with psi=0
+    if (available == 0) {
+        psi_watch_free(pw);
+        errno = ENOENT;
+        return -1;
+    }
+
+    if (pipe(pw->wake_pipe) != 0) {
+        psi_watch_free(pw);
+        return -1;
+    }
+    for (int i = 0; i < 2; i++) {
+        fcntl(pw->wake_pipe[i], F_SETFL, O_NONBLOCK);
+        fcntl(pw->wake_pipe[i], F_SETFD, FD_CLOEXEC);
+    }
+    return 0;
+}
+
+// Each trigger needs its own descriptor; the threshold is written into it
+// and stays registered until the descriptor is closed
+int psi_watch_add_trigger(psi_watch_t* pw, psi_resource_t resource, int full,
+                          uint32_t stall_us, uint32_t window_us) {
+    if ((unsigned)resource >= PSI_RESOURCES || pw->trigger_count >= PSI_MAX_TRIGGERS ||
+        window_us < PSI_MIN_WINDOW_US || window_us > PSI_MAX_WINDOW_US ||
+        stall_us == 0 || stall_us > window_us) {
+        errno = EINVAL;
+        return -1;
+    }
+    char path[128];
+    if (resource_path(pw, resource, path, sizeof(path)) != 0) {
+        errno = ENAMETOOLONG;
+        return -1;
+    }
+    int fd = open(path, O_RDWR | O_NONBLOCK | O_CLOEXEC);
+    if (fd < 0) return -1;
+
+    char spec[64];
+    int n = snprintf(spec, sizeof(spec), "%s %u %u", full ? "full" : "some", stall_us, window_us);
+    // The kernel expects the terminating NUL as part of the write
+    if (write(fd, spec, (size_t)n + 1) < 0) {
+        int saved = errno;
+        close(fd);
+        errno = saved;
+        return -1;
+    }
+
+    psi_trigger_t* t = &pw->triggers[pw->trigger_count++];
+    t->fd = fd;
+    t->resource = resource;
+    t->full = full;
+    t->stall_us = stall_us;
+    t->window_us = window_us;
+    t->events = 0;
+    return 0;
+}
+
+int psi_watch_wait(psi_watch_t* pw, int timeout_ms) {
+    struct pollfd fds[PSI_MAX_TRIGGERS + 1];
+    int n = 0;
+    for (int i = 0; i < pw->trigger_count; i++) {
+        fds[n].fd = pw->triggers[i].fd;
+        fds[n].events = POLLPRI;
+        fds[n].revents = 0;
+        n++;
+    }
+    fds[n].fd = pw->wake_pipe[0];
+    fds[n].events = POLLIN;
+    fds[n].revents = 0;
+
+    int ready = poll(fds, (nfds_t)n + 1, timeout_ms);
+    if (ready < 0) return errno == EINTR ? 0 : -1;
+    if (ready == 0) return 0;
+
+    if (fds[n].revents & POLLIN) {
+        char drain[64];
+        while (read(pw->wake_pipe[0], drain, sizeof(drain)) > 0) {
+        }
+    }
+    int fired = 0;
+    for (int i = 0; i < n; i++) {
+        psi_trigger_t* t = &pw->triggers[i];
+        if (fds[i].revents & POLLERR) {
+            // The pressure file went away; stop polling this trigger
+            close(t->fd);
+            t->fd = -1;
+        } else if (fds[i].revents & POLLPRI) {
+            t->events++;
+            pw->events++;
+            fired |= PSI_BIT(t->resource);
+        }
+    }
+    return fired;
+}
+
+void psi_watch_interrupt(psi_watch_t* pw) {
+    char c = 0;
+    if (pw->wake_pipe[1] >= 0) {
+        ssize_t n = write(pw->wake_pipe[1], &c, 1);
+        (void)n;
+    }
+}
+
+int psi_watch_sample_at(psi_watch_t* pw, uint64_t now_ns) {
+    double elapsed_us = pw->last_ns && now_ns > pw->last_ns ? (now_ns - pw->last_ns) / 1e3 : 0;
+    int read_count = 0;
+    for (int r = 0; r < PSI_RESOURCES; r++) {
+        proc_file_t* pf = &pw->files[r];
+        proc_psi_t cur;
+        if (proc_file_read(pf) < 0 || proc_parse_psi(pf->buf, pf->len, &cur) != 0) continue;
+        const proc_psi_t* prev = &pw->psi[r];
+        if (pw->has_sample && elapsed_us > 0) {
+            // Totals only grow; a smaller value means the file was swapped
+            uint64_t some = cur.some.total >= prev->some.total ? cur.some.total - prev->some.total : 0;
+            uint64_t full = cur.full.total >= prev->full.total ? cur.full.total - prev->full.total : 0;
+            pw->some_pct[r] = (float)(some * 100.0 / elapsed_us);
+            pw->full_pct[r] = (float)(full * 100.0 / elapsed_us);
+        }
+        pw->psi[r] = cur;
+        read_count++;
+    }
+    if (read_count == 0) return -1;
+    pw->has_sample = 1;
+    pw->last_ns = now_ns;
+    return read_count;
+}
+
+int psi_watch_sample(psi_watch_t* pw) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return psi_watch_sample_at(pw, (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec);
+}
+
+int format_psi_watch(const psi_watch_t* pw, char* buf, size_t size) {
+    int len = proc_append(buf, size, 0, "%-7s %-25s  %-25s\n",
+                          "", " some avg10/60/300    now", " full avg10/60/300    now");
+    for (int r = 0; r < PSI_RESOURCES; r++) {
+        if (pw->files[r].fd < 0) continue;
+        const proc_psi_t* p = &pw->psi[r];
+        len = proc_append(buf, size, len, "%-7s %5.2f %5.2f %5.2f %6.2f%%", resource_names[r],
+                          p->some.avg10, p->some.avg60, p->some.avg300, pw->some_pct[r]);
+        if (p->has_full) {
+            len = proc_append(buf, size, len, "  %5.2f %5.2f %5.2f %6.2f%%\n",
+                              p->full.avg10, p->full.avg60, p->full.avg300, pw->full_pct[r]);
+        } else {
+            len = proc_append(buf, size, len, "  %25s\n", "-");
+        }
+    }
+    for (int i = 0; i < pw->trigger_count; i++) {
+        const psi_trigger_t* t = &pw->triggers[i];
+        len = proc_append(buf, size, len, "trigger %s %s %uus/%uus: %lu events%s\n",
+                          resource_names[t->resource], t->full ? "full" : "some",
+                          t->stall_us, t->window_us, t->events, t->fd < 0 ? " (closed)" : "");
+    }
+    return len;
+}
+
+void psi_watch_free(psi_watch_t* pw) {
+    for (int r = 0; r < PSI_RESOURCES; r++) {
+        if (pw->files[r].buf || pw->files[r].fd >= 0) proc_file_close(&pw->files[r]);
+    }
+    for (int i = 0; i < pw->trigger_count; i++) {
+        if (pw->triggers[i].fd >= 0) close(pw->triggers[i].fd);
+    }
+    for (int i = 0; i < 2; i++) {
+        if (pw->wake_pipe[i] >= 0) close(pw->wake_pipe[i]);
+    }
+    memset(pw, 0, sizeof(*pw));
+    pw->wake_pipe[0] = pw->wake_pipe[1] = -1;
+}
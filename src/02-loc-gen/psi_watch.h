@@ -0,0 +1,72 @@
+#ifndef PSI_WATCH_H
+#define PSI_WATCH_H
+
+#include <stdint.h>
+#include "proc_parse.h"
+#include "proc_reader.h"
+
+#define PSI_DEFAULT_ROOT "/proc/pressure"
+#define PSI_MAX_TRIGGERS 8
+
+// Kernel limits for a trigger. Without CAP_SYS_RESOURCE the window must
+// also be a multiple of 2s.
+#define PSI_MIN_WINDOW_US 500000
+#define PSI_MAX_WINDOW_US 10000000
+#define PSI_DEFAULT_STALL_US 150000
+#define PSI_DEFAULT_WINDOW_US 2000000
+
+typedef enum {
+    PSI_CPU = 0,
+    PSI_MEMORY,
+    PSI_IO,
+    PSI_RESOURCES
+} psi_resource_t;
+
+#define PSI_BIT(r) (1u << (r))
+
+// A registered threshold: the kernel marks the fd POLLPRI at most once per
+// window when stalls within the window exceed stall_us
+typedef struct {
+    int fd;
+    psi_resource_t resource;
+    int full;                   // "full" rather than "some" stalls
+    uint32_t stall_us;
+    uint32_t window_us;
+    unsigned long events;
+} psi_trigger_t;
+
+typedef struct {
+    char root[64];
+    proc_file_t files[PSI_RESOURCES];   // fd < 0 where the kernel lacks the file
+    proc_psi_t psi[PSI_RESOURCES];
+    int has_sample;
+    uint64_t last_ns;
+    // Share of the last interval with stalled tasks, from the total= deltas
+    float some_pct[PSI_RESOURCES];
+    float full_pct[PSI_RESOURCES];
+    psi_trigger_t triggers[PSI_MAX_TRIGGERS];
+    int trigger_count;
+    int wake_pipe[2];           // psi_watch_interrupt() writes here
+    unsigned long events;       // trigger events across all triggers
+} psi_watch_t;
+
+int psi_watch_init(psi_watch_t* pw, const char* root);
+// Register "some|full <stall_us> <window_us>" on a resource; -1 with errno
+// set if the kernel refuses it
+int psi_watch_add_trigger(psi_watch_t* pw, psi_resource_t resource, int full,
+                          uint32_t stall_us, uint32_t window_us);
+// Sleep in poll() until a trigger fires, psi_watch_interrupt() is called or
+// timeout_ms passes (-1 waits forever). Returns PSI_BIT()s of the resources
+// that fired, 0 on timeout or interrupt, -1 on error.
+int psi_watch_wait(psi_watch_t* pw, int timeout_ms);
+// Wake a thread blocked in psi_watch_wait(); async-signal-safe
+void psi_watch_interrupt(psi_watch_t* pw);
+// Read every pressure file; returns the number of resources read or -1
+int psi_watch_sample(psi_watch_t* pw);
+int psi_watch_sample_at(psi_watch_t* pw, uint64_t now_ns);
+const char* psi_resource_name(psi_resource_t resource);
+int psi_resource_from_name(const char* name);
+int format_psi_watch(const psi_watch_t* pw, char* buf, size_t size);
+void psi_watch_free(psi_watch_t* pw);
+
+#endif
@@ -1,53 +1,130 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <unistd.h>
+#include <errno.h>
+#include <time.h>
 #include "room_manager.h"
 #include "data_collector.h"
+#include "cpu_cores.h"
+#include "disk_stats.h"
+#include "net_stats.h"
+#include "sock_stats.h"
+#include "proc_scan.h"
+#include "pid_watch.h"
+#include "cgroup_watch.h"
+#include "psi_watch.h"
+#include "numa_mem.h"
+#include "plugin_registry.h"
+#include "collector_sched.h"
 
 #define MAX_ROOMS 10
+#define PROCESS_SCAN_WORKERS 4
+#define CGROUP_DEFAULT_ROOT "/sys/fs/cgroup"
 
+typedef struct room room_t;
+
+// Hooks for one room type. A built-in type is one row in room_kinds[] at
+// the end of this file; collectors loaded from plugins share plugin_kind.
 typedef struct {
+    const char* name;
+    room_type_t type;
+    int (*init)(room_t* room, const char* target);  // NULL: nothing to set up
+    void (*show)(room_t* room);
+    void (*release)(room_t* room);                  // NULL: nothing to free
+} room_kind_t;
+
+struct room {
     int id;
+    const room_kind_t* kind;
     room_type_t type;
     int interval_ms;
     int running;
-} room_t;
+    int has_sample;         // `last` holds the previous sample for diffs
+    union {
+        cpu_snapshot_t cpu;
+        memory_snapshot_t memory;
+        disk_stats_t disks;
+        net_stats_t net;
+        sock_stats_t sockets;
+        proc_scan_t* procs;     // heap-allocated: its workers hold the address
+        pid_watch_t pid;
+        cgroup_watch_t cgroups;
+        psi_watch_t psi;
+        numa_mem_t numa;
+        cpu_cores_t cores;
+        collector_task_t plugin;
+    } last;
+};
 
 static room_t rooms[MAX_ROOMS];
 static int room_count = 0;
 
-// Chuyển từ chuỗi sang enum
-static int str_to_room_type(const char* type_str) {
-    if (strcmp(type_str, "cpu-room") == 0) return CPU_ROOM;
-    if (strcmp(type_str, "memory-room") == 0) return MEMORY_ROOM;
-    if (strcmp(type_str, "inf-stats-room") == 0) return INF_STATS_ROOM;
-    return -1;
-}
+static const room_kind_t* find_kind(const char* name);
+static const room_kind_t plugin_kind;
 
-int create_room(const char* room_type_str, int interval) {
+static int add_room(const char* type_str, const char* target, int interval) {
     if (room_count >= MAX_ROOMS) {
         printf("Max rooms reached\n");
         return -1;
     }
-    int type = str_to_room_type(room_type_str);
-    if (type == -1) {
-        printf("Invalid room type %s\n", room_type_str);
+    room_t* room = &rooms[room_count];
+    memset(room, 0, sizeof(*room));
+    room->id = room_count;
+    room->interval_ms = interval;
+
+    // Built-in types first, so a plugin cannot shadow them
+    const room_kind_t* kind = find_kind(type_str);
+    const collector_ops_t* ops = kind ? NULL : plugin_find(type_str);
+    if (!kind && !ops) {
+        printf("Invalid room type %s\n", type_str);
         return -1;
     }
-
-    rooms[room_count].id = room_count;
-    rooms[room_count].type = type;
-    rooms[room_count].interval_ms = interval;
-    rooms[room_count].running = 0;
-    printf("Created room id %d type %s interval %dms\n", room_count, room_type_str, interval);
+    if (ops) {
+        kind = &plugin_kind;
+        if (collector_task_init(&room->last.plugin, ops, target, interval) != 0) {
+            printf("Collector %s failed to start\n", type_str);
+            return -1;
+        }
+    } else if (kind->init && kind->init(room, target) != 0) {
+        return -1;
+    }
+    room->kind = kind;
+    room->type = kind->type;
+    if (target) {
+        printf("Created room id %d type %s (%s) interval %dms\n", room_count, type_str, target, interval);
+    } else {
+        printf("Created room id %d type %s interval %dms\n", room_count, type_str, interval);
+    }
     return room_count++;
 }
 
+int create_room(const char* room_type_str, int interval) {
+    return add_room(room_type_str, NULL, interval);
+}
+
+// Rooms aimed at something: a PID or process name, a cgroup path, or
+// whatever a plugin collector takes
+int create_targeted_room(const char* room_type_str, const char* target, int interval) {
+    return add_room(room_type_str, target, interval);
+}
+
+// Watch one process by PID, or by name across restarts
+int create_pid_room(const char* target, int interval) {
+    return add_room("pid-room", target, interval);
+}
+
+// Watch a cgroup v2 subtree, e.g. /sys/fs/cgroup/system.slice
+int create_cgroup_room(const char* root, int interval) {
+    return add_room("cgroup-room", root, interval);
+}
+
 int delete_room(int room_id) {
     if (room_id < 0 || room_id >= room_count) {
         printf("Invalid room id\n");
         return -1;
     }
+    if (rooms[room_id].kind->release) rooms[room_id].kind->release(&rooms[room_id]);
     for (int i = room_id; i < room_count - 1; i++) {
         rooms[i] = rooms[i + 1];
         rooms[i].id = i;
@@ -85,6 +162,256 @@ int stop_monitoring(int room_id) {
     return 0;
 }
 
+static void show_cpu_room(room_t* room) {
+    static cpu_snapshot_t cur;
+    char buf[8192];
+    if (collect_cpu_stats(&cur) != 0) return;
+    format_cpu_snapshot(&cur, buf, sizeof(buf));
+    printf("CPU stats:\n%s", buf);
+    if (room->has_sample) {
+        printf("CPU busy since last sample: %.2f%%\n", cpu_busy_percent(&room->last.cpu, &cur, -1));
+    }
+    room->last.cpu = cur;
+    room->has_sample = 1;
+}
+
+static void show_memory_room(room_t* room) {
+    memory_snapshot_t cur;
+    char buf[1024];
+    if (collect_memory_stats(&cur) != 0) return;
+    format_memory_snapshot(&cur, buf, sizeof(buf));
+    printf("Memory stats:\n%s", buf);
+    room->last.memory = cur;
+    room->has_sample = 1;
+}
+
+static void show_io_room(room_t* room) {
+    disk_stats_t* disks = &room->last.disks;
+    int n = disk_stats_sample(disks);
+    if (n < 0) return;
+    if (n == 0 && !room->has_sample) {
+        printf("Tracking %zu devices; rates available from the next sample\n", disks->used);
+    } else {
+        int len = format_disk_rates(disks, NULL, 0);
+        char* buf = malloc((size_t)len + 1);
+        if (!buf) return;
+        format_disk_rates(disks, buf, (size_t)len + 1);
+        printf("IO rates since last sample:\n%s", buf);
+        free(buf);
+    }
+    room->has_sample = 1;
+}
+
+// Restrict an inf-stats room to devices matching `include` and not `exclude`
+// (comma-separated globs). Resets the room's device table.
+int set_room_disk_filter(int room_id, const char* include, const char* exclude) {
+    if (room_id < 0 || room_id >= room_count || rooms[room_id].type != INF_STATS_ROOM) {
+        return -1;
+    }
+    room_t* room = &rooms[room_id];
+    disk_stats_free(&room->last.disks);
+    room->has_sample = 0;
+    return disk_stats_init(&room->last.disks, include, exclude);
+}
+
+static void show_net_room(room_t* room) {
+    net_stats_t* net = &room->last.net;
+    int n = net_stats_sample(net);
+    if (n < 0) return;
+    const char* source = net->source == NET_SOURCE_NETLINK ? "rtnetlink" : "/proc/net/dev";
+    if (!room->has_sample) {
+        printf("Tracking %zu interfaces via %s; rates available from the next sample\n",
+               net->used, source);
+    } else {
+        int len = format_net_rates(net, NULL, 0);
+        char* buf = malloc((size_t)len + 1);
+        if (!buf) return;
+        format_net_rates(net, buf, (size_t)len + 1);
+        printf("Network rates since last sample (%s):\n%s", source, buf);
+        free(buf);
+        if (net->added || net->removed) {
+            printf("Interfaces: %d added, %d removed\n", net->added, net->removed);
+        }
+    }
+    room->has_sample = 1;
+}
+
+static void show_sock_room(room_t* room) {
+    sock_stats_t* sockets = &room->last.sockets;
+    if (sock_stats_collect(sockets, sockets->source) < 0) return;
+    int len = format_sock_stats(sockets, NULL, 0);
+    if (len < 0) return;
+    char* buf = malloc((size_t)len + 1);
+    if (!buf) return;
+    format_sock_stats(sockets, buf, (size_t)len + 1);
+    printf("Sockets (%s):\n%s", sockets->source == SOCK_SOURCE_DIAG ? "sock_diag" : "/proc/net", buf);
+    free(buf);
+    room->has_sample = 1;
+}
+
+// Count only the TCP states in `state_mask` (SOCK_STATE_BIT()s; 0 for all).
+// The filter is applied by the kernel when sock_diag is available.
+int set_room_sock_states(int room_id, unsigned state_mask) {
+    if (room_id < 0 || room_id >= room_count || rooms[room_id].type != SOCK_ROOM) {
+        return -1;
+    }
+    sock_stats_t* sockets = &rooms[room_id].last.sockets;
+    sockets->state_mask = state_mask ? (state_mask & SOCK_ALL_STATES) : SOCK_ALL_STATES;
+    return 0;
+}
+
+static void show_pid_room(room_t* room) {
+    pid_watch_t* pw = &room->last.pid;
+    char buf[512];
+    if (pid_watch_sample(pw) < 0) return;
+    format_pid_watch(pw, buf, sizeof(buf));
+    printf("%s", buf);
+    room->has_sample = 1;
+}
+
+#define TOP_CGROUPS 10
+
+static void show_cgroup_room(room_t* room) {
+    cgroup_watch_t* cw = &room->last.cgroups;
+    if (cgroup_watch_sample(cw) < 0) return;
+    int len = format_cgroup_watch(cw, TOP_CGROUPS, NULL, 0);
+    if (len < 0) return;
+    char* buf = malloc((size_t)len + 1);
+    if (!buf) return;
+    format_cgroup_watch(cw, TOP_CGROUPS, buf, (size_t)len + 1);
+    printf("%s", buf);
+    if (!room->has_sample) printf("Rates available from the next sample\n");
+    free(buf);
+    room->has_sample = 1;
+}
+
+static void show_psi_room(room_t* room) {
+    psi_watch_t* psi = &room->last.psi;
+    // Collect trigger events raised since the last show without blocking
+    psi_watch_wait(psi, 0);
+    if (psi_watch_sample(psi) < 0) return;
+    int len = format_psi_watch(psi, NULL, 0);
+    if (len < 0) return;
+    char* buf = malloc((size_t)len + 1);
+    if (!buf) return;
+    format_psi_watch(psi, buf, (size_t)len + 1);
+    printf("%s", buf);
+    free(buf);
+    room->has_sample = 1;
+}
+
+static void show_numa_room(room_t* room) {
+    numa_mem_t* numa = &room->last.numa;
+    if (numa_mem_sample(numa) < 0) return;
+    int len = format_numa_mem(numa, NULL, 0);
+    if (len < 0) return;
+    char* buf = malloc((size_t)len + 1);
+    if (!buf) return;
+    format_numa_mem(numa, buf, (size_t)len + 1);
+    printf("%s", buf);
+    if (!room->has_sample) printf("Allocation rates available from the next sample\n");
+    free(buf);
+    room->has_sample = 1;
+}
+
+// Block until one of a PSI room's triggers fires or timeout_ms passes;
+// returns PSI_BIT()s of the stalled resources
+int wait_room_pressure(int room_id, int timeout_ms) {
+    if (room_id < 0 || room_id >= room_count || rooms[room_id].type != PSI_ROOM) {
+        return -1;
+    }
+    return psi_watch_wait(&rooms[room_id].last.psi, timeout_ms);
+}
+
+#define TOP_PROCESSES 10
+
+static int print_top_processes(const proc_scan_t* procs, int by, int n) {
+    const proc_task_t** top = malloc(sizeof(*top) * (size_t)n);
+    if (!top) return -1;
+    n = proc_scan_top(procs, by, n, top);
+    long page_kb = sysconf(_SC_PAGESIZE) / 1024;
+    printf("%7s %-16s %c %7s %10s\n", "PID", "COMMAND", 'S', "CPU%", "RSS(kB)");
+    for (int i = 0; i < n; i++) {
+        printf("%7d %-16s %c %7.1f %10llu\n", top[i]->pid, top[i]->comm, top[i]->state,
+               top[i]->cpu_pct, (unsigned long long)(top[i]->rss_pages * page_kb));
+    }
+    free(top);
+    return n;
+}
+
+static void show_process_room(room_t* room) {
+    proc_scan_t* procs = room->last.procs;
+    int count = proc_scan_tick(procs);
+    if (count < 0) return;
+    printf("Processes: %d, threads: %llu\n", count, (unsigned long long)procs->total_threads);
+    if (!room->has_sample) {
+        printf("CPU%% per process available from the next sample\n");
+        room->has_sample = 1;
+        return;
+    }
+
+    print_top_processes(procs, PROC_SCAN_BY_CPU, TOP_PROCESSES);
+}
+
+// Take a sample without printing; only process rooms keep state worth refreshing
+int refresh_room(int room_id) {
+    if (room_id < 0 || room_id >= room_count) return -1;
+    room_t* room = &rooms[room_id];
+    if (room->type != PROCESS_ROOM) return 0;
+    if (proc_scan_tick(room->last.procs) < 0) return -1;
+    room->has_sample = 1;
+    return 0;
+}
+
+// "show top-cpu N" / "show top-mem N": read the ranking kept by the scanner
+int show_room_top(int room_id, const char* metric, int n) {
+    if (room_id < 0 || room_id >= room_count || rooms[room_id].type != PROCESS_ROOM || n <= 0) {
+        printf("Invalid process room or count\n");
+        return -1;
+    }
+    int by;
+    if (strcmp(metric, "top-cpu") == 0) {
+        by = PROC_SCAN_BY_CPU;
+    } else if (strcmp(metric, "top-mem") == 0) {
+        by = PROC_SCAN_BY_MEM;
+    } else {
+        printf("Unknown ranking %s\n", metric);
+        return -1;
+    }
+    return print_top_processes(rooms[room_id].last.procs, by, n);
+}
+
+#define TOP_CORES 5
+
+static void show_cpu_core_room(room_t* room) {
+    static cpu_snapshot_t cur;
+    if (collect_cpu_stats(&cur) != 0) return;
+    cpu_cores_t* cores = &room->last.cores;
+    if (cpu_cores_update(cores, &cur) == 0) {
+        printf("Tracking %d cores; utilisation available from the next sample\n", cores->count);
+        return;
+    }
+
+    int ids[TOP_CORES];
+    float utils[TOP_CORES];
+    int n = cpu_cores_top(cores, TOP_CORES, ids, utils);
+    printf("Busiest cores:");
+    for (int i = 0; i < n; i++) printf(" cpu%d %.1f%%", ids[i], utils[i]);
+    printf("\nPer-core utilisation:\n");
+    for (int i = 0; i < cores->count; i++) {
+        printf("cpu%-4d %5.1f%%%s", cores->cpu_id[i], cores->util[i], (i % 8 == 7) ? "\n" : "  ");
+    }
+    if (cores->count % 8) printf("\n");
+}
+
+// Busiest cores as of the room's last sample, without reading /proc/stat
+int room_top_cores(int room_id, int k, int* cpu_ids, float* utils) {
+    if (room_id < 0 || room_id >= room_count || rooms[room_id].type != CPU_CORE_ROOM) {
+        return -1;
+    }
+    return cpu_cores_top(&rooms[room_id].last.cores, k, cpu_ids, utils);
+}
+
 void show_room_data(int room_id) {
     if (room_id < 0 || room_id >= room_count) {
         printf("Invalid room id\n");
@@ -92,17 +419,195 @@ void show_room_data(int room_id) {
     }
     room_t* room = &rooms[room_id];
     printf("Displaying data for room id %d\n", room->id);
-    switch(room->type) {
-        case CPU_ROOM:
-            read_cpu_stats();
-            break;
-        case MEMORY_ROOM:
-            read_memory_stats();
-            break;
-        case INF_STATS_ROOM:
-            read_io_stats();
-            break;
-        default:
-            printf("Unknown room type\n");
+    room->kind->show(room);
+}
+
+static void show_plugin_room(room_t* room) {
+    collector_task_t* task = &room->last.plugin;
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    if (collector_task_sample(task, (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec) != 0) {
+        printf("Collector %s failed to sample\n", task->ops->name);
+        return;
+    }
+    int len = collector_task_format(task, NULL, 0);
+    if (len < 0) return;
+    char* buf = malloc((size_t)len + 1);
+    if (!buf) return;
+    collector_task_format(task, buf, (size_t)len + 1);
+    printf("%s", buf);
+    if (!task->has_rates) printf("Rates available from the next sample\n");
+    free(buf);
+    room->has_sample = 1;
+}
+
+static void release_plugin_room(room_t* room) {
+    collector_task_free(&room->last.plugin);
+}
+
+static int init_cpu_core_room(room_t* room, const char* target) {
+    (void)target;
+    cpu_cores_init(&room->last.cores);
+    return 0;
+}
+
+static int init_io_room(room_t* room, const char* target) {
+    (void)target;
+    if (disk_stats_init(&room->last.disks, NULL, NULL) != 0) {
+        printf("Cannot allocate device table\n");
+        return -1;
+    }
+    return 0;
+}
+
+static void release_io_room(room_t* room) {
+    disk_stats_free(&room->last.disks);
+}
+
+static int init_net_room(room_t* room, const char* target) {
+    (void)target;
+    if (net_stats_init(&room->last.net) != 0) {
+        printf("Cannot allocate interface table\n");
+        return -1;
+    }
+    return 0;
+}
+
+static void release_net_room(room_t* room) {
+    net_stats_free(&room->last.net);
+}
+
+static int init_sock_room(room_t* room, const char* target) {
+    (void)target;
+    if (sock_stats_init(&room->last.sockets, 0) != 0) {
+        printf("Cannot allocate port table\n");
+        return -1;
+    }
+    return 0;
+}
+
+static void release_sock_room(room_t* room) {
+    sock_stats_free(&room->last.sockets);
+}
+
+static int init_process_room(room_t* room, const char* target) {
+    (void)target;
+    long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    int workers = cpus > PROCESS_SCAN_WORKERS ? PROCESS_SCAN_WORKERS : (int)cpus - 1;
+    proc_scan_t* procs = malloc(sizeof(proc_scan_t));
+    if (!procs || proc_scan_init(procs, "/proc", workers) != 0) {
+        free(procs);
+        printf("Cannot start process scanner\n");
+        return -1;
+    }
+    room->last.procs = procs;
+    return 0;
+}
+
+static void release_process_room(room_t* room) {
+    proc_scan_free(room->last.procs);
+    free(room->last.procs);
+}
+
+static int init_pid_room(room_t* room, const char* target) {
+    if (!target) {
+        printf("pid-room needs a target: create pid-room <pid|name> <interval_ms>\n");
+        return -1;
+    }
+    if (pid_watch_init(&room->last.pid, target) != 0) {
+        printf("Cannot watch %s\n", target);
+        return -1;
+    }
+    return 0;
+}
+
+static void release_pid_room(room_t* room) {
+    pid_watch_free(&room->last.pid);
+}
+
+static int init_cgroup_room(room_t* room, const char* target) {
+    const char* root = target ? target : CGROUP_DEFAULT_ROOT;
+    if (cgroup_watch_init(&room->last.cgroups, root) != 0) {
+        printf("Cannot watch %s\n", root);
+        return -1;
+    }
+    printf("Watching %d cgroups under %s\n", room->last.cgroups.count, root);
+    return 0;
+}
+
+static void release_cgroup_room(room_t* room) {
+    cgroup_watch_free(&room->last.cgroups);
+}
+
+static int init_psi_room(room_t* room, const char* target) {
+    (void)target;
+    psi_watch_t* psi = &room->last.psi;
+    if (psi_watch_init(psi, PSI_DEFAULT_ROOT) != 0) {
+        printf("Pressure stall information not available\n");
+        return -1;
+    }
+    // Triggers are optional: the averages are readable without them
+    for (int r = 0; r < PSI_RESOURCES; r++) {
+        if (psi_watch_add_trigger(psi, r, 0, PSI_DEFAULT_STALL_US, PSI_DEFAULT_WINDOW_US) != 0) {
+            printf("No %s stall trigger: %s\n", psi_resource_name(r), strerror(errno));
+        }
+    }
+    return 0;
+}
+
+static void release_psi_room(room_t* room) {
+    psi_watch_free(&room->last.psi);
+}
+
+static int init_numa_room(room_t* room, const char* target) {
+    (void)target;
+    if (numa_mem_init(&room->last.numa, NUMA_SYSFS_ROOT) < 0) {
+        printf("No NUMA nodes under %s\n", NUMA_SYSFS_ROOT);
+        return -1;
+    }
+    return 0;
+}
+
+static void release_numa_room(room_t* room) {
+    numa_mem_free(&room->last.numa);
+}
+
+static const room_kind_t room_kinds[] = {
+    { "cpu-room", CPU_ROOM, NULL, show_cpu_room, NULL },
+    { "memory-room", MEMORY_ROOM, NULL, show_memory_room, NULL },
+    { "inf-stats-room", INF_STATS_ROOM, init_io_room, show_io_room, release_io_room },
+    { "cpu-core-room", CPU_CORE_ROOM, init_cpu_core_room, show_cpu_core_room, NULL },
+    { "net-room", NET_ROOM, init_net_room, show_net_room, release_net_room },
+    { "sock-room", SOCK_ROOM, init_sock_room, show_sock_room, release_sock_room },
+    { "process-room", PROCESS_ROOM, init_process_room, show_process_room, release_process_room },
+    { "pid-room", PID_ROOM, init_pid_room, show_pid_room, release_pid_room },
+    { "cgroup-room", CGROUP_ROOM, init_cgroup_room, show_cgroup_room, release_cgroup_room },
+    { "psi-room", PSI_ROOM, init_psi_room, show_psi_room, release_psi_room },
+    { "numa-room", NUMA_ROOM, init_numa_room, show_numa_room, release_numa_room },
+};
+
+static const room_kind_t plugin_kind = {
+    "plugin", PLUGIN_ROOM, NULL, show_plugin_room, release_plugin_room
+};
+
+static const room_kind_t* find_kind(const char* name) {
+    for (size_t i = 0; i < sizeof(room_kinds) / sizeof(room_kinds[0]); i++) {
+        if (strcmp(room_kinds[i].name, name) == 0) return &room_kinds[i];
+    }
+    return NULL;
+}
+
+// Built-in room types, then those registered by plugins with their metrics
+void list_room_types(void) {
+    for (size_t i = 0; i < sizeof(room_kinds) / sizeof(room_kinds[0]); i++) {
+        printf("%s\n", room_kinds[i].name);
+    }
+    for (int i = 0; i < plugin_count(); i++) {
+        const collector_ops_t* ops = plugin_at(i);
+        printf("%s (plugin, %dms):", ops->name, ops->interval_ms);
+        for (int m = 0; m < ops->metric_count; m++) {
+            printf(" %s%s", ops->metrics[m].name, ops->metrics[m].kind == METRIC_COUNTER ? "/s" : "");
+        }
+        printf("\n");
     }
 }
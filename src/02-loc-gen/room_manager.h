@@ -4,13 +4,32 @@
 typedef enum {
     CPU_ROOM,
     MEMORY_ROOM,
-    INF_STATS_ROOM
+    INF_STATS_ROOM,
+    CPU_CORE_ROOM,
+    NET_ROOM,
+    SOCK_ROOM,
+    PROCESS_ROOM,
+    PID_ROOM,
+    CGROUP_ROOM,
+    PSI_ROOM,
+    NUMA_ROOM,
+    PLUGIN_ROOM             // any collector registered through plugin_registry
 } room_type_t;
 
 int create_room(const char* room_type_str, int interval);
+int create_targeted_room(const char* room_type_str, const char* target, int interval);
+int create_pid_room(const char* target, int interval);
+int create_cgroup_room(const char* root, int interval);
 int delete_room(int room_id);
 int start_monitoring(int room_id);
 int stop_monitoring(int room_id);
 void show_room_data(int room_id);
+int room_top_cores(int room_id, int k, int* cpu_ids, float* utils);
+int set_room_disk_filter(int room_id, const char* include, const char* exclude);
+int set_room_sock_states(int room_id, unsigned state_mask);
+int refresh_room(int room_id);
+int show_room_top(int room_id, const char* metric, int n);
+int wait_room_pressure(int room_id, int timeout_ms);
+void list_room_types(void);
 
 #endif // ROOM_MANAGER_H
@@ -0,0 +1,292 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <errno.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <linux/netlink.h>
+#include <linux/sock_diag.h>
+#include <linux/inet_diag.h>
+#include "sock_stats.h"
+#include "proc_parse.h"
+
+#define SOCK_DIAG_BUF_SIZE 65536
+#define SOCK_TOP_PORTS 5
+
+static const char* tcp_state_names[SOCK_TCP_MAX_STATES] = {
+    "UNKNOWN", "ESTABLISHED", "SYN_SENT", "SYN_RECV", "FIN_WAIT1", "FIN_WAIT2",
+    "TIME_WAIT", "CLOSE", "CLOSE_WAIT", "LAST_ACK", "LISTEN", "CLOSING", "NEW_SYN_RECV"
+};
+
+static const char* proc_names[4] = { "tcp", "tcp6", "udp", "udp6" };
+
+const char* sock_tcp_state_name(int state) {
+    if (state < 0 || state >= SOCK_TCP_MAX_STATES) return "UNKNOWN";
+    return tcp_state_names[state];
+}
+
+static int open_diag(sock_stats_t* ss) {
+    int fd = socket(AF_NETLINK, SOCK_RAW | SOCK_CLOEXEC, NETLINK_SOCK_DIAG);
+    if (fd < 0) return -1;
+    ss->diag_buf = malloc(SOCK_DIAG_BUF_SIZE);
+    if (!ss->diag_buf) {
+        close(fd);
+        return -1;
+    }
+    ss->diag_fd = fd;
+    return 0;
+}
+
+int sock_stats_init(sock_stats_t* ss, uint32_t state_mask) {
+    memset(ss, 0, sizeof(*ss));
+    ss->diag_fd = -1;
+    for (int i = 0; i < 4; i++) ss->files[i].fd = -1;
+    strcpy(ss->proc_root, "/proc/net");
+    ss->state_mask = state_mask ? (state_mask & SOCK_ALL_STATES) : SOCK_ALL_STATES;
+    for (int p = 0; p < 2; p++) {
+        ss->ports[p].count = calloc(SOCK_PORTS, sizeof(uint32_t));
+        ss->ports[p].touched = malloc(SOCK_PORTS * sizeof(uint16_t));
+        if (!ss->ports[p].count || !ss->ports[p].touched) {
+            sock_stats_free(ss);
+            return -1;
+        }
+    }
+    ss->source = open_diag(ss) == 0 ? SOCK_SOURCE_DIAG : SOCK_SOURCE_PROCFS;
+    return 0;
+}
+
+int sock_stats_set_proc_root(sock_stats_t* ss, const char* root) {
+    if (strlen(root) >= sizeof(ss->proc_root)) return -1;
+    for (int i = 0; i < 4; i++) {
+        if (ss->files[i].buf) proc_file_close(&ss->files[i]);
+    }
+    strcpy(ss->proc_root, root);
+    return 0;
+}
+
+void sock_stats_reset(sock_stats_t* ss) {
+    memset(ss->tcp_states, 0, sizeof(ss->tcp_states));
+    for (int p = 0; p < 2; p++) {
+        sock_ports_t* ports = &ss->ports[p];
+        for (uint32_t i = 0; i < ports->touched_count; i++) ports->count[ports->touched[i]] = 0;
+        ports->touched_count = 0;
+        ports->total = 0;
+    }
+}
+
+static void count_socket(sock_stats_t* ss, int proto, int state, uint16_t port) {
+    sock_ports_t* ports = &ss->ports[proto];
+    if (ports->count[port]++ == 0) ports->touched[ports->touched_count++] = port;
+    ports->total++;
+    if (proto == SOCK_PROTO_TCP) ss->tcp_states[state]++;
+}
+
+// One SOCK_DIAG_BY_FAMILY dump; the kernel drops sockets outside `states`
+static int diag_dump(sock_stats_t* ss, int family, int proto, uint32_t states) {
+    struct {
+        struct nlmsghdr nh;
+        struct inet_diag_req_v2 req;
+    } msg;
+    memset(&msg, 0, sizeof(msg));
+    msg.nh.nlmsg_len = sizeof(msg);
+    msg.nh.nlmsg_type = SOCK_DIAG_BY_FAMILY;
+    msg.nh.nlmsg_flags = NLM_F_REQUEST | NLM_F_DUMP;
+    msg.nh.nlmsg_seq = ++ss->diag_seq;
+    msg.req.sdiag_family = (uint8_t)family;
+    msg.req.sdiag_protocol = proto == SOCK_PROTO_TCP ? IPPROTO_TCP : IPPROTO_UDP;
+    msg.req.idiag_states = states;
+
+    struct sockaddr_nl kernel;
+    memset(&kernel, 0, sizeof(kernel));
+    kernel.nl_family = AF_NETLINK;
+    if (sendto(ss->diag_fd, &msg, sizeof(msg), 0, (struct sockaddr*)&kernel, sizeof(kernel)) < 0) {
+        return -1;
+    }
+
+    int counted = 0;
+    for (;;) {
+        ssize_t n = recv(ss->diag_fd, ss->diag_buf, SOCK_DIAG_BUF_SIZE, 0);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            return -1;
+        }
+        int len = (int)n;
+        for (struct nlmsghdr* nh = (struct nlmsghdr*)ss->diag_buf; NLMSG_OK(nh, len);
+             nh = NLMSG_NEXT(nh, len)) {
+            if (nh->nlmsg_seq != ss->diag_seq) continue;
+            if (nh->nlmsg_type == NLMSG_DONE) return counted;
+            if (nh->nlmsg_type == NLMSG_ERROR) {
+                // No IPv6 or no UDP diag module: nothing to count
+                struct nlmsgerr* err = NLMSG_DATA(nh);
+                return err->error == -ENOENT ? counted : -1;
+            }
+            if (nh->nlmsg_len < NLMSG_LENGTH(sizeof(struct inet_diag_msg))) continue;
+            struct inet_diag_msg* diag = NLMSG_DATA(nh);
+            int state = diag->idiag_state < SOCK_TCP_MAX_STATES ? diag->idiag_state : 0;
+            count_socket(ss, proto, state, ntohs(diag->id.idiag_sport));
+            counted++;
+        }
+    }
+}
+
+static int collect_diag(sock_stats_t* ss) {
+    static const int families[2] = { AF_INET, AF_INET6 };
+    int total = 0;
+    for (int proto = 0; proto < 2; proto++) {
+        uint32_t states = proto == SOCK_PROTO_TCP ? ss->state_mask : SOCK_ALL_STATES;
+        for (int f = 0; f < 2; f++) {
+            int n = diag_dump(ss, families[f], proto, states);
+            if (n < 0) return -1;
+            total += n;
+        }
+    }
+    return total;
+}
+
+static int hex_value(char c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    return -1;
+}
+
+// "  12: 0100007F:1F90 00000000:0000 0A ..." -> local port, state
+static int parse_socket_line(const char* p, const char* eol, uint16_t* port, int* state) {
+    const char* colon = memchr(p, ':', (size_t)(eol - p));
+    if (!colon) return -1;
+    p = colon + 1;
+    while (p < eol && *p == ' ') p++;
+    // Local address is 8 or 32 hex digits followed by ':' and a 4-digit port
+    const char* sep = memchr(p, ':', (size_t)(eol - p));
+    if (!sep || eol - sep < 5) return -1;
+    unsigned value = 0;
+    for (int i = 1; i <= 4; i++) {
+        int h = hex_value(sep[i]);
+        if (h < 0) return -1;
+        value = value << 4 | (unsigned)h;
+    }
+    p = sep + 5;
+    while (p < eol && *p == ' ') p++;
+    while (p < eol && *p != ' ') p++;    // remote address
+    while (p < eol && *p == ' ') p++;
+    if (eol - p < 2) return -1;
+    int hi = hex_value(p[0]), lo = hex_value(p[1]);
+    if (hi < 0 || lo < 0) return -1;
+    *port = (uint16_t)value;
+    *state = hi << 4 | lo;
+    return 0;
+}
+
+int sock_stats_parse_proc(sock_stats_t* ss, const char* buf, size_t len, int proto) {
+    const char* p = buf;
+    const char* end = buf + len;
+    int counted = 0;
+
+    // Skip the header line
+    p = proc_find_newline(p, end) + 1;
+    while (p < end) {
+        const char* eol = proc_find_newline(p, end);
+        uint16_t port;
+        int state;
+        if (parse_socket_line(p, eol, &port, &state) != 0) return -1;
+        if (state >= SOCK_TCP_MAX_STATES) state = 0;
+        if (proto == SOCK_PROTO_UDP || (ss->state_mask & SOCK_STATE_BIT(state))) {
+            count_socket(ss, proto, state, port);
+            counted++;
+        }
+        p = eol + 1;
+    }
+    return counted;
+}
+
+static int collect_procfs(sock_stats_t* ss) {
+    int total = 0;
+    for (int i = 0; i < 4; i++) {
+        proc_file_t* file = &ss->files[i];
+        if (!file->buf) {
+            char path[sizeof(ss->proc_root) + 8];
+            snprintf(path, sizeof(path), "%s/%s", ss->proc_root, proc_names[i]);
+            if (proc_file_open_paged(file, path) != 0) return -1;
+        }
+        if (proc_file_read(file) < 0) {
+            // Kernels built without IPv6 have no tcp6/udp6
+            if (i % 2 == 1 && errno == ENOENT) continue;
+            return -1;
+        }
+        int n = sock_stats_parse_proc(ss, file->buf, file->len, i < 2 ? SOCK_PROTO_TCP : SOCK_PROTO_UDP);
+        if (n < 0) return -1;
+        total += n;
+    }
+    return total;
+}
+
+int sock_stats_collect(sock_stats_t* ss, int source) {
+    sock_stats_reset(ss);
+    if (source == SOCK_SOURCE_DIAG) {
+        if (ss->diag_fd < 0) return -1;
+        int n = collect_diag(ss);
+        if (n >= 0) return n;
+        fprintf(stderr, "sock_diag dump failed, using /proc/net\n");
+        ss->source = SOCK_SOURCE_PROCFS;
+        sock_stats_reset(ss);
+    }
+    return collect_procfs(ss);
+}
+
+int sock_stats_top_ports(const sock_stats_t* ss, int proto, int k, uint16_t* ports, uint32_t* counts) {
+    const sock_ports_t* p = &ss->ports[proto];
+    int n = 0;
+    for (uint32_t i = 0; i < p->touched_count; i++) {
+        uint16_t port = p->touched[i];
+        uint32_t c = p->count[port];
+        if (n == k && (k == 0 || c <= counts[n - 1])) continue;
+        // Insertion into the small sorted result
+        int j = n < k ? n++ : n - 1;
+        while (j > 0 && counts[j - 1] < c) {
+            ports[j] = ports[j - 1];
+            counts[j] = counts[j - 1];
+            j--;
+        }
+        ports[j] = port;
+        counts[j] = c;
+    }
+    return n;
+}
+
+int format_sock_stats(const sock_stats_t* ss, char* buf, size_t size) {
+    int len = proc_append(buf, size, 0, "TCP sockets: %u\n", ss->ports[SOCK_PROTO_TCP].total);
+    for (int s = 1; s < SOCK_TCP_MAX_STATES; s++) {
+        if (!ss->tcp_states[s]) continue;
+        len = proc_append(buf, size, len, "  %-12s %u\n", tcp_state_names[s], ss->tcp_states[s]);
+    }
+    len = proc_append(buf, size, len, "UDP sockets: %u\n", ss->ports[SOCK_PROTO_UDP].total);
+
+    uint16_t ports[SOCK_TOP_PORTS];
+    uint32_t counts[SOCK_TOP_PORTS];
+    for (int proto = 0; proto < 2; proto++) {
+        int n = sock_stats_top_ports(ss, proto, SOCK_TOP_PORTS, ports, counts);
+        if (n == 0) continue;
+        len = proc_append(buf, size, len, "Busiest %s ports:", proto == SOCK_PROTO_TCP ? "TCP" : "UDP");
+        for (int i = 0; i < n; i++) {
+            len = proc_append(buf, size, len, " %u(%u)", ports[i], counts[i]);
+        }
+        len = proc_append(buf, size, len, "\n");
+    }
+    return len;
+}
+
+void sock_stats_free(sock_stats_t* ss) {
+    for (int p = 0; p < 2; p++) {
+        free(ss->ports[p].count);
+        free(ss->ports[p].touched);
+    }
+    free(ss->diag_buf);
+    if (ss->diag_fd >= 0) close(ss->diag_fd);
+    for (int i = 0; i < 4; i++) {
+        if (ss->files[i].buf) proc_file_close(&ss->files[i]);
+    }
+    memset(ss, 0, sizeof(*ss));
+    ss->diag_fd = -1;
+    for (int i = 0; i < 4; i++) ss->files[i].fd = -1;
+}
@@ -0,0 +1,60 @@
+#ifndef SOCK_STATS_H
+#define SOCK_STATS_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "proc_reader.h"
+
+#define SOCK_SOURCE_DIAG   0
+#define SOCK_SOURCE_PROCFS 1
+
+#define SOCK_PROTO_TCP 0
+#define SOCK_PROTO_UDP 1
+
+// Kernel TCP states (include/net/tcp_states.h), 1..12
+#define SOCK_TCP_ESTABLISHED  1
+#define SOCK_TCP_LISTEN       10
+#define SOCK_TCP_MAX_STATES   13
+#define SOCK_STATE_BIT(s)     (1u << (s))
+#define SOCK_ALL_STATES       0x1FFEu
+
+#define SOCK_PORTS 65536
+
+// Per-port counters; `touched` lists the non-zero ports so a reset only
+// clears what the last sample set
+typedef struct {
+    uint32_t* count;
+    uint16_t* touched;
+    uint32_t touched_count;
+    uint32_t total;
+} sock_ports_t;
+
+typedef struct {
+    uint32_t tcp_states[SOCK_TCP_MAX_STATES];
+    sock_ports_t ports[2];          // SOCK_PROTO_*
+    uint32_t state_mask;            // TCP states to count; UDP counts all
+    int source;                     // SOCK_SOURCE_*
+    int diag_fd;
+    uint32_t diag_seq;
+    char* diag_buf;
+    proc_file_t files[4];           // tcp, tcp6, udp, udp6
+    char proc_root[64];             // directory holding them, "/proc/net"
+} sock_stats_t;
+
+// Uses sock_diag netlink when available and /proc/net/{tcp,udp}[6] otherwise.
+// state_mask selects TCP states with SOCK_STATE_BIT(); 0 means all.
+int sock_stats_init(sock_stats_t* ss, uint32_t state_mask);
+void sock_stats_reset(sock_stats_t* ss);
+// Read the procfs tables from another directory; 0 on success
+int sock_stats_set_proc_root(sock_stats_t* ss, const char* root);
+// Reset and count every socket from the given source; returns sockets counted or -1
+int sock_stats_collect(sock_stats_t* ss, int source);
+// Add the sockets in one /proc/net/{tcp,udp}[6] table; returns sockets counted or -1
+int sock_stats_parse_proc(sock_stats_t* ss, const char* buf, size_t len, int proto);
+// Busiest local ports, highest count first
+int sock_stats_top_ports(const sock_stats_t* ss, int proto, int k, uint16_t* ports, uint32_t* counts);
+const char* sock_tcp_state_name(int state);
+int format_sock_stats(const sock_stats_t* ss, char* buf, size_t size);
+void sock_stats_free(sock_stats_t* ss);
+
+#endif
@@ -0,0 +1,144 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include <math.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include "../cgroup_watch.h"
+
+#define MANY_GROUPS 300
+#define SECOND 1000000000ULL
+
+static char root[64];
+
+static void write_file(const char* group, const char* name, const char* text) {
+    char path[512];
+    snprintf(path, sizeof(path), "%s/%s%s%s", root, group, *group ? "/" : "", name);
+    FILE* f = fopen(path, "w");
+    assert(f);
+    fputs(text, f);
+    fclose(f);
+}
+
+static void set_usage(const char* group, unsigned long long usage_usec, unsigned long long rbytes) {
+    char text[256];
+    snprintf(text, sizeof(text), "usage_usec %llu\nuser_usec %llu\nsystem_usec 0\n"
+             "nr_periods 0\nnr_throttled 0\nthrottled_usec %llu\n",
+             usage_usec, usage_usec, usage_usec / 10);
+    write_file(group, "cpu.stat", text);
+    snprintf(text, sizeof(text), "8:0 rbytes=%llu wbytes=0 rios=1 wios=0 dbytes=0 dios=0\n"
+             "259:0 rbytes=%llu wbytes=4096 rios=1 wios=1 dbytes=0 dios=0\n", rbytes, rbytes);
+    write_file(group, "io.stat", text);
+}
+
+static void make_group(const char* group) {
+    char path[512];
+    snprintf(path, sizeof(path), "%s/%s", root, group);
+    mkdir(path, 0755);
+    set_usage(group, 0, 0);
+    write_file(group, "memory.current", "1048576\n");
+    write_file(group, "memory.stat", "anon 524288\nfile 262144\nkernel 4096\nanon_thp 0\n");
+}
+
+static void remove_group(const char* group) {
+    static const char* files[] = { "cpu.stat", "io.stat", "memory.current", "memory.stat" };
+    char path[512];
+    for (int i = 0; i < 4; i++) {
+        snprintf(path, sizeof(path), "%s/%s/%s", root, group, files[i]);
+        unlink(path);
+    }
+    snprintf(path, sizeof(path), "%s/%s", root, group);
+    rmdir(path);
+}
+
+static double now_sec(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+int main() {
+    printf("Testing cgroup watch...\n");
+    strcpy(root, "/tmp/cgroup_watch_XXXXXX");
+    assert(mkdtemp(root));
+    make_group("");
+    make_group("a");
+    make_group("a/x");
+    make_group("b");
+
+    cgroup_watch_t cw;
+    assert(cgroup_watch_init(&cw, root) == 0);
+    assert(cw.count == 4 && cgroup_watch_find(&cw, "a/x"));
+    assert(cgroup_watch_sample_at(&cw, 1 * SECOND) == 4);
+    const cgroup_t* a = cgroup_watch_find(&cw, "a");
+    assert(a->memory_current == 1048576 && a->memstat.anon == 524288 && a->memstat.file == 262144);
+    assert(a->io.rbytes == 0 && a->io.wbytes == 4096 && a->io.wios == 1);
+
+    // Half a CPU and 1 MB/s of reads over one second
+    set_usage("a", 500000, 512 * 1024);
+    assert(cgroup_watch_sample_at(&cw, 2 * SECOND) == 4);
+    a = cgroup_watch_find(&cw, "a");
+    assert(fabsf(a->cpu_pct - 50.0f) < 0.01f && fabsf(a->throttled_pct - 5.0f) < 0.01f);
+    assert(fabs(a->read_bytes_per_sec - 1024.0 * 1024.0) < 1e-6);
+    assert(cgroup_watch_find(&cw, "b")->cpu_pct == 0);
+
+    // New groups, including a nested one created before the event is read
+    make_group("c");
+    make_group("c/inner");
+    assert(cgroup_watch_sample_at(&cw, 3 * SECOND) == 6);
+    assert(cw.created == 2 && cgroup_watch_find(&cw, "c/inner"));
+
+    // Removing a subtree
+    remove_group("a/x");
+    remove_group("a");
+    assert(cgroup_watch_sample_at(&cw, 4 * SECOND) == 4);
+    assert(cw.removed == 2 && !cgroup_watch_find(&cw, "a") && !cgroup_watch_find(&cw, "a/x"));
+    assert(cgroup_watch_find(&cw, "c/inner")->has_sample);
+
+    char buf[4096];
+    int n = format_cgroup_watch(&cw, 3, buf, sizeof(buf));
+    assert(n > 0 && (size_t)n < sizeof(buf) && strstr(buf, "4 cgroups"));
+    assert(format_cgroup_watch(&cw, 3, NULL, 0) == n);
+
+    // Hundreds of groups
+    make_group("many");
+    char name[64];
+    for (int i = 0; i < MANY_GROUPS; i++) {
+        snprintf(name, sizeof(name), "many/g%d", i);
+        make_group(name);
+    }
+    assert(cgroup_watch_sample_at(&cw, 5 * SECOND) == 5 + MANY_GROUPS);
+    int rounds = 100;
+    double start = now_sec();
+    for (int i = 0; i < rounds; i++) cgroup_watch_sample_at(&cw, (6 + (uint64_t)i) * SECOND);
+    printf("  %d cgroups: %.0f us per sample\n", cw.count, (now_sec() - start) * 1e6 / rounds);
+    cgroup_watch_free(&cw);
+
+    for (int i = 0; i < MANY_GROUPS; i++) {
+        snprintf(name, sizeof(name), "many/g%d", i);
+        remove_group(name);
+    }
+    remove_group("many");
+    remove_group("c/inner");
+    remove_group("c");
+    remove_group("b");
+    remove_group("");
+
+    // Live cgroup v2 hierarchy, where there is one
+    const char* live[] = { "/sys/fs/cgroup/unified", "/sys/fs/cgroup" };
+    for (int i = 0; i < 2; i++) {
+        char probe[128];
+        snprintf(probe, sizeof(probe), "%s/cgroup.controllers", live[i]);
+        if (access(probe, R_OK) != 0) continue;
+        assert(cgroup_watch_init(&cw, live[i]) == 0 && cw.count >= 1);
+        assert(cgroup_watch_sample(&cw) >= 1);
+        printf("  live %s: %d cgroups\n", live[i], cw.count);
+        cgroup_watch_free(&cw);
+        break;
+    }
+
+    printf("All cgroup watch tests passed!\n");
+    return 0;
+}
@@ -0,0 +1,147 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include "../plugin_registry.h"
+#include "../collector_sched.h"
+
+#define MS 1000000ULL
+#define SECOND 1000000000ULL
+
+enum { TICKS, DEPTH, FAKE_METRICS };
+
+static const metric_desc_t fake_metrics[FAKE_METRICS] = {
+    { "ticks", "events", METRIC_U64, METRIC_COUNTER },
+    { "depth", "items", METRIC_U64, METRIC_GAUGE },
+};
+
+static int live_states = 0;
+
+typedef struct {
+    uint64_t ticks;
+} fake_state_t;
+
+static void* fake_init(const char* target) {
+    fake_state_t* s = calloc(1, sizeof(*s));
+    if (s && target) s->ticks = strtoull(target, NULL, 10);
+    if (s) live_states++;
+    return s;
+}
+
+// 100 events and one more queued item per sample
+static int fake_sample(void* state, metric_value_t* values) {
+    fake_state_t* s = state;
+    s->ticks += 100;
+    values[TICKS].u64 = s->ticks;
+    values[DEPTH].u64 = s->ticks / 100;
+    return 0;
+}
+
+static void fake_teardown(void* state) {
+    live_states--;
+    free(state);
+}
+
+static const collector_ops_t fake_ops = {
+    .abi_version = COLLECTOR_ABI_VERSION,
+    .name = "fake-room",
+    .metrics = fake_metrics,
+    .metric_count = FAKE_METRICS,
+    .interval_ms = 100,
+    .init = fake_init,
+    .sample = fake_sample,
+    .teardown = fake_teardown,
+};
+
+static void test_registry(void) {
+    assert(plugin_register(&fake_ops) >= 0);
+    assert(plugin_register(&fake_ops) == -1);
+    assert(plugin_find("fake-room") == &fake_ops);
+
+    collector_ops_t bad = fake_ops;
+    bad.name = "old-abi-room";
+    bad.abi_version = COLLECTOR_ABI_VERSION + 1;
+    assert(plugin_register(&bad) == -1);
+    bad.abi_version = COLLECTOR_ABI_VERSION;
+    bad.metric_count = COLLECTOR_MAX_METRICS + 1;
+    assert(plugin_register(&bad) == -1);
+    metric_desc_t untyped[1] = { { "x", "", 0, METRIC_GAUGE } };
+    bad.metrics = untyped;
+    bad.metric_count = 1;
+    assert(plugin_register(&bad) == -1);
+    assert(plugin_find("old-abi-room") == NULL);
+
+    // The example plugin from plugins/, loaded twice: the second copy is refused
+    assert(plugin_load_dir("plugins") == 1);
+    assert(plugin_load_dir("plugins") == 0);
+    assert(plugin_load_dir("/nonexistent/plugins") == -1);
+    const collector_ops_t* loadavg = plugin_find("loadavg-room");
+    assert(loadavg && loadavg->metric_count == 6);
+    assert(plugin_count() == 2 && plugin_at(2) == NULL);
+    printf("✓ Registry checks ABI and schema, dlopen()s plugins once\n");
+}
+
+static void test_task(void) {
+    collector_task_t task;
+    assert(collector_task_init(&task, &fake_ops, "1000", 0) == 0);
+    assert(task.interval_ms == 100 && live_states == 1);
+    assert(collector_task_sample(&task, SECOND) == 0);
+    assert(!task.has_rates && task.out[TICKS].f64 == 0 && task.out[DEPTH].u64 == 11);
+    assert(collector_task_sample(&task, 3 * SECOND) == 0);
+    assert(task.has_rates && task.out[TICKS].f64 > 49.9 && task.out[TICKS].f64 < 50.1);
+    assert(task.out[DEPTH].u64 == 12);
+
+    int len = collector_task_format(&task, NULL, 0);
+    char* buf = malloc((size_t)len + 1);
+    assert(collector_task_format(&task, buf, (size_t)len + 1) == len);
+    assert(strstr(buf, "ticks") && strstr(buf, "events/s") && strstr(buf, "12 items"));
+    free(buf);
+    collector_task_free(&task);
+    assert(live_states == 0);
+
+    // The real plugin samples the live system
+    assert(collector_task_init(&task, plugin_find("loadavg-room"), NULL, 0) == 0);
+    assert(collector_task_sample(&task, SECOND) == 0 && collector_task_sample(&task, 2 * SECOND) == 0);
+    assert(task.out[4].u64 > 0);
+    collector_task_free(&task);
+    printf("✓ Tasks turn counters into rates and keep gauges\n");
+}
+
+static void test_batches(void) {
+    collector_sched_t cs;
+    collector_sched_init(&cs);
+    uint64_t t0 = 10 * SECOND, next;
+    for (int i = 0; i < 3; i++) assert(collector_sched_add(&cs, &fake_ops, NULL, 0, t0) == i);
+    for (int i = 0; i < 2; i++) assert(collector_sched_add(&cs, &fake_ops, NULL, 250, t0) >= 0);
+    assert(collector_sched_add(&cs, plugin_find("loadavg-room"), NULL, 0, t0) >= 0);
+    assert(cs.count == 6 && cs.batch_count == 3 && live_states == 5);
+
+    assert(collector_sched_run(&cs, t0, &next) == 6 && next == t0 + 100 * MS);
+    assert(collector_sched_run(&cs, t0 + 50 * MS, &next) == 0 && next == t0 + 100 * MS);
+    assert(collector_sched_run(&cs, t0 + 100 * MS, &next) == 3 && next == t0 + 200 * MS);
+    // Both the 100ms and the 250ms batches are due here
+    assert(collector_sched_run(&cs, t0 + 250 * MS, &next) == 5 && next == t0 + 300 * MS);
+    assert(cs.tasks[0].has_rates && cs.tasks[0].out[TICKS].f64 > 0);
+
+    // After a long stall every batch runs once, not once per missed period
+    assert(collector_sched_run(&cs, t0 + 10 * SECOND, &next) == 6);
+    assert(next == t0 + 10 * SECOND + 100 * MS);
+    assert(cs.batches[0].runs == 4 && cs.batches[1].runs == 3 && cs.batches[2].runs == 2);
+
+    const collector_task_t* found = collector_sched_find(&cs, "loadavg-room");
+    assert(found && found->has_rates);
+    collector_sched_free(&cs);
+    assert(live_states == 0);
+    printf("✓ Collectors with the same period run as one batch\n");
+}
+
+int main() {
+    printf("Testing collector plugins...\n");
+    test_registry();
+    test_task();
+    test_batches();
+    plugin_unload_all();
+    assert(plugin_count() == 0 && plugin_find("loadavg-room") == NULL);
+    printf("All collector plugin tests passed!\n");
+    return 0;
+}
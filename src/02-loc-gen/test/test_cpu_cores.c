@@ -0,0 +1,50 @@
+#include <stdio.h>
+#include <string.h>
+#include <assert.h>
+#include <math.h>
+#include "../cpu_cores.h"
+
+#define CORES 67    // not a multiple of the vector width
+
+static cpu_snapshot_t snap;
+static cpu_cores_t cores;
+
+static void fill(uint64_t tick) {
+    memset(&snap, 0, sizeof(snap));
+    snap.stat.cpu_count = CORES;
+    for (int i = 0; i < CORES; i++) {
+        proc_cpu_times_t* t = &snap.stat.cpu[i];
+        snap.stat.cpu_index[i] = i;
+        // Core i is busy i% of each 100-jiffy tick; counters start near 2^32
+        t->user = 0xFFFFFFC0ULL + tick * (uint64_t)i;
+        t->idle = tick * (uint64_t)(100 - i);
+    }
+}
+
+int main() {
+    printf("Testing per-core CPU tracking...\n");
+    cpu_cores_init(&cores);
+
+    fill(1);
+    assert(cpu_cores_update(&cores, &snap) == 0 && "First sample has no deltas");
+    fill(2);
+    assert(cpu_cores_update(&cores, &snap) == CORES);
+    for (int i = 0; i < CORES; i++) {
+        assert(fabsf(cores.util[i] - (float)i) < 0.01f && "Utilisation across 2^32 wrap");
+    }
+
+    int ids[5];
+    float utils[5];
+    assert(cpu_cores_top(&cores, 5, ids, utils) == 5);
+    for (int i = 0; i < 5; i++) {
+        assert(ids[i] == CORES - 1 - i && "Top cores in descending order");
+    }
+    assert(cpu_cores_top(&cores, 0, ids, utils) == 0);
+
+    // A changed core set resets instead of diffing unrelated cores
+    snap.stat.cpu_count = CORES - 1;
+    assert(cpu_cores_update(&cores, &snap) == 0);
+
+    printf("All per-core CPU tests passed!\n");
+    return 0;
+}
@@ -1,7 +1,12 @@
 #include <stdio.h>
+#include <string.h>
 #include <assert.h>
+#include <unistd.h>
 #include "../data_collector.h"
 
+static cpu_snapshot_t cpu_prev, cpu_cur;
+static io_snapshot_t io_prev, io_cur, io_delta;
+
 int main() {
     printf("Testing data reading functions...\n");
 
@@ -9,6 +14,34 @@ int main() {
     assert(read_memory_stats() == 0 && "Failed to read Memory stats");
     assert(read_io_stats() == 0 && "Failed to read IO stats");
 
+    printf("Testing typed snapshots...\n");
+    assert(collect_cpu_stats(&cpu_prev) == 0 && "Failed to collect CPU snapshot");
+    assert(cpu_prev.stat.cpu_count > 0 && cpu_prev.stat.total.user > 0);
+    usleep(50000);
+    assert(collect_cpu_stats(&cpu_cur) == 0);
+    assert(cpu_cur.timestamp_ns > cpu_prev.timestamp_ns);
+    double busy = cpu_busy_percent(&cpu_prev, &cpu_cur, -1);
+    assert(busy >= -1 && busy <= 100.0);
+    assert(cpu_busy_percent(&cpu_prev, &cpu_cur, PROC_MAX_CPUS + 1) == -1 && "Unknown CPU must fail");
+
+    memory_snapshot_t mem;
+    assert(collect_memory_stats(&mem) == 0 && "Failed to collect memory snapshot");
+    assert(mem.mem.mem_total > 0 && mem.mem.mem_free <= mem.mem.mem_total);
+
+    assert(collect_io_stats(&io_prev) == 0 && "Failed to collect IO snapshot");
+    assert(collect_io_stats(&io_cur) == 0);
+    assert(io_snapshot_diff(&io_prev, &io_cur, &io_delta) == io_cur.disk_count);
+    for (int i = 0; i < io_delta.disk_count; i++) {
+        assert(io_delta.disks[i].reads <= io_cur.disks[i].reads);
+    }
+
+    printf("Testing formatters...\n");
+    char buf[64];
+    int need = format_memory_snapshot(&mem, buf, sizeof(buf));
+    assert(need > (int)sizeof(buf) - 1 && strlen(buf) == sizeof(buf) - 1 && "Formatter must truncate safely");
+    assert(strncmp(buf, "MemTotal:", 9) == 0);
+    assert(format_cpu_snapshot(&cpu_cur, NULL, 0) > 0);
+
     printf("All data reading tests passed!\n");
     return 0;
 }
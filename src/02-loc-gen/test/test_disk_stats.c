@@ -0,0 +1,111 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include <math.h>
+#include <time.h>
+#include "../disk_stats.h"
+
+#define MANY_DEVICES 5000
+
+static const char* sample1 =
+    "   8       0 sda 100 0 2000 50 200 0 4000 150 0 100 200\n"
+    "   8       1 sda1 90 0 1800 45 190 0 3800 140 0 90 185\n"
+    "   7       0 loop0 10 0 20 1 0 0 0 0 0 1 1\n";
+static const char* sample2 =
+    "   8       0 sda 300 0 6000 250 400 0 8000 350 0 600 600\n"
+    "   8       1 sda1 290 0 5800 245 390 0 7800 340 0 590 585\n"
+    "   7       0 loop0 20 0 40 2 0 0 0 0 0 2 2\n";
+// sda1 is gone and a new device appears
+static const char* sample3 =
+    "   8       0 sda 300 0 6000 250 400 0 8000 350 0 600 600\n"
+    " 253       3 dm-3 1 0 8 1 1 0 8 1 0 1 2\n";
+
+static const disk_rate_t* find(const disk_stats_t* ds, const char* name) {
+    for (int i = 0; i < ds->rate_count; i++) {
+        if (strcmp(ds->rates[i].name, name) == 0) return &ds->rates[i];
+    }
+    return NULL;
+}
+
+static char* synthetic(int devices, int tick, size_t* len) {
+    char* buf = malloc((size_t)devices * 96);
+    size_t off = 0;
+    for (int i = 0; i < devices; i++) {
+        off += (size_t)sprintf(buf + off, " 253 %7d dm-%d %d 0 %d 1 %d 0 %d 1 0 %d 2\n",
+                               i, i, tick * 10, tick * 80, tick * 5, tick * 40, tick * 3);
+    }
+    *len = off;
+    return buf;
+}
+
+static double now_sec(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+int main() {
+    printf("Testing disk rate tracking...\n");
+    disk_stats_t ds;
+
+    assert(disk_stats_init(&ds, NULL, "loop*") == 0);
+    assert(disk_stats_update(&ds, sample1, strlen(sample1), 1000000000ULL) == 0 &&
+           "First sample has no rates");
+    assert(disk_stats_update(&ds, sample2, strlen(sample2), 3000000000ULL) == 2);
+    assert(!find(&ds, "loop0") && "Excluded device");
+
+    const disk_rate_t* sda = find(&ds, "sda");
+    assert(sda && sda->major == 8 && sda->minor == 0);
+    assert(fabs(sda->read_iops - 100.0) < 1e-9);
+    assert(fabs(sda->write_iops - 100.0) < 1e-9);
+    assert(fabs(sda->read_bytes_per_sec - 4000.0 * 512 / 2) < 1e-6);
+    assert(fabs(sda->write_bytes_per_sec - 4000.0 * 512 / 2) < 1e-6);
+    assert(fabs(sda->util_pct - 25.0) < 1e-9);
+    assert(fabs(sda->await_ms - 1.0) < 1e-9);
+
+    char buf[1024];
+    int n = format_disk_rates(&ds, buf, sizeof(buf));
+    assert(n > 0 && (size_t)n < sizeof(buf) && strstr(buf, "sda1"));
+    assert(format_disk_rates(&ds, NULL, 0) == n);
+
+    // Vanished devices are forgotten, new ones start without rates
+    assert(disk_stats_update(&ds, sample3, strlen(sample3), 4000000000ULL) == 1);
+    assert(ds.used == 2);
+    disk_stats_free(&ds);
+
+    // Include filter keeps whole disks only
+    assert(disk_stats_init(&ds, "sd[a-z],nvme*n1", NULL) == 0);
+    disk_stats_update(&ds, sample1, strlen(sample1), 1000000000ULL);
+    assert(disk_stats_update(&ds, sample2, strlen(sample2), 2000000000ULL) == 1);
+    assert(find(&ds, "sda") && !find(&ds, "sda1"));
+    disk_stats_free(&ds);
+
+    // Thousands of device-mapper nodes: the index grows and every device
+    // is matched to its previous counters
+    size_t len1, len2;
+    char* big1 = synthetic(MANY_DEVICES, 1, &len1);
+    char* big2 = synthetic(MANY_DEVICES, 2, &len2);
+    assert(disk_stats_init(&ds, "dm-*", NULL) == 0);
+    assert(disk_stats_update(&ds, big1, len1, 1000000000ULL) == 0);
+    assert(disk_stats_update(&ds, big2, len2, 2000000000ULL) == MANY_DEVICES);
+    for (int i = 0; i < MANY_DEVICES; i++) {
+        assert(ds.rates[i].minor == (uint32_t)i && fabs(ds.rates[i].read_iops - 10.0) < 1e-9);
+    }
+
+    int rounds = 200;
+    double start = now_sec();
+    for (int i = 0; i < rounds; i++) {
+        disk_stats_update(&ds, (i & 1) ? big2 : big1, (i & 1) ? len2 : len1,
+                          3000000000ULL + (uint64_t)i * 1000000000ULL);
+    }
+    double elapsed = now_sec() - start;
+    printf("%d devices: %.1f ns per device per sample\n", MANY_DEVICES,
+           elapsed * 1e9 / ((double)rounds * MANY_DEVICES));
+    disk_stats_free(&ds);
+    free(big1);
+    free(big2);
+
+    printf("All disk rate tests passed!\n");
+    return 0;
+}
@@ -0,0 +1,112 @@
+#include <stdio.h>
+#include <string.h>
+#include <assert.h>
+#include <math.h>
+#include <time.h>
+#include "../net_stats.h"
+
+#define BENCH_ROUNDS 2000
+
+static proc_netdev_t ifaces[4];
+
+static void set_iface(int i, const char* name, uint64_t rx, uint64_t tx) {
+    memset(&ifaces[i], 0, sizeof(ifaces[i]));
+    snprintf(ifaces[i].name, sizeof(ifaces[i].name), "%s", name);
+    ifaces[i].rx_bytes = rx;
+    ifaces[i].tx_bytes = tx;
+    ifaces[i].rx_packets = rx / 100;
+    ifaces[i].tx_packets = tx / 100;
+    ifaces[i].rx_errs = rx / 10000;
+}
+
+static const net_rate_t* find(const net_stats_t* ns, const char* name) {
+    for (int i = 0; i < ns->rate_count; i++) {
+        if (strcmp(ns->rates[i].name, name) == 0) return &ns->rates[i];
+    }
+    return NULL;
+}
+
+static int has_iface(const proc_netdev_t* list, int count, const char* name) {
+    for (int i = 0; i < count; i++) {
+        if (strcmp(list[i].name, name) == 0) return 1;
+    }
+    return 0;
+}
+
+static double now_sec(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static void bench(net_stats_t* ns, int source, const char* label) {
+    double start = now_sec();
+    for (int i = 0; i < BENCH_ROUNDS; i++) {
+        assert(net_stats_collect(ns, source) >= 0);
+    }
+    printf("  %-14s %8.0f ns per dump (%d interfaces)\n", label,
+           (now_sec() - start) * 1e9 / BENCH_ROUNDS, ns->iface_count);
+}
+
+int main() {
+    printf("Testing network interface rates...\n");
+    net_stats_t ns;
+    assert(net_stats_init(&ns) == 0);
+
+    set_iface(0, "eth0", 1000000, 500000);
+    set_iface(1, "veth1", 0, 0);
+    assert(net_stats_update(&ns, ifaces, 2, 1000000000ULL) == 0 && "First sample has no rates");
+    assert(ns.added == 0 && ns.removed == 0);
+
+    set_iface(0, "eth0", 3000000, 700000);
+    set_iface(1, "veth1", 2000, 4000);
+    assert(net_stats_update(&ns, ifaces, 2, 3000000000ULL) == 2);
+    const net_rate_t* eth0 = find(&ns, "eth0");
+    assert(eth0);
+    assert(fabs(eth0->rx_bytes_per_sec - 1000000.0) < 1e-6);
+    assert(fabs(eth0->tx_bytes_per_sec - 100000.0) < 1e-6);
+    assert(fabs(eth0->rx_packets_per_sec - 10000.0) < 1e-6);
+    assert(fabs(eth0->rx_errors_per_sec - 100.0) < 1e-6);
+
+    // veth1 goes away, veth2 appears, eth0 is recreated with reset counters
+    set_iface(0, "eth0", 10, 10);
+    set_iface(1, "veth2", 100, 100);
+    assert(net_stats_update(&ns, ifaces, 2, 4000000000ULL) == 0);
+    assert(ns.added == 1 && ns.removed == 1 && ns.used == 2);
+    set_iface(0, "eth0", 1010, 10);
+    set_iface(1, "veth2", 200, 100);
+    assert(net_stats_update(&ns, ifaces, 2, 5000000000ULL) == 2);
+    assert(fabs(find(&ns, "eth0")->rx_bytes_per_sec - 1000.0) < 1e-6);
+
+    char buf[1024];
+    int n = format_net_rates(&ns, buf, sizeof(buf));
+    assert(n > 0 && (size_t)n < sizeof(buf) && strstr(buf, "veth2"));
+    assert(format_net_rates(&ns, NULL, 0) == n);
+    net_stats_free(&ns);
+
+    // Live: both sources see the same interfaces
+    assert(net_stats_init(&ns) == 0);
+    int procfs = net_stats_collect(&ns, NET_SOURCE_PROCFS);
+    assert(procfs > 0 && has_iface(ns.ifaces, procfs, "lo"));
+    if (ns.source == NET_SOURCE_NETLINK) {
+        static proc_netdev_t from_procfs[64];
+        int kept = procfs < 64 ? procfs : 64;
+        memcpy(from_procfs, ns.ifaces, sizeof(proc_netdev_t) * (size_t)kept);
+        int netlink = net_stats_collect(&ns, NET_SOURCE_NETLINK);
+        assert(netlink == procfs && "Same interface count");
+        for (int i = 0; i < kept; i++) {
+            assert(has_iface(ns.ifaces, netlink, from_procfs[i].name));
+        }
+        printf("Benchmark (%d dumps):\n", BENCH_ROUNDS);
+        bench(&ns, NET_SOURCE_NETLINK, "rtnetlink");
+        bench(&ns, NET_SOURCE_PROCFS, "/proc/net/dev");
+    } else {
+        printf("rtnetlink unavailable, only /proc/net/dev checked\n");
+    }
+    assert(net_stats_sample(&ns) == 0);
+    assert(net_stats_sample(&ns) >= 1);
+    net_stats_free(&ns);
+
+    printf("All network rate tests passed!\n");
+    return 0;
+}
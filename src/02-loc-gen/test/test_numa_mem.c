@@ -0,0 +1,174 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include "../numa_mem.h"
+
+#define SECOND 1000000000ULL
+#define BENCH_ROUNDS 200000
+
+static char root[64];
+
+// Same layout as the kernel's node_read_meminfo(): values padded to 8 digits
+static int format_meminfo(char* buf, size_t size, int node, unsigned long total, unsigned long free_kb) {
+    return snprintf(buf, size,
+        "Node %d MemTotal:       %8lu kB\nNode %d MemFree:        %8lu kB\n"
+        "Node %d MemUsed:        %8lu kB\nNode %d SwapCached:     %8d kB\n"
+        "Node %d Active:         %8lu kB\nNode %d Inactive:       %8lu kB\n"
+        "Node %d Active(anon):   %8d kB\nNode %d Inactive(anon): %8lu kB\n"
+        "Node %d Active(file):   %8lu kB\nNode %d Inactive(file): %8lu kB\n"
+        "Node %d Unevictable:    %8d kB\nNode %d Mlocked:        %8d kB\n"
+        "Node %d Dirty:          %8d kB\nNode %d Writeback:      %8d kB\n"
+        "Node %d FilePages:      %8lu kB\nNode %d Mapped:         %8lu kB\n"
+        "Node %d AnonPages:      %8lu kB\nNode %d Shmem:          %8d kB\n"
+        "Node %d KernelStack:    %8d kB\nNode %d PageTables:     %8d kB\n"
+        "Node %d Slab:           %8lu kB\nNode %d SReclaimable:   %8lu kB\n"
+        "Node %d HugePages_Total: %5d\nNode %d HugePages_Free:  %5d\n",
+        node, total, node, free_kb, node, total - free_kb, node, 0,
+        node, total / 8, node, total / 6, node, 36, node, total / 20,
+        node, total / 12, node, total / 9, node, 0, node, 0,
+        node, 64, node, 0, node, total / 5, node, total / 30,
+        node, total / 20, node, 512, node, 1024, node, 2048,
+        node, total / 100, node, total / 200, node, 0, node, 0);
+}
+
+static void write_file(const char* name, const char* text) {
+    char path[256];
+    snprintf(path, sizeof(path), "%s/%s", root, name);
+    FILE* f = fopen(path, "w");
+    assert(f);
+    fputs(text, f);
+    fclose(f);
+}
+
+static void write_node(int node, unsigned long total, unsigned long free_kb,
+                       unsigned long long hit, unsigned long long miss) {
+    char name[64], text[4096];
+    snprintf(name, sizeof(name), "node%d", node);
+    char dir[256];
+    snprintf(dir, sizeof(dir), "%s/%s", root, name);
+    mkdir(dir, 0755);
+    format_meminfo(text, sizeof(text), node, total, free_kb);
+    snprintf(name, sizeof(name), "node%d/meminfo", node);
+    write_file(name, text);
+    snprintf(text, sizeof(text), "numa_hit %llu\nnuma_miss %llu\nnuma_foreign %llu\n"
+             "interleave_hit 1023\nlocal_node %llu\nother_node %llu\n", hit, miss, miss / 2, hit, miss);
+    snprintf(name, sizeof(name), "node%d/numastat", node);
+    write_file(name, text);
+}
+
+static double now_sec(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static void test_synthetic(void) {
+    snprintf(root, sizeof(root), "/tmp/test_numa_%d", (int)getpid());
+    assert(mkdir(root, 0755) == 0);
+    write_node(1, 16000000, 1000000, 5000, 100);
+    write_node(0, 16000000, 12000000, 9000, 0);
+    // Neighbours in the real directory that are not nodes
+    write_file("possible", "0-1\n");
+    char junk[256];
+    snprintf(junk, sizeof(junk), "%s/nodex", root);
+    mkdir(junk, 0755);
+
+    numa_mem_t nm;
+    assert(numa_mem_init(&nm, root) == 2);
+    assert(nm.nodes[0].id == 0 && nm.nodes[1].id == 1);
+    assert(numa_mem_sample_at(&nm, SECOND) == 2);
+    const numa_node_t* n1 = &nm.nodes[1];
+    assert(n1->mem.mem_total == 16000000 && n1->mem.mem_free == 1000000 && n1->mem.mem_used == 15000000);
+    assert(n1->mem.slab == 160000 && n1->mem.anon_pages == 800000);
+    assert(n1->stat.numa_hit == 5000 && n1->stat.numa_miss == 100);
+    assert(numa_mem_tightest(&nm) == 1);
+
+    // Same widths: every key is still where it was, so no rescan
+    write_node(1, 16000000, 900000, 5500, 180);
+    write_node(0, 16000000, 11000000, 9100, 0);
+    assert(numa_mem_sample_at(&nm, 3 * SECOND) == 2);
+    assert(n1->meminfo_offs.relearns == 0 && n1->numastat_offs.relearns == 0);
+    assert(n1->mem.mem_free == 900000);
+    assert(n1->hit_per_sec > 249.9 && n1->hit_per_sec < 250.1);
+    assert(n1->miss_per_sec > 39.9 && n1->miss_per_sec < 40.1);
+    assert(n1->miss_pct > 13.7 && n1->miss_pct < 13.9);
+    assert(nm.nodes[0].miss_pct == 0 && nm.nodes[0].hit_per_sec > 49.9);
+
+    // A counter gaining a digit shifts the lines after it; a value wider
+    // than its padding shifts the meminfo keys
+    write_node(1, 160000000, 90000000, 15500, 400);
+    assert(numa_mem_sample_at(&nm, 4 * SECOND) == 2);
+    assert(n1->numastat_offs.relearns == 1 && n1->meminfo_offs.relearns == 1);
+    assert(n1->mem.mem_total == 160000000 && n1->mem.mem_free == 90000000);
+    assert(n1->stat.numa_hit == 15500 && n1->stat.numa_foreign == 200);
+
+    int len = format_numa_mem(&nm, NULL, 0);
+    char* buf = malloc((size_t)len + 1);
+    assert(format_numa_mem(&nm, buf, (size_t)len + 1) == len);
+    assert(strstr(buf, "node1") && strstr(buf, "Tightest: node1"));
+    free(buf);
+    numa_mem_free(&nm);
+
+    char cmd[128];
+    snprintf(cmd, sizeof(cmd), "rm -rf %s", root);
+    assert(system(cmd) == 0);
+    assert(numa_mem_init(&nm, root) == -1);
+    printf("✓ Per-node free/used and hit/miss rates, rescans only after layout shifts\n");
+}
+
+static void bench_offsets(void) {
+    char text[4096];
+    int len = format_meminfo(text, sizeof(text), 0, 16000000, 1000000);
+    proc_node_meminfo_t mem;
+    proc_offsets_t offs;
+    memset(&offs, 0, sizeof(offs));
+    volatile uint64_t sink = 0;
+
+    double start = now_sec();
+    for (int i = 0; i < BENCH_ROUNDS; i++) {
+        proc_parse_node_meminfo(text, (size_t)len, NULL, &mem);
+        sink += mem.mem_free;
+    }
+    double full = (now_sec() - start) / BENCH_ROUNDS * 1e9;
+    start = now_sec();
+    for (int i = 0; i < BENCH_ROUNDS; i++) {
+        proc_parse_node_meminfo(text, (size_t)len, &offs, &mem);
+        sink += mem.mem_free;
+    }
+    double cached = (now_sec() - start) / BENCH_ROUNDS * 1e9;
+    assert(offs.relearns == 0 && mem.mem_free == 1000000);
+    (void)sink;
+    printf("Node meminfo parse (%d bytes):\n", len);
+    printf("  full scan:      %6.0f ns\n", full);
+    printf("  cached offsets: %6.0f ns\n", cached);
+}
+
+static void test_live(void) {
+    numa_mem_t nm;
+    if (numa_mem_init(&nm, NUMA_SYSFS_ROOT) < 0) {
+        printf("- No NUMA nodes in sysfs, skipping live test\n");
+        return;
+    }
+    assert(numa_mem_sample(&nm) > 0);
+    unsigned long total;
+    assert(sscanf(nm.nodes[0].meminfo.buf, "Node %*d MemTotal: %lu kB", &total) == 1);
+    assert(nm.nodes[0].mem.mem_total == total && total > 0);
+    assert(numa_mem_sample(&nm) > 0);
+    assert(nm.nodes[0].meminfo_offs.relearns == 0);
+    printf("  live: %d nodes, node%d %llu kB free\n", nm.count, nm.nodes[0].id,
+           (unsigned long long)nm.nodes[0].mem.mem_free);
+    numa_mem_free(&nm);
+}
+
+int main() {
+    printf("Testing NUMA memory...\n");
+    test_synthetic();
+    bench_offsets();
+    test_live();
+    printf("All NUMA memory tests passed!\n");
+    return 0;
+}
@@ -0,0 +1,95 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include <signal.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <time.h>
+#include <sys/prctl.h>
+#include <sys/wait.h>
+#include "../pid_watch.h"
+
+#define CHILD_NAME "pidwatch_child"
+#define CHILD_FILES 5
+
+// A child that renames itself, opens a few files and burns CPU
+static pid_t spawn_child(void) {
+    pid_t pid = fork();
+    assert(pid >= 0);
+    if (pid == 0) {
+        prctl(PR_SET_NAME, CHILD_NAME);
+        for (int i = 0; i < CHILD_FILES; i++) open("/dev/null", O_RDONLY);
+        volatile unsigned long spin = 0;
+        for (;;) spin++;
+    }
+    return pid;
+}
+
+static void stop_child(pid_t pid) {
+    kill(pid, SIGKILL);
+    waitpid(pid, NULL, 0);
+}
+
+static void wait_for_name(pid_t pid) {
+    char path[64], comm[32];
+    snprintf(path, sizeof(path), "/proc/%d/comm", pid);
+    for (int i = 0; i < 1000; i++) {
+        FILE* f = fopen(path, "r");
+        if (f && fgets(comm, sizeof(comm), f) && strncmp(comm, CHILD_NAME, strlen(CHILD_NAME)) == 0) {
+            fclose(f);
+            return;
+        }
+        if (f) fclose(f);
+        usleep(1000);
+    }
+    assert(0 && "Child never renamed itself");
+}
+
+int main() {
+    printf("Testing pinned PID watch...\n");
+    pid_watch_t pw;
+    char buf[512];
+
+    assert(pid_watch_init(&pw, "") == -1);
+    assert(pid_watch_init(&pw, "999999999") == -1 && "No such PID");
+
+    // By PID
+    pid_t child = spawn_child();
+    wait_for_name(child);
+    char target[16];
+    snprintf(target, sizeof(target), "%d", child);
+    assert(pid_watch_init(&pw, target) == 0 && pw.pid == child);
+    assert(pid_watch_sample(&pw) == 1);
+    assert(strcmp(pw.stat.comm, CHILD_NAME) == 0 && pw.status.vm_rss_kb > 0);
+    assert(pw.fd_count >= 3 + CHILD_FILES);
+    usleep(200000);
+    assert(pid_watch_sample(&pw) == 1);
+    assert(pw.cpu_pct > 10.0f && "Spinning child uses CPU");
+    printf("  syscalls per sample: %lu\n", pw.syscalls);
+    assert(pw.syscalls <= 6 && "stat, status, io, lseek and getdents on cached fds");
+    assert(format_pid_watch(&pw, buf, sizeof(buf)) > 0 && strstr(buf, CHILD_NAME));
+
+    stop_child(child);
+    assert(pid_watch_sample(&pw) == 0 && pw.pid == 0 && "Exit detected");
+    assert(pid_watch_sample(&pw) == 0);
+    format_pid_watch(&pw, buf, sizeof(buf));
+    assert(strstr(buf, "not running"));
+    pid_watch_free(&pw);
+
+    // By name, following a restart
+    assert(pid_watch_init(&pw, CHILD_NAME) == 0);
+    assert(pid_watch_sample(&pw) == 0 && "Nothing to watch yet");
+    child = spawn_child();
+    wait_for_name(child);
+    assert(pid_watch_sample(&pw) == 1 && pw.pid == child);
+    stop_child(child);
+    pid_t restarted = spawn_child();
+    wait_for_name(restarted);
+    assert(pid_watch_sample(&pw) == 1 && pw.pid == restarted && pw.restarts == 1);
+    stop_child(restarted);
+    pid_watch_free(&pw);
+
+    printf("All PID watch tests passed!\n");
+    return 0;
+}
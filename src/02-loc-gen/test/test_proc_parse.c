@@ -0,0 +1,340 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include <time.h>
+#include "../proc_parse.h"
+#include "../proc_reader.h"
+
+#define FUZZ_ROUNDS 200000
+#define BENCH_SAMPLES 200000
+
+static const char stat_sample[] =
+    "cpu  10132153 290696 3084719 46828483 16683 0 25195 0 0 0\n"
+    "cpu0 1393280 32966 572056 13343292 6130 0 17875 0 0 0\n"
+    "cpu1 1335446 42138 424954 13463596 2982 0 3185 0 0 0\n"
+    "intr 199292772 34 9 0 0 0 0 3 0 1 0 0 0 0 0 0 0\n"
+    "ctxt 12547729\n"
+    "btime 1715436710\n"
+    "processes 1004203\n"
+    "procs_running 2\n"
+    "procs_blocked 1\n";
+
+static const char meminfo_sample[] =
+    "MemTotal:       16318460 kB\n"
+    "MemFree:         1234567 kB\n"
+    "MemAvailable:    9876543 kB\n"
+    "Buffers:          345678 kB\n"
+    "Cached:          4567890 kB\n"
+    "SwapCached:            0 kB\n"
+    "Active(anon):     111111 kB\n"
+    "SwapTotal:       2097148 kB\n"
+    "SwapFree:        2097148 kB\n"
+    "HugePages_Total:       0\n";
+
+static const char loadavg_sample[] = "0.52 1.05 12.75 3/467 123456\n";
+
+static const char diskstats_sample[] =
+    "   8       0 sda 1234 56 78901 2345 6789 12 345678 9012 0 3456 11357 0 0 0 0\n"
+    "   8       1 sda1 100 0 2000 30 40 0 500 60 0 70 90\n";
+
+static const char netdev_sample[] =
+    "Inter-|   Receive                                                |  Transmit\n"
+    " face |bytes    packets errs drop fifo frame compressed multicast|bytes    packets errs drop fifo colls carrier compressed\n"
+    "    lo: 12345678   98765    0    0    0     0          0         0 12345678   98765    0    0    0     0       0          0\n"
+    "  eth0:987654321 1234567    1    2    3     4          5         6 123456789  765432    7    8    9    10      11         12\n";
+
+static const char pid_stat_sample[] =
+    "4321 (my (odd) name) R 1 4321 4321 0 -1 4194560 900 0 2 0 250 75 0 0 20 0 7 0 123456 "
+    "104857600 2560 18446744073709551615 1 1 0 0 0 0 0 4096 0 0 0 0 17 3 0 0 0 0 0\n";
+
+static const char pid_status_sample[] =
+    "Name:\tsshd\n"
+    "VmRSS:\t    5120 kB\n"
+    "VmSwap:\t      12 kB\n"
+    "Threads:\t1\n"
+    "voluntary_ctxt_switches:\t150\n"
+    "nonvoluntary_ctxt_switches:\t3\n";
+
+static const char pid_io_sample[] =
+    "rchar: 1000\nwchar: 2000\nsyscr: 10\nsyscw: 20\n"
+    "read_bytes: 4096\nwrite_bytes: 8192\ncancelled_write_bytes: 0\n";
+
+static const char cg_io_sample[] =
+    "8:16 rbytes=1459200 wbytes=314773504 rios=192 wios=353 dbytes=0 dios=0\n"
+    "8:0 rbytes=90430464 wbytes=299008000 rios=8950 wios=1252 dbytes=50331648 dios=3021\n";
+
+static const char node_meminfo_sample[] =
+    "Node 0 MemTotal:        4685560 kB\n"
+    "Node 0 MemFree:         3389932 kB\n"
+    "Node 0 MemUsed:         1295628 kB\n"
+    "Node 0 Active(anon):         36 kB\n"
+    "Node 0 FilePages:        947008 kB\n"
+    "Node 0 AnonPages:        210200 kB\n"
+    "Node 0 Slab:              43812 kB\n"
+    "Node 0 HugePages_Total:     0\n";
+
+static const char numastat_sample[] =
+    "numa_hit 18807640\nnuma_miss 12\nnuma_foreign 3\n"
+    "interleave_hit 1023\nlocal_node 18807640\nother_node 12\n";
+
+static const char psi_sample[] =
+    "some avg10=30.20 avg60=10.94 avg300=5.67 total=111728161\n"
+    "full avg10=1.50 avg60=0.00 avg300=0.00 total=2041\n";
+
+static proc_stat_t stat_out;
+
+static void test_numbers(void) {
+    const char* cases[] = { "0", "7", "12345678", "123456789", "18446744073709551615", "  42x" };
+    const uint64_t expect[] = { 0, 7, 12345678, 123456789, 18446744073709551615ULL, 42 };
+    for (size_t i = 0; i < sizeof(cases) / sizeof(cases[0]); i++) {
+        const char* p = cases[i];
+        uint64_t v;
+        assert(proc_parse_u64(&p, cases[i] + strlen(cases[i]), &v) == 0);
+        assert(v == expect[i]);
+    }
+    const char* overflow = "18446744073709551616";
+    uint64_t v;
+    assert(proc_parse_u64(&overflow, overflow + strlen(overflow), &v) == -1);
+
+    const char text[] = "0123456789abcdef0123456789\nxyz";
+    assert(proc_find_newline(text, text + sizeof(text) - 1) == text + 26);
+    assert(proc_find_newline(text + 27, text + sizeof(text) - 1) == text + sizeof(text) - 1);
+    printf("✓ Number and newline scanning\n");
+}
+
+static void test_samples(void) {
+    assert(proc_parse_stat(stat_sample, sizeof(stat_sample) - 1, &stat_out) == 0);
+    assert(stat_out.total.user == 10132153 && stat_out.total.idle == 46828483);
+    assert(stat_out.cpu_count == 2 && stat_out.cpu_index[1] == 1);
+    assert(stat_out.cpu[1].softirq == 3185);
+    assert(stat_out.ctxt == 12547729 && stat_out.procs_running == 2 && stat_out.procs_blocked == 1);
+
+    proc_meminfo_t mem;
+    assert(proc_parse_meminfo(meminfo_sample, sizeof(meminfo_sample) - 1, &mem) == 0);
+    assert(mem.mem_total == 16318460 && mem.mem_free == 1234567 && mem.mem_available == 9876543);
+    assert(mem.swap_free == 2097148 && mem.active == 0);
+
+    proc_loadavg_t load;
+    assert(proc_parse_loadavg(loadavg_sample, sizeof(loadavg_sample) - 1, &load) == 0);
+    assert(load.load1 > 0.519 && load.load1 < 0.521 && load.load15 > 12.749 && load.load15 < 12.751);
+    assert(load.running == 3 && load.total == 467 && load.last_pid == 123456);
+
+    proc_disk_t disks[4];
+    assert(proc_parse_diskstats(diskstats_sample, sizeof(diskstats_sample) - 1, disks, 4) == 2);
+    assert(disks[0].major == 8 && strcmp(disks[0].name, "sda") == 0 && disks[0].weighted_io_ms == 11357);
+    assert(disks[1].minor == 1 && disks[1].sectors_written == 500);
+
+    proc_netdev_t devs[4];
+    assert(proc_parse_netdev(netdev_sample, sizeof(netdev_sample) - 1, devs, 4) == 2);
+    assert(strcmp(devs[1].name, "eth0") == 0 && devs[1].rx_bytes == 987654321);
+    assert(devs[1].tx_compressed == 12 && devs[0].tx_packets == 98765);
+
+    const char sysmon[] = "cpu_usage:45.2 memory_free:2048 processes:123\n";
+    proc_sysmon_t sm;
+    assert(proc_parse_sysmon(sysmon, sizeof(sysmon) - 1, &sm) == 0);
+    assert(sm.found == (PROC_SYSMON_CPU | PROC_SYSMON_MEMFREE | PROC_SYSMON_PROCS));
+    assert(sm.memory_free == 2048 && sm.processes == 123);
+
+    proc_pid_stat_t ps;
+    assert(proc_parse_pid_stat(pid_stat_sample, sizeof(pid_stat_sample) - 1, &ps) == 0);
+    assert(strcmp(ps.comm, "my (odd) name") == 0 && ps.state == 'R');
+    assert(ps.utime == 250 && ps.stime == 75 && ps.threads == 7);
+    assert(ps.start_time == 123456 && ps.vsize == 104857600 && ps.rss == 2560);
+
+    proc_pid_status_t st;
+    assert(proc_parse_pid_status(pid_status_sample, sizeof(pid_status_sample) - 1, &st) == 0);
+    assert(st.vm_rss_kb == 5120 && st.vm_swap_kb == 12);
+    assert(st.voluntary_ctxt_switches == 150 && st.nonvoluntary_ctxt_switches == 3);
+
+    proc_pid_io_t io;
+    assert(proc_parse_pid_io(pid_io_sample, sizeof(pid_io_sample) - 1, &io) == 0);
+    assert(io.rchar == 1000 && io.wchar == 2000 && io.read_bytes == 4096 && io.write_bytes == 8192);
+
+    proc_cg_io_t cg_io;
+    assert(proc_parse_cg_io(cg_io_sample, sizeof(cg_io_sample) - 1, &cg_io) == 0);
+    assert(cg_io.rbytes == 1459200 + 90430464ULL && cg_io.wios == 353 + 1252);
+
+    proc_psi_t psi;
+    assert(proc_parse_psi(psi_sample, sizeof(psi_sample) - 1, &psi) == 0);
+    assert(psi.some.avg10 > 30.199 && psi.some.avg10 < 30.201 && psi.some.avg300 > 5.669 && psi.some.avg300 < 5.671);
+    assert(psi.some.total == 111728161 && psi.has_full && psi.full.total == 2041);
+    // Kernels before 5.13 have no "full" line for cpu
+    assert(proc_parse_psi(psi_sample, 57, &psi) == 0 && !psi.has_full && psi.full.total == 0);
+
+    proc_offsets_t offs;
+    proc_node_meminfo_t node;
+    memset(&offs, 0, sizeof(offs));
+    for (int i = 0; i < 2; i++) {
+        assert(proc_parse_node_meminfo(node_meminfo_sample, sizeof(node_meminfo_sample) - 1, &offs, &node) == 0);
+        assert(node.mem_total == 4685560 && node.mem_used == 1295628 && node.slab == 43812);
+    }
+    assert(offs.learned && offs.relearns == 0);
+    // Offsets learned on one layout must not misread another
+    assert(proc_parse_node_meminfo(meminfo_sample, sizeof(meminfo_sample) - 1, &offs, &node) == 0);
+    assert(offs.relearns == 1 && node.mem_total == mem.mem_total && node.mem_used == 0);
+    proc_numastat_t numa;
+    assert(proc_parse_numastat(numastat_sample, sizeof(numastat_sample) - 1, NULL, &numa) == 0);
+    assert(numa.numa_hit == 18807640 && numa.numa_miss == 12 && numa.other_node == 12);
+    printf("✓ Sample files parse into the expected fields\n");
+}
+
+// Parse the live files and compare against sscanf
+static void test_live(void) {
+    proc_file_t pf;
+    assert(proc_file_open(&pf, "/proc/stat") == 0 && proc_file_read(&pf) > 0);
+    assert(proc_parse_stat(pf.buf, pf.len, &stat_out) == 0);
+    unsigned long long user, nice, system, idle;
+    assert(sscanf(pf.buf, "cpu %llu %llu %llu %llu", &user, &nice, &system, &idle) == 4);
+    assert(stat_out.total.user == user && stat_out.total.idle == idle);
+    proc_file_close(&pf);
+
+    assert(proc_file_open(&pf, "/proc/meminfo") == 0 && proc_file_read(&pf) > 0);
+    proc_meminfo_t mem;
+    unsigned long total;
+    assert(proc_parse_meminfo(pf.buf, pf.len, &mem) == 0);
+    assert(sscanf(pf.buf, "MemTotal: %lu kB", &total) == 1 && mem.mem_total == total);
+    proc_file_close(&pf);
+
+    proc_disk_t disks[PROC_MAX_DISKS];
+    proc_netdev_t devs[PROC_MAX_NET_IFACES];
+    if (proc_file_open_paged(&pf, "/proc/diskstats") == 0 && proc_file_read(&pf) >= 0) {
+        assert(proc_parse_diskstats(pf.buf, pf.len, disks, PROC_MAX_DISKS) >= 0);
+    }
+    proc_file_close(&pf);
+    if (proc_file_open_paged(&pf, "/proc/net/dev") == 0 && proc_file_read(&pf) > 0) {
+        assert(proc_parse_netdev(pf.buf, pf.len, devs, PROC_MAX_NET_IFACES) >= 1);
+    }
+    proc_file_close(&pf);
+    printf("✓ Live procfs files match sscanf\n");
+}
+
+// Random truncations and byte flips of the samples must never read out of
+// bounds; parse results are only checked for sanity. Run under ASan to catch overreads.
+static void fuzz_one(const char* sample, size_t len, unsigned* seed) {
+    char* buf = malloc(len);
+    memcpy(buf, sample, len);
+    int flips = rand_r(seed) % 4;
+    for (int i = 0; i < flips; i++) {
+        static const char alphabet[] = "0123456789 :\n./|x\t-";
+        buf[rand_r(seed) % len] = alphabet[rand_r(seed) % (sizeof(alphabet) - 1)];
+    }
+    size_t cut = len ? (size_t)rand_r(seed) % (len + 1) : 0;
+
+    proc_meminfo_t mem;
+    proc_loadavg_t load;
+    proc_disk_t disks[2];
+    proc_netdev_t devs[2];
+    proc_sysmon_t sm;
+    proc_pid_stat_t ps;
+    proc_pid_status_t st;
+    proc_pid_io_t io;
+    proc_cg_cpu_t cg_cpu;
+    proc_cg_memstat_t cg_mem;
+    proc_cg_io_t cg_io;
+    proc_psi_t psi;
+    static proc_offsets_t node_offs, numa_offs;     // carried across inputs on purpose
+    proc_node_meminfo_t node;
+    proc_numastat_t numa;
+    proc_parse_stat(buf, cut, &stat_out);
+    assert(stat_out.cpu_count <= PROC_MAX_CPUS);
+    proc_parse_meminfo(buf, cut, &mem);
+    proc_parse_loadavg(buf, cut, &load);
+    assert(proc_parse_diskstats(buf, cut, disks, 2) <= 2);
+    assert(proc_parse_netdev(buf, cut, devs, 2) <= 2);
+    proc_parse_sysmon(buf, cut, &sm);
+    proc_parse_pid_stat(buf, cut, &ps);
+    proc_parse_pid_status(buf, cut, &st);
+    proc_parse_pid_io(buf, cut, &io);
+    proc_parse_cg_cpu(buf, cut, &cg_cpu);
+    proc_parse_cg_memstat(buf, cut, &cg_mem);
+    proc_parse_cg_io(buf, cut, &cg_io);
+    proc_parse_psi(buf, cut, &psi);
+    proc_parse_node_meminfo(buf, cut, &node_offs, &node);
+    proc_parse_numastat(buf, cut, &numa_offs, &numa);
+    free(buf);
+}
+
+static void test_fuzz(void) {
+    const char* samples[] = { stat_sample, meminfo_sample, loadavg_sample, diskstats_sample, netdev_sample,
+                              pid_stat_sample, pid_status_sample, pid_io_sample, cg_io_sample, psi_sample,
+                              node_meminfo_sample, numastat_sample };
+    int count = sizeof(samples) / sizeof(samples[0]);
+    unsigned seed = 12345;
+    for (int i = 0; i < FUZZ_ROUNDS; i++) {
+        const char* s = samples[i % count];
+        fuzz_one(s, strlen(s), &seed);
+    }
+    printf("✓ %d fuzzed inputs handled\n", FUZZ_ROUNDS);
+}
+
+static double now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+// What the collectors did before: line-by-line sscanf/strncmp
+static unsigned long long old_stat(const char* buf) {
+    unsigned long long user = 0, nice, system, idle, iowait, irq, softirq, steal;
+    sscanf(buf, "cpu %llu %llu %llu %llu %llu %llu %llu %llu",
+           &user, &nice, &system, &idle, &iowait, &irq, &softirq, &steal);
+    return user;
+}
+
+static unsigned long old_meminfo(const char* buf) {
+    char line[256];
+    unsigned long total = 0, free_kb = 0, avail = 0;
+    const char* p = buf;
+    while (*p) {
+        const char* eol = strchr(p, '\n');
+        size_t n = eol ? (size_t)(eol - p) : strlen(p);
+        if (n >= sizeof(line)) n = sizeof(line) - 1;
+        memcpy(line, p, n);
+        line[n] = '\0';
+        if (strncmp(line, "MemTotal:", 9) == 0) sscanf(line, "MemTotal: %lu kB", &total);
+        else if (strncmp(line, "MemFree:", 8) == 0) sscanf(line, "MemFree: %lu kB", &free_kb);
+        else if (strncmp(line, "MemAvailable:", 13) == 0) sscanf(line, "MemAvailable: %lu kB", &avail);
+        p = eol ? eol + 1 : p + n;
+    }
+    return total + free_kb + avail;
+}
+
+static void bench(void) {
+    volatile unsigned long long sink = 0;
+    proc_meminfo_t mem;
+
+    double t0 = now_ns();
+    for (int i = 0; i < BENCH_SAMPLES; i++) sink += old_stat(stat_sample);
+    double t1 = now_ns();
+    for (int i = 0; i < BENCH_SAMPLES; i++) {
+        proc_parse_stat(stat_sample, sizeof(stat_sample) - 1, &stat_out);
+        sink += stat_out.total.user;
+    }
+    double t2 = now_ns();
+    for (int i = 0; i < BENCH_SAMPLES; i++) sink += old_meminfo(meminfo_sample);
+    double t3 = now_ns();
+    for (int i = 0; i < BENCH_SAMPLES; i++) {
+        proc_parse_meminfo(meminfo_sample, sizeof(meminfo_sample) - 1, &mem);
+        sink += mem.mem_total;
+    }
+    double t4 = now_ns();
+
+    printf("Benchmark (%d samples):\n", BENCH_SAMPLES);
+    printf("  /proc/stat    sscanf (total line only): %6.0f ns, proc_parse_stat (all lines): %6.0f ns\n",
+           (t1 - t0) / BENCH_SAMPLES, (t2 - t1) / BENCH_SAMPLES);
+    printf("  /proc/meminfo fgets+sscanf (3 keys):    %6.0f ns, proc_parse_meminfo (13 keys): %6.0f ns\n",
+           (t3 - t2) / BENCH_SAMPLES, (t4 - t3) / BENCH_SAMPLES);
+    (void)sink;
+}
+
+int main() {
+    printf("Testing procfs parsers...\n");
+    test_numbers();
+    test_samples();
+    test_live();
+    test_fuzz();
+    bench();
+    printf("All procfs parser tests passed!\n");
+    return 0;
+}
@@ -0,0 +1,129 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include <time.h>
+#include "../proc_rank.h"
+
+#define SIMULATED 100000
+#define TICKS 100
+#define CHANGED_PER_TICK 2000   // busy processes; the rest stay idle
+#define TOP_N 10
+
+static double keys[SIMULATED];
+static int present[SIMULATED];
+
+static double now_sec(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static int by_key_desc(const void* a, const void* b) {
+    double ka = keys[*(const int32_t*)a], kb = keys[*(const int32_t*)b];
+    return (ka < kb) - (ka > kb);
+}
+
+// Reference ranking: sort every present slot
+static int sorted_top(int n, int32_t* out, int32_t* scratch) {
+    int count = 0;
+    for (int i = 0; i < SIMULATED; i++) {
+        if (present[i]) scratch[count++] = i;
+    }
+    qsort(scratch, (size_t)count, sizeof(int32_t), by_key_desc);
+    if (n > count) n = count;
+    memcpy(out, scratch, sizeof(int32_t) * (size_t)n);
+    return n;
+}
+
+static void check_heap(const proc_rank_t* rank) {
+    for (int32_t i = 1; i < rank->size; i++) {
+        assert(rank->key[rank->heap[(i - 1) / 2]] >= rank->key[rank->heap[i]]);
+        assert(rank->pos[rank->heap[i]] == i);
+    }
+}
+
+int main() {
+    printf("Testing incremental top-N ranking...\n");
+    proc_rank_t rank;
+    assert(proc_rank_init(&rank, 8) == 0);
+    int32_t top[TOP_N];
+    assert(proc_rank_top(&rank, 3, top) == 0);
+
+    proc_rank_update(&rank, 0, 5);
+    proc_rank_update(&rank, 1, 9);
+    proc_rank_update(&rank, 2, 1);
+    proc_rank_update(&rank, 3, 7);
+    assert(proc_rank_top(&rank, 3, top) == 3 && top[0] == 1 && top[1] == 3 && top[2] == 0);
+    proc_rank_update(&rank, 2, 10);     // moves up
+    proc_rank_update(&rank, 1, 0);      // moves down
+    proc_rank_remove(&rank, 3);
+    proc_rank_remove(&rank, 3);         // already gone
+    assert(proc_rank_top(&rank, 10, top) == 3 && top[0] == 2 && top[1] == 0 && top[2] == 1);
+    assert(proc_rank_reserve(&rank, 16) == 0 && rank.pos[15] == -1);
+    proc_rank_free(&rank);
+
+    // Random churn against a full sort
+    srand(42);
+    assert(proc_rank_init(&rank, SIMULATED) == 0);
+    int32_t expect[TOP_N];
+    int32_t* scratch = malloc(sizeof(int32_t) * SIMULATED);
+    for (int step = 0; step < 20000; step++) {
+        int32_t slot = rand() % 1000;
+        if (rand() % 4 == 0) {
+            proc_rank_remove(&rank, slot);
+            present[slot] = 0;
+        } else {
+            // Distinct keys so the order is unambiguous
+            keys[slot] = (double)(rand() % 100000) + slot * 1e-6;
+            proc_rank_update(&rank, slot, keys[slot]);
+            present[slot] = 1;
+        }
+        if (step % 1000 == 0) {
+            check_heap(&rank);
+            int n = sorted_top(TOP_N, expect, scratch);
+            assert(proc_rank_top(&rank, TOP_N, top) == n);
+            assert(memcmp(top, expect, sizeof(int32_t) * (size_t)n) == 0);
+        }
+    }
+    proc_rank_free(&rank);
+    memset(present, 0, sizeof(present));
+
+    // 100k processes, a few thousand change per tick, one top-10 per tick
+    assert(proc_rank_init(&rank, SIMULATED) == 0);
+    for (int i = 0; i < SIMULATED; i++) {
+        keys[i] = (double)(rand() % 1000) / 100.0 + i * 1e-9;
+        present[i] = 1;
+        proc_rank_update(&rank, i, keys[i]);
+    }
+    double start = now_sec();
+    for (int t = 0; t < TICKS; t++) {
+        for (int c = 0; c < CHANGED_PER_TICK; c++) {
+            int32_t slot = rand() % SIMULATED;
+            keys[slot] = (double)(rand() % 10000) / 100.0 + slot * 1e-9;
+            proc_rank_update(&rank, slot, keys[slot]);
+        }
+        proc_rank_top(&rank, TOP_N, top);
+    }
+    double heap_us = (now_sec() - start) * 1e6 / TICKS;
+
+    start = now_sec();
+    for (int t = 0; t < TICKS / 10; t++) sorted_top(TOP_N, expect, scratch);
+    double sort_us = (now_sec() - start) * 1e6 / (TICKS / 10);
+    assert(memcmp(top, expect, sizeof(top)) == 0);
+    check_heap(&rank);
+
+    start = now_sec();
+    for (int t = 0; t < 10000; t++) proc_rank_top(&rank, TOP_N, top);
+    double query_us = (now_sec() - start) * 1e6 / 10000;
+
+    printf("Benchmark (%d processes, %d changed per tick):\n", SIMULATED, CHANGED_PER_TICK);
+    printf("  indexed heap: %8.1f us per tick (updates + top-%d), %.2f us per query\n",
+           heap_us, TOP_N, query_us);
+    printf("  full sort:    %8.1f us per query\n", sort_us);
+    proc_rank_free(&rank);
+    free(scratch);
+
+    printf("All ranking tests passed!\n");
+    return 0;
+}
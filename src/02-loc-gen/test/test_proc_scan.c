@@ -0,0 +1,149 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include <math.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include "../proc_scan.h"
+
+#define MANY_PROCESSES 20000
+#define SECOND 1000000000ULL
+
+static char root[64];
+
+static void write_file(int pid, const char* name, const char* text) {
+    char path[128];
+    snprintf(path, sizeof(path), "%s/%d/%s", root, pid, name);
+    FILE* f = fopen(path, "w");
+    assert(f);
+    fputs(text, f);
+    fclose(f);
+}
+
+static void make_process(int pid, const char* comm, uint64_t cpu, uint64_t start, uint64_t rss) {
+    char path[128], text[512];
+    snprintf(path, sizeof(path), "%s/%d", root, pid);
+    mkdir(path, 0755);
+    snprintf(text, sizeof(text),
+             "%d (%s) S 1 %d %d 0 -1 4194560 100 0 0 0 %llu %llu 0 0 20 0 3 0 %llu 1048576 %llu "
+             "18446744073709551615 1 1 0 0 0 0 0 0 0 0 0 0 17 0 0 0 0 0 0\n",
+             pid, comm, pid, pid, (unsigned long long)(cpu / 2), (unsigned long long)(cpu - cpu / 2),
+             (unsigned long long)start, (unsigned long long)rss);
+    write_file(pid, "stat", text);
+    snprintf(text, sizeof(text), "256 %llu 10 1 0 20 0\n", (unsigned long long)rss);
+    write_file(pid, "statm", text);
+}
+
+static void remove_process(int pid) {
+    char path[128];
+    snprintf(path, sizeof(path), "%s/%d/stat", root, pid);
+    unlink(path);
+    snprintf(path, sizeof(path), "%s/%d/statm", root, pid);
+    unlink(path);
+    snprintf(path, sizeof(path), "%s/%d", root, pid);
+    rmdir(path);
+}
+
+static double now_sec(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+int main() {
+    printf("Testing process scanner...\n");
+    double hz = (double)sysconf(_SC_CLK_TCK);
+    strcpy(root, "/tmp/proc_scan_XXXXXX");
+    assert(mkdtemp(root));
+
+    make_process(100, "worker one", 1000, 50, 40);     // comm with a space
+    make_process(200, "a)b", 0, 60, 80);               // and with a paren
+    char path[128];
+    snprintf(path, sizeof(path), "%s/self", root);
+    mkdir(path, 0755);                                  // not a PID
+
+    proc_scan_t ps;
+    assert(proc_scan_init(&ps, root, 0) == 0);
+    assert(proc_scan_tick_at(&ps, 1 * SECOND) == 2);
+    const proc_task_t* t = proc_scan_find(&ps, 100);
+    assert(t && strcmp(t->comm, "worker one") == 0 && t->state == 'S');
+    assert(t->cpu_pct == 0 && "No previous sample");
+    assert(t->rss_pages == 40 && t->threads == 3 && t->vsize == 1048576);
+    assert(strcmp(proc_scan_find(&ps, 200)->comm, "a)b") == 0);
+
+    // One second later pid 100 used half a CPU; pid 200 exits and its PID is reused
+    make_process(100, "worker one", 1000 + (uint64_t)(hz / 2), 50, 40);
+    remove_process(200);
+    make_process(300, "new", 500, 70, 10);
+    assert(proc_scan_tick_at(&ps, 2 * SECOND) == 2);
+    assert(fabsf(proc_scan_find(&ps, 100)->cpu_pct - 50.0f) < 0.01f);
+    assert(!proc_scan_find(&ps, 200) && proc_scan_find(&ps, 300));
+    remove_process(300);
+    make_process(300, "reused", 900, 99, 10);
+    assert(proc_scan_tick_at(&ps, 3 * SECOND) == 2);
+    assert(proc_scan_find(&ps, 300)->cpu_pct == 0 && "Reused PID starts over");
+    const proc_task_t* top[3];
+    assert(proc_scan_top(&ps, PROC_SCAN_BY_CPU, 3, top) == 2 && top[0]->pid == 100);
+    assert(proc_scan_top(&ps, PROC_SCAN_BY_MEM, 1, top) == 1 && top[0]->pid == 100);
+    assert(ps.total_threads == 6);
+    proc_scan_free(&ps);
+
+    // Enough processes to grow the tables and shard across workers; the
+    // pooled scan must agree with the single-threaded one
+    for (int pid = 1000; pid < 1000 + MANY_PROCESSES; pid++) {
+        make_process(pid, "bulk", (uint64_t)pid, (uint64_t)pid, 1);
+    }
+    proc_scan_t serial, pooled;
+    assert(proc_scan_init(&serial, root, 0) == 0);
+    assert(proc_scan_init(&pooled, root, 4) == 0 && pooled.worker_count == 4);
+    double start = now_sec();
+    assert(proc_scan_tick_at(&serial, SECOND) == MANY_PROCESSES + 2);
+    double serial_ms = (now_sec() - start) * 1e3;
+    start = now_sec();
+    assert(proc_scan_tick_at(&pooled, SECOND) == MANY_PROCESSES + 2);
+    printf("  %d synthetic processes: %.1f ms serial, %.1f ms with 4 workers\n",
+           MANY_PROCESSES, serial_ms, (now_sec() - start) * 1e3);
+    for (int pid = 1000; pid < 1000 + MANY_PROCESSES; pid += 2) {
+        make_process(pid, "bulk", (uint64_t)pid + (uint64_t)hz, (uint64_t)pid, 1);
+        remove_process(pid + 1);
+    }
+    int live = MANY_PROCESSES / 2 + 2;
+    assert(proc_scan_tick_at(&serial, 2 * SECOND) == live);
+    assert(proc_scan_tick_at(&pooled, 2 * SECOND) == live);
+    for (int pid = 1000; pid < 1000 + MANY_PROCESSES; pid++) {
+        const proc_task_t* a = proc_scan_find(&serial, pid);
+        const proc_task_t* b = proc_scan_find(&pooled, pid);
+        assert((a == NULL) == (pid & 1) && (b == NULL) == (pid & 1));
+        if (a) assert(fabsf(a->cpu_pct - 100.0f) < 0.01f && a->cpu_pct == b->cpu_pct);
+    }
+    proc_scan_free(&serial);
+    proc_scan_free(&pooled);
+
+    for (int pid = 100; pid < 1000 + MANY_PROCESSES; pid++) {
+        snprintf(path, sizeof(path), "%s/%d", root, pid);
+        if (access(path, F_OK) == 0) remove_process(pid);
+    }
+    snprintf(path, sizeof(path), "%s/self", root);
+    rmdir(path);
+    rmdir(root);
+
+    // Live /proc: we are in it
+    int workers[2] = { 0, 4 };
+    for (int w = 0; w < 2; w++) {
+        assert(proc_scan_init(&ps, "/proc", workers[w]) == 0);
+        assert(proc_scan_tick(&ps) > 0);
+        const proc_task_t* self = proc_scan_find(&ps, getpid());
+        assert(self && strncmp(self->comm, "test_proc_scan", 14) == 0 && self->rss_pages > 0);
+        int rounds = 50;
+        start = now_sec();
+        for (int i = 0; i < rounds; i++) proc_scan_tick(&ps);
+        printf("  /proc with %d workers: %d processes, %.0f us per scan\n", workers[w],
+               ps.task_count, (now_sec() - start) * 1e6 / rounds);
+        proc_scan_free(&ps);
+    }
+
+    printf("All process scanner tests passed!\n");
+    return 0;
+}
@@ -1,6 +1,34 @@
 #include <stdio.h>
 #include <assert.h>
 #include "../room_manager.h"
+#include "../plugin_registry.h"
+
+static int fake_samples = 0;
+
+static const metric_desc_t fake_metrics[] = {
+    { "samples", "", METRIC_U64, METRIC_COUNTER },
+};
+
+static void* fake_init(const char* target) {
+    static int state;
+    return target && target[0] == '!' ? NULL : &state;
+}
+
+static int fake_sample(void* state, metric_value_t* values) {
+    (void)state;
+    values[0].u64 = (uint64_t)++fake_samples;
+    return 0;
+}
+
+static const collector_ops_t fake_ops = {
+    .abi_version = COLLECTOR_ABI_VERSION,
+    .name = "fake-room",
+    .metrics = fake_metrics,
+    .metric_count = 1,
+    .interval_ms = 500,
+    .init = fake_init,
+    .sample = fake_sample,
+};
 
 int main() {
     printf("Testing room creation...\n");
@@ -8,10 +36,12 @@ int main() {
     int cpu_room = create_room("cpu-room", 1000);
     int mem_room = create_room("memory-room", 2000);
     int inf_room = create_room("inf-stats-room", 3000);
+    int core_room = create_room("cpu-core-room", 1000);
 
     assert(cpu_room >= 0 && "Failed to create cpu-room");
     assert(mem_room >= 0 && "Failed to create memory-room");
     assert(inf_room >= 0 && "Failed to create inf-stats-room");
+    assert(core_room >= 0 && "Failed to create cpu-core-room");
 
     printf("Testing start/stop monitoring...\n");
     assert(start_monitoring(cpu_room) == 0 && "Start cpu-room fail");
@@ -23,6 +53,30 @@ int main() {
     assert(start_monitoring(inf_room) == 0 && "Start inf-stats-room fail");
     assert(stop_monitoring(inf_room) == 0 && "Stop inf-stats-room fail");
 
+    printf("Testing show room data...\n");
+    show_room_data(cpu_room);
+    show_room_data(cpu_room);
+    show_room_data(inf_room);
+    show_room_data(inf_room);
+    show_room_data(core_room);
+    show_room_data(core_room);
+    int ids[5];
+    float utils[5];
+    assert(room_top_cores(core_room, 5, ids, utils) > 0 && "Top cores query failed");
+    assert(room_top_cores(cpu_room, 5, ids, utils) == -1);
+
+    printf("Testing plugin room types...\n");
+    assert(create_room("fake-room", 500) == -1);
+    assert(plugin_register(&fake_ops) >= 0);
+    int fake_room = create_room("fake-room", 500);
+    assert(fake_room >= 0 && "Failed to create plugin room");
+    show_room_data(fake_room);
+    show_room_data(fake_room);
+    assert(fake_samples == 2);
+    assert(create_targeted_room("fake-room", "!refused", 500) == -1);
+    assert(delete_room(fake_room) == 0);
+    list_room_types();
+
     printf("Testing delete room...\n");
     assert(delete_room(cpu_room) == 0 && "Delete cpu-room fail");
 
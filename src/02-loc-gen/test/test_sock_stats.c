@@ -0,0 +1,172 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include <time.h>
+#include <unistd.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include "../sock_stats.h"
+
+#define SYNTHETIC_SOCKETS 200000
+#define LISTENERS 500
+#define BENCH_ROUNDS 20
+
+static const char* small_table =
+    "  sl  local_address rem_address   st tx_queue rx_queue tr tm->when retrnsmt   uid  timeout inode\n"
+    "   0: 0100007F:1F90 00000000:0000 0A 00000000:00000000 00:00000000 00000000  1000        0 1 1\n"
+    "   1: 0100007F:1F90 0100007F:C350 01 00000000:00000000 00:00000000 00000000  1000        0 2 1\n"
+    "   2: 0100007F:1F90 0100007F:C351 01 00000000:00000000 00:00000000 00000000  1000        0 3 1\n"
+    "   3: 0100007F:0016 0100007F:C352 06 00000000:00000000 00:00000000 00000000     0        0 0 3\n";
+
+static const char* small_table6 =
+    "  sl  local_address                         remote_address                        st\n"
+    "   0: 00000000000000000000000001000000:0050 00000000000000000000000000000000:0000 0A\n";
+
+static double now_sec(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static char* synthetic_table(int sockets, size_t* len) {
+    char* buf = malloc((size_t)sockets * 160 + 200);
+    size_t off = (size_t)sprintf(buf, "  sl  local_address rem_address   st tx_queue rx_queue tr "
+                                      "tm->when retrnsmt   uid  timeout inode\n");
+    for (int i = 0; i < sockets; i++) {
+        // Proxy box: most sockets established on a few frontend ports
+        int state = (i % 10 == 0) ? 6 : 1;
+        off += (size_t)sprintf(buf + off, "%6d: 0A00000%d:%04X 0A0000%02X:%04X %02X 00000000:00000000 "
+                               "00:00000000 00000000  1000        0 %d 1 0000000000000000 20 4 30 10 -1\n",
+                               i, i % 8, 8080 + i % 4, i % 251, 1024 + i % 60000, state, 100000 + i);
+    }
+    *len = off;
+    return buf;
+}
+
+int main() {
+    printf("Testing socket statistics...\n");
+    sock_stats_t ss;
+    assert(sock_stats_init(&ss, 0) == 0);
+
+    assert(sock_stats_parse_proc(&ss, small_table, strlen(small_table), SOCK_PROTO_TCP) == 4);
+    assert(sock_stats_parse_proc(&ss, small_table6, strlen(small_table6), SOCK_PROTO_TCP) == 1);
+    assert(ss.tcp_states[SOCK_TCP_LISTEN] == 2);
+    assert(ss.tcp_states[SOCK_TCP_ESTABLISHED] == 2);
+    assert(ss.tcp_states[6] == 1 && strcmp(sock_tcp_state_name(6), "TIME_WAIT") == 0);
+    assert(ss.ports[SOCK_PROTO_TCP].count[8080] == 3);
+    assert(ss.ports[SOCK_PROTO_TCP].count[80] == 1);
+
+    uint16_t ports[3];
+    uint32_t counts[3];
+    assert(sock_stats_top_ports(&ss, SOCK_PROTO_TCP, 3, ports, counts) == 3);
+    assert(ports[0] == 8080 && counts[0] == 3 && counts[1] == 1);
+
+    char buf[1024];
+    int n = format_sock_stats(&ss, buf, sizeof(buf));
+    assert(n > 0 && strstr(buf, "ESTABLISHED") && strstr(buf, "8080(3)"));
+
+    sock_stats_reset(&ss);
+    assert(ss.ports[SOCK_PROTO_TCP].count[8080] == 0 && ss.tcp_states[SOCK_TCP_LISTEN] == 0);
+    assert(sock_stats_parse_proc(&ss, "header only\n", 12, SOCK_PROTO_TCP) == 0);
+    assert(sock_stats_parse_proc(&ss, "h\n   0: garbage\n", 16, SOCK_PROTO_TCP) == -1);
+    sock_stats_free(&ss);
+
+    // State filter: only listeners are counted
+    assert(sock_stats_init(&ss, SOCK_STATE_BIT(SOCK_TCP_LISTEN)) == 0);
+    assert(sock_stats_parse_proc(&ss, small_table, strlen(small_table), SOCK_PROTO_TCP) == 1);
+    sock_stats_free(&ss);
+
+    // Live: both sources see the listeners we open
+    static int fds[LISTENERS];
+    int base_port = 0;
+    for (int i = 0; i < LISTENERS; i++) {
+        fds[i] = socket(AF_INET, SOCK_STREAM, 0);
+        struct sockaddr_in addr;
+        memset(&addr, 0, sizeof(addr));
+        addr.sin_family = AF_INET;
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        assert(fds[i] >= 0 && bind(fds[i], (struct sockaddr*)&addr, sizeof(addr)) == 0);
+        assert(listen(fds[i], 1) == 0);
+    }
+    struct sockaddr_in bound;
+    socklen_t bound_len = sizeof(bound);
+    getsockname(fds[0], (struct sockaddr*)&bound, &bound_len);
+    base_port = ntohs(bound.sin_port);
+
+    assert(sock_stats_init(&ss, SOCK_STATE_BIT(SOCK_TCP_LISTEN)) == 0);
+    int from_procfs = sock_stats_collect(&ss, SOCK_SOURCE_PROCFS);
+    assert(from_procfs >= LISTENERS && ss.ports[SOCK_PROTO_TCP].count[base_port] >= 1);
+    if (ss.source == SOCK_SOURCE_DIAG) {
+        uint32_t listen_procfs = ss.tcp_states[SOCK_TCP_LISTEN];
+        assert(sock_stats_collect(&ss, SOCK_SOURCE_DIAG) >= LISTENERS);
+        assert(ss.source == SOCK_SOURCE_DIAG && "sock_diag dump works");
+        assert(ss.tcp_states[SOCK_TCP_LISTEN] == listen_procfs);
+        assert(ss.tcp_states[SOCK_TCP_ESTABLISHED] == 0 && "Kernel-side state filter");
+        assert(ss.ports[SOCK_PROTO_TCP].count[base_port] >= 1);
+
+        printf("Benchmark (%u listening sockets, %d rounds):\n", listen_procfs, BENCH_ROUNDS);
+        double start = now_sec();
+        for (int i = 0; i < BENCH_ROUNDS; i++) sock_stats_collect(&ss, SOCK_SOURCE_DIAG);
+        printf("  sock_diag:     %8.0f us per collection\n", (now_sec() - start) * 1e6 / BENCH_ROUNDS);
+        start = now_sec();
+        for (int i = 0; i < BENCH_ROUNDS; i++) sock_stats_collect(&ss, SOCK_SOURCE_PROCFS);
+        printf("  /proc/net:     %8.0f us per collection\n", (now_sec() - start) * 1e6 / BENCH_ROUNDS);
+    } else {
+        printf("sock_diag unavailable, only /proc/net checked\n");
+    }
+    sock_stats_free(&ss);
+    for (int i = 0; i < LISTENERS; i++) close(fds[i]);
+
+    // A root without tcp6/udp6, as on kernels built without IPv6
+    char root[64];
+    strcpy(root, "/tmp/sock_stats_XXXXXX");
+    assert(mkdtemp(root));
+    const char* names[2] = { "tcp", "udp" };
+    for (int i = 0; i < 2; i++) {
+        char path[128];
+        snprintf(path, sizeof(path), "%s/%s", root, names[i]);
+        FILE* f = fopen(path, "w");
+        assert(f);
+        fputs(small_table, f);
+        fclose(f);
+    }
+    assert(sock_stats_init(&ss, 0) == 0);
+    assert(sock_stats_set_proc_root(&ss, root) == 0);
+    assert(sock_stats_collect(&ss, SOCK_SOURCE_PROCFS) == 8);
+    assert(ss.tcp_states[SOCK_TCP_LISTEN] == 1 && ss.ports[SOCK_PROTO_UDP].total == 4);
+    assert(sock_stats_collect(&ss, SOCK_SOURCE_PROCFS) == 8);
+    sock_stats_free(&ss);
+
+    // Without the IPv4 tables the fallback still fails
+    char path[128];
+    snprintf(path, sizeof(path), "%s/tcp", root);
+    unlink(path);
+    assert(sock_stats_init(&ss, 0) == 0);
+    assert(sock_stats_set_proc_root(&ss, root) == 0);
+    assert(sock_stats_collect(&ss, SOCK_SOURCE_PROCFS) == -1);
+    sock_stats_free(&ss);
+    snprintf(path, sizeof(path), "%s/udp", root);
+    unlink(path);
+    rmdir(root);
+
+    // A proxy-sized /proc/net/tcp
+    size_t len;
+    char* table = synthetic_table(SYNTHETIC_SOCKETS, &len);
+    assert(sock_stats_init(&ss, 0) == 0);
+    double start = now_sec();
+    for (int i = 0; i < BENCH_ROUNDS; i++) {
+        sock_stats_reset(&ss);
+        assert(sock_stats_parse_proc(&ss, table, len, SOCK_PROTO_TCP) == SYNTHETIC_SOCKETS);
+    }
+    printf("  %d-line /proc/net/tcp parse: %.1f ms (%.1f MB)\n", SYNTHETIC_SOCKETS,
+           (now_sec() - start) * 1e3 / BENCH_ROUNDS, len / 1e6);
+    assert(ss.tcp_states[6] == SYNTHETIC_SOCKETS / 10);
+    assert(ss.ports[SOCK_PROTO_TCP].count[8080] == SYNTHETIC_SOCKETS / 4);
+    sock_stats_free(&ss);
+    free(table);
+
+    printf("All socket statistics tests passed!\n");
+    return 0;
+}
@@ -50,10 +50,10 @@ int handle_command(const char *command, char *response, size_t response_size) {
     }
     else if (strcmp(cmd, "SHOW") == 0) {
         if (parsed < 2) {
-            list_rooms(response, response_size);
-        } else {
-            cmd_show_room(room_name, response, response_size);
+            // Every room can outgrow the response buffer
+            return HANDLE_STREAM_ROOM_LIST;
         }
+        cmd_show_room(room_name, response, response_size);
         return 0;
     }
     else if (strcmp(cmd, "EXIT") == 0) {
@@ -234,26 +234,53 @@ int remove_room(const char *room_name) {
     return 0;
 }
 
-void list_rooms(char *response, size_t response_size) {
-    int offset = 0;
-    int i;
-    
-    offset += snprintf(response + offset, response_size - offset, "OK Rooms:\n");
-    
-    pthread_mutex_lock(&rooms_mutex);
-    
-    if (room_count == 0) {
-        snprintf(response + offset, response_size - offset, "No rooms created");
-    } else {
-        for (i = 0; i < room_count && offset < (int)response_size - 1; i++) {
-            if (rooms[i].active) {
-                offset += snprintf(response + offset, response_size - offset,
-                                 "  %s: size=%d, status=%s\n",
-                                 rooms[i].name, rooms[i].size, 
-                                 room_status_string(rooms[i].status));
-            }
+static int send_all(int sockfd, const char *data, size_t len) {
+    while (len > 0) {
+        ssize_t sent = send(sockfd, data, len, MSG_NOSIGNAL);
+        if (sent < 0) {
+            if (errno == EINTR) continue;
+            return -1;
+        }
+        data += sent;
+        len -= (size_t)sent;
+    }
+    return 0;
+}
+
+// Reply to a bare SHOW with no BUFFER_SIZE limit: each chunk is filled
+// under rooms_mutex and sent after dropping it, so the list costs one pass
+// however many rooms there are and send() blocking on a slow client never
+// holds up room commands
+int stream_room_list(int sockfd) {
+    char chunk[BUFFER_SIZE];
+    size_t len = (size_t)snprintf(chunk, sizeof(chunk), "OK Rooms:\n");
+    int listed = 0;
+    int i = 0;
+    int done = 0;
+    
+    while (!done) {
+        pthread_mutex_lock(&rooms_mutex);
+        for (; i < room_count; i++) {
+            if (!rooms[i].active) continue;
+            int n = snprintf(chunk + len, sizeof(chunk) - len,
+                             "  %s: size=%d, status=%s\n",
+                             rooms[i].name, rooms[i].size,
+                             room_status_string(rooms[i].status));
+            if (n < 0 || (size_t)n >= sizeof(chunk) - len) break;
+            len += (size_t)n;
+            listed++;
+        }
+        done = i >= room_count;
+        pthread_mutex_unlock(&rooms_mutex);
+        
+        if (!done) {
+            if (send_all(sockfd, chunk, len) != 0) return -1;
+            len = 0;
         }
     }
     
-    pthread_mutex_unlock(&rooms_mutex);
+    if (listed == 0) {
+        len += (size_t)snprintf(chunk + len, sizeof(chunk) - len, "No rooms created");
+    }
+    return send_all(sockfd, chunk, len);
 }
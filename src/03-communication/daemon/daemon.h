@@ -45,6 +45,7 @@ typedef struct {
     int sockfd;
     struct sockaddr_in addr;
     pthread_t thread_id;
+    int in_use;         // 1 while a handler thread owns this slot
 } client_conn_t;
 
 // Global variables
@@ -65,6 +66,10 @@ int server_listen(int server_fd);
 void *handle_client(void *arg);
 
 // Command handler functions
+// handle_command() returns 1 for EXIT and HANDLE_STREAM_ROOM_LIST when the
+// caller should stream the room list with stream_room_list() instead of
+// sending `response`
+#define HANDLE_STREAM_ROOM_LIST 2
 int handle_command(const char *command, char *response, size_t response_size);
 int cmd_create_room(const char *room_name, int room_size, char *response, size_t response_size);
 int cmd_start_room(const char *room_name, char *response, size_t response_size);
@@ -76,7 +81,7 @@ int cmd_exit_daemon(char *response, size_t response_size);
 room_t *find_room(const char *room_name);
 int add_room(const char *room_name, int room_size);
 int remove_room(const char *room_name);
-void list_rooms(char *response, size_t response_size);
+int stream_room_list(int sockfd);
 
 // Utility functions
 void log_message(int priority, const char *format, ...);
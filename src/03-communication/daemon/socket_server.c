@@ -1,5 +1,30 @@
 #include "daemon.h"
 
+// Connection slots handed to client threads instead of malloc'ing one per
+// accept; a client beyond MAX_CLIENTS is turned away
+static client_conn_t conn_pool[MAX_CLIENTS];
+static pthread_mutex_t conn_pool_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+static client_conn_t *conn_acquire(void) {
+    client_conn_t *conn = NULL;
+    pthread_mutex_lock(&conn_pool_mutex);
+    for (int i = 0; i < MAX_CLIENTS; i++) {
+        if (!conn_pool[i].in_use) {
+            conn = &conn_pool[i];
+            conn->in_use = 1;
+            break;
+        }
+    }
+    pthread_mutex_unlock(&conn_pool_mutex);
+    return conn;
+}
+
+static void conn_release(client_conn_t *conn) {
+    pthread_mutex_lock(&conn_pool_mutex);
+    conn->in_use = 0;
+    pthread_mutex_unlock(&conn_pool_mutex);
+}
+
 int server_init(void) {
     int server_fd;
     struct sockaddr_in server_addr;
@@ -74,10 +99,10 @@ int server_listen(int server_fd) {
         log_message(LOG_INFO, "Client connected from %s:%d", 
                    client_ip, ntohs(client_addr.sin_port));
         
-        // Create client connection structure
-        client_conn = malloc(sizeof(client_conn_t));
+        // Take a connection slot for the client
+        client_conn = conn_acquire();
         if (client_conn == NULL) {
-            log_message(LOG_ERR, "Failed to allocate memory for client connection");
+            log_message(LOG_WARNING, "Max clients reached, rejecting %s", client_ip);
             close(client_fd);
             continue;
         }
@@ -89,7 +114,7 @@ int server_listen(int server_fd) {
         if (pthread_create(&client_thread, NULL, handle_client, client_conn) != 0) {
             log_message(LOG_ERR, "Failed to create client thread: %s", strerror(errno));
             close(client_fd);
-            free(client_conn);
+            conn_release(client_conn);
             continue;
         }
         
@@ -115,9 +140,9 @@ void *handle_client(void *arg) {
     inet_ntop(AF_INET, &client_conn->addr.sin_addr, client_ip, INET_ADDRSTRLEN);
     
     while (daemon_running) {
-        // Clear buffers
-        memset(buffer, 0, sizeof(buffer));
-        memset(response, 0, sizeof(response));
+        // recv() terminates the command and every handler writes the
+        // response with snprintf, so only an unhandled path sees this
+        response[0] = '\0';
         
         // Receive command from client
         bytes_received = recv(client_conn->sockfd, buffer, sizeof(buffer) - 1, 0);
@@ -138,6 +163,16 @@ void *handle_client(void *arg) {
         // Handle the command
         int result = handle_command(buffer, response, sizeof(response));
         
+        if (result == HANDLE_STREAM_ROOM_LIST) {
+            if (stream_room_list(client_conn->sockfd) != 0) {
+                log_message(LOG_WARNING, "Failed to send room list to client %s: %s",
+                           client_ip, strerror(errno));
+                break;
+            }
+            log_message(LOG_INFO, "Sent room list to %s", client_ip);
+            continue;
+        }
+        
         // Send response back to client
         ssize_t bytes_sent = send(client_conn->sockfd, response, strlen(response), 0);
         if (bytes_sent < 0) {
@@ -157,7 +192,7 @@ void *handle_client(void *arg) {
     
     // Clean up client connection
     close(client_conn->sockfd);
-    free(client_conn);
+    conn_release(client_conn);
     log_message(LOG_INFO, "Client handler thread for %s terminated", client_ip);
     
     pthread_exit(NULL);
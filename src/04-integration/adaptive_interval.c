@@ -0,0 +1,161 @@
+#include <stdlib.h>
+#include <string.h>
+#include "adaptive_interval.h"
+#include "logger.h"
+
+typedef struct {
+    int running;            // counted in the sample rate
+    int max_ms;             // 0: fixed interval
+    int interval_ms;        // effective interval
+    int has_last;
+    float last_cpu;
+    float last_memory;
+    float volatility;       // smoothed largest change per sample, in points
+    int stable_samples;
+} adaptive_slot_t;
+
+static adaptive_slot_t *slots = NULL;
+static int slot_capacity = 0;
+static int hold_at_cap = 0;
+static adaptive_policy_t policy = {
+    ADAPTIVE_DEFAULT_MIN_INTERVAL_MS, ADAPTIVE_DEFAULT_MAX_RATE,
+    ADAPTIVE_DEFAULT_ALERT_PERCENT, ADAPTIVE_DEFAULT_ALERT_PERCENT
+};
+
+int adaptive_init(int capacity) {
+    if (capacity <= 0) return -1;
+    slots = calloc((size_t)capacity, sizeof(adaptive_slot_t));
+    if (!slots) {
+        log_error("Failed to allocate sampling state for %d rooms", capacity);
+        return -1;
+    }
+    slot_capacity = capacity;
+    return 0;
+}
+
+void adaptive_set_policy(const adaptive_policy_t *next) {
+    if (next) policy = *next;
+}
+
+static adaptive_slot_t *slot_at(int slot) {
+    if (!slots || slot < 0 || slot >= slot_capacity) return NULL;
+    return &slots[slot];
+}
+
+void adaptive_configure(int slot, int max_ms) {
+    adaptive_slot_t *s = slot_at(slot);
+    if (!s) return;
+    memset(s, 0, sizeof(*s));
+    s->max_ms = max_ms > 0 ? max_ms : 0;
+}
+
+int adaptive_max_ms(int slot) {
+    adaptive_slot_t *s = slot_at(slot);
+    return s ? s->max_ms : 0;
+}
+
+void adaptive_start(int slot, int base_ms) {
+    adaptive_slot_t *s = slot_at(slot);
+    if (!s) return;
+    s->running = 1;
+    s->interval_ms = base_ms;
+    s->has_last = 0;
+    s->volatility = 0;
+    s->stable_samples = 0;
+}
+
+void adaptive_stop(int slot) {
+    adaptive_slot_t *s = slot_at(slot);
+    if (s) s->running = 0;
+}
+
+void adaptive_set_hold(int hold) {
+    hold_at_cap = hold;
+    if (!hold) return;
+    // Sleeps in progress pick the cap up when the room threads are woken
+    for (int i = 0; i < slot_capacity; i++) {
+        if (slots[i].max_ms) slots[i].interval_ms = slots[i].max_ms;
+    }
+}
+
+void adaptive_set_base(int slot, int base_ms) {
+    adaptive_slot_t *s = slot_at(slot);
+    // Adaptive rooms keep the interval they converged on
+    if (s && !s->max_ms) s->interval_ms = base_ms;
+}
+
+double adaptive_sample_rate(void) {
+    double rate = 0;
+    for (int i = 0; i < slot_capacity; i++) {
+        if (slots[i].running && slots[i].interval_ms > 0) rate += 1000.0 / slots[i].interval_ms;
+    }
+    return rate;
+}
+
+double adaptive_rate_cap(void) {
+    return policy.max_samples_per_sec;
+}
+
+// Shortest interval for `s` that keeps every running room within the
+// budget; its cap when the other rooms already use all of it
+static int budget_floor_ms(const adaptive_slot_t *s) {
+    if (policy.max_samples_per_sec <= 0) return 0;
+    double others = adaptive_sample_rate();
+    if (s->running && s->interval_ms > 0) others -= 1000.0 / s->interval_ms;
+    double left = policy.max_samples_per_sec - others;
+    if (left <= 0) return s->max_ms;
+    double floor_ms = 1000.0 / left;
+    return floor_ms >= s->max_ms ? s->max_ms : (int)floor_ms + (floor_ms > (int)floor_ms);
+}
+
+static float abs_diff(float a, float b) {
+    return a > b ? a - b : b - a;
+}
+
+int adaptive_observe(int slot, const monitor_data_t *data) {
+    adaptive_slot_t *s = slot_at(slot);
+    if (!s) return 0;
+    if (!s->max_ms) return s->interval_ms;
+
+    if (s->has_last) {
+        float cpu = abs_diff(data->cpu_usage, s->last_cpu);
+        float memory = abs_diff(data->memory_usage, s->last_memory);
+        s->volatility = (s->volatility + (cpu > memory ? cpu : memory)) / 2;
+    }
+    s->last_cpu = data->cpu_usage;
+    s->last_memory = data->memory_usage;
+
+    int near_alert = data->cpu_usage >= policy.cpu_alert - ADAPTIVE_ALERT_MARGIN ||
+                     data->memory_usage >= policy.memory_alert - ADAPTIVE_ALERT_MARGIN;
+    int next = s->interval_ms;
+    if (near_alert || (s->has_last && s->volatility >= ADAPTIVE_VOLATILE_POINTS)) {
+        next /= 2;
+        s->stable_samples = 0;
+    } else if (s->has_last && s->volatility <= ADAPTIVE_STABLE_POINTS) {
+        if (++s->stable_samples >= ADAPTIVE_STABLE_SAMPLES) {
+            next += next / 4;
+            s->stable_samples = 0;
+        }
+    } else {
+        s->stable_samples = 0;
+    }
+    s->has_last = 1;
+
+    if (next < policy.min_interval_ms) next = policy.min_interval_ms;
+    if (next > s->max_ms || hold_at_cap) next = s->max_ms;
+    int floor_ms = budget_floor_ms(s);
+    if (next < floor_ms) next = floor_ms;
+    s->interval_ms = next;
+    return next;
+}
+
+int adaptive_interval_ms(int slot) {
+    adaptive_slot_t *s = slot_at(slot);
+    return s ? s->interval_ms : 0;
+}
+
+void adaptive_cleanup(void) {
+    free(slots);
+    slots = NULL;
+    slot_capacity = 0;
+}
@@ -0,0 +1,49 @@
+#ifndef ADAPTIVE_INTERVAL_H
+#define ADAPTIVE_INTERVAL_H
+
+#include "../commom/data_structures.h"
+
+// Per-room sampling intervals. Fixed rooms sample every collection_interval;
+// adaptive rooms halve their interval while samples are volatile or close
+// to an alert threshold and stretch it by a quarter after a run of stable
+// samples, up to their own cap. Every running room counts towards one
+// samples/sec budget, but the budget only limits how far adaptive rooms
+// shorten: fixed rooms always sample at their configured interval and can
+// take the total over it on their own.
+
+#define ADAPTIVE_DEFAULT_MIN_INTERVAL_MS 250
+#define ADAPTIVE_DEFAULT_MAX_RATE 20.0          // samples/sec, enforced on adaptive rooms
+#define ADAPTIVE_DEFAULT_ALERT_PERCENT 90.0f
+#define ADAPTIVE_ALERT_MARGIN 10.0f             // "close" to an alert, in points
+#define ADAPTIVE_VOLATILE_POINTS 5.0f           // smoothed change that halves the interval
+#define ADAPTIVE_STABLE_POINTS 1.0f             // smoothed change that counts as stable
+#define ADAPTIVE_STABLE_SAMPLES 3               // stable samples before stretching
+
+typedef struct {
+    int min_interval_ms;
+    double max_samples_per_sec;     // adaptive rooms only; <= 0: unbounded
+    float cpu_alert;                // percent
+    float memory_alert;
+} adaptive_policy_t;
+
+// All functions expect the caller to hold rooms_mutex
+int adaptive_init(int capacity);
+void adaptive_set_policy(const adaptive_policy_t *policy);
+// Make `slot` adaptive up to max_ms, or fixed when max_ms is 0
+void adaptive_configure(int slot, int max_ms);
+int adaptive_max_ms(int slot);
+// Count `slot` towards the budget, sampling every base_ms to begin with
+void adaptive_start(int slot, int base_ms);
+void adaptive_stop(int slot);
+// A reload changed the room's collection_interval
+void adaptive_set_base(int slot, int base_ms);
+// While held, adaptive rooms sample at their cap whatever the signal does
+void adaptive_set_hold(int hold);
+// Feed a new sample; returns the interval until the next one
+int adaptive_observe(int slot, const monitor_data_t *data);
+int adaptive_interval_ms(int slot);
+double adaptive_sample_rate(void);
+double adaptive_rate_cap(void);
+void adaptive_cleanup(void);
+
+#endif /* ADAPTIVE_INTERVAL_H */
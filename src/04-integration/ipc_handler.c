@@ -10,6 +10,9 @@
 #include <time.h>
 #include "ipc_handler.h"
 #include "logger.h"
+#include "proc_reader.h"
+#include "proc_parse.h"
+#include "metric_schema.h"
 
 #define FIFO_PATH "/tmp/monitor_fifo"
 #define BUFFER_SIZE 1024
@@ -23,6 +26,37 @@ typedef struct {
 
 static ipc_context_t ipc_ctx = {-1, -1, PTHREAD_MUTEX_INITIALIZER, 0};
 
+static float get_cpu_usage_from_proc(void);
+static unsigned long get_memory_free_from_proc(void);
+static int get_process_count_from_proc(void);
+
+// procfs sources shared by all room threads. Files stay open between
+// samples; proc_mutex guards the buffers and the CPU delta state.
+typedef struct {
+    proc_file_t kernel;
+    proc_file_t stat;
+    proc_file_t meminfo;
+    proc_file_t loadavg;
+    pthread_mutex_t proc_mutex;
+    int opened;
+} proc_sources_t;
+
+static proc_sources_t proc_src = { .proc_mutex = PTHREAD_MUTEX_INITIALIZER };
+
+// Caller holds proc_mutex
+static int proc_sources_open(void) {
+    if (proc_src.opened) return 0;
+    if (proc_file_open(&proc_src.kernel, "/proc/sysmonitor") != 0 ||
+        proc_file_open(&proc_src.stat, "/proc/stat") != 0 ||
+        proc_file_open(&proc_src.meminfo, "/proc/meminfo") != 0 ||
+        proc_file_open(&proc_src.loadavg, "/proc/loadavg") != 0) {
+        log_error("Failed to set up procfs readers: %s", strerror(errno));
+        return -1;
+    }
+    proc_src.opened = 1;
+    return 0;
+}
+
 // Initialize FIFO communication
 int ipc_init(void) {
     // Remove existing FIFO if it exists
@@ -114,35 +148,16 @@ int ipc_receive_data(monitor_data_t *data) {
 
     buffer[bytes_read] = '\0';
 
-    // Parse data format: "DATA:room_name|CPU:45.2|MEM:67.8|PROC:123"
-    if (strncmp(buffer, "DATA:", 5) == 0) {
-        char *token;
-        char *saveptr;
-        char *line = buffer + 5;  // Skip "DATA:"
-
-        // Extract room name
-        token = strtok_r(line, "|", &saveptr);
-        if (token) {
-            strncpy(data->room_name, token, sizeof(data->room_name) - 1);
-            data->room_name[sizeof(data->room_name) - 1] = '\0';
-        }
-
-        // Parse metrics
-        while ((token = strtok_r(NULL, "|", &saveptr)) != NULL) {
-            if (strncmp(token, "CPU:", 4) == 0) {
-                data->cpu_usage = atof(token + 4);
-            } else if (strncmp(token, "MEM:", 4) == 0) {
-                data->memory_usage = atof(token + 4);
-            } else if (strncmp(token, "PROC:", 5) == 0) {
-                data->process_count = atoi(token + 5);
-            }
-        }
-
+    // Fields and tags come from MONITOR_METRICS, e.g. "DATA:web|CPU:45.2|MEM:67.8|PROC:123"
+    if (monitor_data_parse_fifo(buffer, data) >= 0) {
         data->timestamp = time(NULL);
         data->valid = 1;
 
-        log_debug("Received data from LOC GEN: room=%s, cpu=%.2f, mem=%.2f, proc=%d",
-                  data->room_name, data->cpu_usage, data->memory_usage, data->process_count);
+        if (log_enabled(LOG_DEBUG)) {
+            char metrics[256];
+            monitor_data_format_log(data, metrics, sizeof(metrics));
+            log_debug("Received data from LOC GEN: room=%s %s", data->room_name, metrics);
+        }
     }
 
     close(fd);
@@ -163,30 +178,24 @@ int ipc_read_kernel_data(const char *room_name, monitor_data_t *data) {
     strncpy(data->room_name, room_name, sizeof(data->room_name) - 1);
     data->room_name[sizeof(data->room_name) - 1] = '\0';
 
+    pthread_mutex_lock(&proc_src.proc_mutex);
+    if (proc_sources_open() != 0) {
+        pthread_mutex_unlock(&proc_src.proc_mutex);
+        return -1;
+    }
+
     // Try to read from procfs
-    FILE *fp = fopen("/proc/sysmonitor", "r");
-    if (fp) {
-        char line[512];
-        if (fgets(line, sizeof(line), fp)) {
-            // Parse kernel module output
-            // Expected format: "cpu_usage:45.2 memory_free:2048 processes:123"
-            char *token = strtok(line, " ");
-            while (token) {
-                if (strncmp(token, "cpu_usage:", 10) == 0) {
-                    data->cpu_usage = atof(token + 10);
-                } else if (strncmp(token, "memory_free:", 12) == 0) {
-                    data->memory_free = strtoul(token + 12, NULL, 10);
-                } else if (strncmp(token, "processes:", 10) == 0) {
-                    data->process_count = atoi(token + 10);
-                }
-                token = strtok(NULL, " ");
-            }
-            data->timestamp = time(NULL);
-            data->valid = 1;
-            log_debug("Read kernel data: cpu=%.2f, mem_free=%lu, proc=%d",
-                     data->cpu_usage, data->memory_free, data->process_count);
-        }
-        fclose(fp);
+    // Expected format: "cpu_usage:45.2 memory_free:2048 processes:123"
+    proc_sysmon_t sysmon;
+    const char *source;
+    if (proc_file_read(&proc_src.kernel) >= 0 &&
+        proc_parse_sysmon(proc_src.kernel.buf, proc_src.kernel.len, &sysmon) == 0) {
+        data->cpu_usage = (float)sysmon.cpu_usage;
+        data->memory_free = (unsigned long)sysmon.memory_free;
+        data->process_count = (int)sysmon.processes;
+        data->timestamp = time(NULL);
+        data->valid = 1;
+        source = "kernel";
     } else {
         // Fallback: read from system files
         data->cpu_usage = get_cpu_usage_from_proc();
@@ -194,8 +203,14 @@ int ipc_read_kernel_data(const char *room_name, monitor_data_t *data) {
         data->process_count = get_process_count_from_proc();
         data->timestamp = time(NULL);
         data->valid = 1;
-        log_debug("Read system data (fallback): cpu=%.2f, mem_free=%lu, proc=%d",
-                 data->cpu_usage, data->memory_free, data->process_count);
+        source = "system (fallback)";
+    }
+    pthread_mutex_unlock(&proc_src.proc_mutex);
+
+    if (log_enabled(LOG_DEBUG)) {
+        char metrics[256];
+        monitor_data_format_log(data, metrics, sizeof(metrics));
+        log_debug("Read %s data: %s", source, metrics);
     }
 
     return 0;
@@ -221,29 +236,22 @@ int ipc_write_kernel_control(const char *room_name, int enable) {
     }
 }
 
-// Helper functions to read system information
+// Helper functions to read system information (caller holds proc_mutex)
 static float get_cpu_usage_from_proc(void) {
     static unsigned long long prev_idle = 0;
     static unsigned long long prev_total = 0;
 
-    FILE *fp = fopen("/proc/stat", "r");
-    if (!fp) return 0.0;
-
-    char line[256];
-    if (!fgets(line, sizeof(line), fp)) {
-        fclose(fp);
-        return 0.0;
-    }
-    fclose(fp);
+    static proc_stat_t stat;    // ~20 KB; kept off the room thread stacks
 
-    unsigned long long user, nice, system, idle, iowait, irq, softirq, steal;
-    if (sscanf(line, "cpu %llu %llu %llu %llu %llu %llu %llu %llu",
-               &user, &nice, &system, &idle, &iowait, &irq, &softirq, &steal) < 8) {
+    if (proc_file_read(&proc_src.stat) < 0 ||
+        proc_parse_stat(proc_src.stat.buf, proc_src.stat.len, &stat) != 0) {
         return 0.0;
     }
 
-    unsigned long long current_idle = idle + iowait;
-    unsigned long long current_total = user + nice + system + idle + iowait + irq + softirq + steal;
+    const proc_cpu_times_t *t = &stat.total;
+    unsigned long long current_idle = t->idle + t->iowait;
+    unsigned long long current_total = t->user + t->nice + t->system + t->idle +
+                                       t->iowait + t->irq + t->softirq + t->steal;
 
     if (prev_total == 0) {
         prev_idle = current_idle;
@@ -263,42 +271,21 @@ static float get_cpu_usage_from_proc(void) {
 }
 
 static unsigned long get_memory_free_from_proc(void) {
-    FILE *fp = fopen("/proc/meminfo", "r");
-    if (!fp) return 0;
-
-    char line[256];
-    unsigned long mem_free = 0;
-
-    while (fgets(line, sizeof(line), fp)) {
-        if (strncmp(line, "MemFree:", 8) == 0) {
-            sscanf(line, "MemFree: %lu kB", &mem_free);
-            break;
-        }
+    proc_meminfo_t mem;
+    if (proc_file_read(&proc_src.meminfo) < 0 ||
+        proc_parse_meminfo(proc_src.meminfo.buf, proc_src.meminfo.len, &mem) != 0) {
+        return 0;
     }
-
-    fclose(fp);
-    return mem_free;
+    return (unsigned long)mem.mem_free;
 }
 
 static int get_process_count_from_proc(void) {
-    FILE *fp = fopen("/proc/loadavg", "r");
-    if (!fp) return 0;
-
-    char line[256];
-    if (!fgets(line, sizeof(line), fp)) {
-        fclose(fp);
-        return 0;
-    }
-    fclose(fp);
-
-    float load1, load5, load15;
-    int running, total;
-
-    if (sscanf(line, "%f %f %f %d/%d", &load1, &load5, &load15, &running, &total) < 5) {
+    proc_loadavg_t load;
+    if (proc_file_read(&proc_src.loadavg) < 0 ||
+        proc_parse_loadavg(proc_src.loadavg.buf, proc_src.loadavg.len, &load) != 0) {
         return 0;
     }
-
-    return total;
+    return (int)load.total;
 }
 
 // Send raw IPC message
@@ -360,5 +347,15 @@ void ipc_cleanup(void) {
 
     ipc_ctx.initialized = 0;
     pthread_mutex_unlock(&ipc_ctx.fifo_mutex);
+
+    pthread_mutex_lock(&proc_src.proc_mutex);
+    if (proc_src.opened) {
+        proc_file_close(&proc_src.kernel);
+        proc_file_close(&proc_src.stat);
+        proc_file_close(&proc_src.meminfo);
+        proc_file_close(&proc_src.loadavg);
+        proc_src.opened = 0;
+    }
+    pthread_mutex_unlock(&proc_src.proc_mutex);
     log_info("IPC cleanup completed");
 }
@@ -320,6 +320,12 @@ void logger_set_level(log_level_t level) {
     pthread_mutex_unlock(&logger_ctx.log_mutex);
 }
 
+// Whether a message at `level` would be written; lets callers skip
+// building expensive arguments. Reads the level without the lock.
+int log_enabled(log_level_t level) {
+    return logger_ctx.initialized && level >= logger_ctx.current_level;
+}
+
 // Set structured mode
 void logger_set_structured_mode(int enable) {
     pthread_mutex_lock(&logger_ctx.log_mutex);
@@ -348,10 +354,14 @@ log_level_t log_level_from_string(const char *level_str) {
 
 // Cleanup logger
 void logger_cleanup(void) {
+    // log_info takes log_mutex itself
+    if (logger_ctx.log_file) {
+        log_info("Logger shutting down");
+    }
+
     pthread_mutex_lock(&logger_ctx.log_mutex);
 
     if (logger_ctx.log_file) {
-        log_info("Logger shutting down");
         fclose(logger_ctx.log_file);
         logger_ctx.log_file = NULL;
     }
@@ -28,6 +28,7 @@ int logger_init(const char *log_path, log_level_t level, int structured);
 int logger_init_with_config(const logger_config_t *config);
 void logger_set_level(log_level_t level);
 void logger_set_structured_mode(int enable);
+int log_enabled(log_level_t level);
 void logger_cleanup(void);
 
 // Logging functions
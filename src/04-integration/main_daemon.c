@@ -1,6 +1,7 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <ctype.h>
 #include <unistd.h>
 #include <signal.h>
 #include <errno.h>
@@ -11,38 +12,151 @@
 #include <sys/socket.h>
 #include <sys/types.h>
 #include <sys/stat.h>
+#include <sys/uio.h>
+#include <poll.h>
 #include <time.h>
 #include "main_daemon.h"
 #include "logger.h"
 #include "ipc_handler.h"
+#include "shm_snapshot.h"
+#include "upgrade_handoff.h"
+#include "room_history.h"
+#include "state_snapshot.h"
+#include "supervisor.h"
+#include "psi_watch.h"
+#include "plugin_registry.h"
+#include "collector_sched.h"
+#include "metric_schema.h"
+#include "adaptive_interval.h"
+#include "overhead_governor.h"
+#include "mem_budget.h"
+#include "response_stream.h"
 
-volatile daemon_state_t g_daemon_state = {0};
-volatile daemon_stats_t g_daemon_stats = {0};
+// Socket waits are bounded so threads notice shutdown and upgrade handoff
+#define IO_POLL_TIMEOUT_MS 200
 
-static room_info_t* find_room(const char *room_name);
-static void* room_monitor_thread(void *arg);
-static int initialize_server_socket(void);
-static int create_pid_file(const char *pid_file);
-static int remove_pid_file(const char *pid_file);
-static void cleanup_on_exit(void);
-static void signal_handler(int sig);
-static int install_signal_handlers(void);
+daemon_state_t g_daemon_state = {0};
+daemon_stats_t g_daemon_stats = {0};
+static volatile int g_io_suspended = 0;
+static char g_snapshot_path[256] = DEFAULT_SNAPSHOT_FILE;
+static int g_snapshot_interval = DEFAULT_SNAPSHOT_INTERVAL;
+static char g_config_file[256] = DEFAULT_CONFIG_FILE;
+static volatile sig_atomic_t g_reload_requested = 0;
+
+// Wakes room threads early: stop, delete, shutdown, a retuned interval or
+// a pressure stall
+static pthread_cond_t g_rooms_cond;
+
+// Kernel PSI triggers: a stall wakes every running room for an immediate
+// sample, so history records it without a shorter collection interval
+static psi_watch_t g_psi;
+static pthread_t g_psi_thread;
+static int g_psi_started = 0;
+static unsigned long g_pressure_events = 0;     // guarded by rooms_mutex
+static int g_psi_stall_us = PSI_DEFAULT_STALL_US;
+static int g_psi_window_us = PSI_DEFAULT_WINDOW_US;
+
+// Collector plugins dlopen()ed from g_plugin_dir at startup. One thread
+// samples them all; plugins sharing a period run as one batch per wakeup.
+static collector_sched_t g_plugin_sched;
+static pthread_mutex_t g_plugin_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t g_plugin_cond;
+static pthread_t g_plugin_thread;
+static int g_plugins_started = 0;
+static int g_plugins_stopping = 0;              // guarded by g_plugin_mutex
+static char g_plugin_dir[256] = PLUGIN_DEFAULT_DIR;
+
+// Self-overhead governor, ticked by the main loop. Its state and
+// g_publish_every are guarded by rooms_mutex.
+static governor_t g_governor;
+static double g_cpu_budget_percent = GOVERNOR_DEFAULT_BUDGET_PERCENT;
+static int g_publish_every = 1;                 // samples per shm publish
+
+// Slots available in the fixed room and client tables
+#define ROOM_TABLE_CAPACITY ((int)(sizeof(g_daemon_state.rooms) / sizeof(g_daemon_state.rooms[0])))
+#define CLIENT_TABLE_CAPACITY ((int)(sizeof(g_daemon_state.clients) / sizeof(g_daemon_state.clients[0])))
+
+// Client slots whose handler thread has not been joined yet, guarded by
+// clients_mutex. A slot is reaped before reuse so exited handlers do not
+// keep their stacks.
+static char g_client_threads[CLIENT_TABLE_CAPACITY];
+
+// Monitor thread of each room slot, guarded by rooms_mutex. A thread that
+// gave up with ROOM_STATE_ERROR still holds its stack until it is joined.
+// A STOPPING slot is being joined with rooms_mutex dropped; every other
+// path leaves it alone until the joiner takes the lock back.
+#define ROOM_THREAD_NONE 0
+#define ROOM_THREAD_LIVE 1
+#define ROOM_THREAD_STOPPING 2
+static char g_room_threads[ROOM_TABLE_CAPACITY];
+
+// Command and reply buffers for one client handler. Handlers take one from
+// the pool for the life of the connection so the per-command path neither
+// allocates nor carries them on its stack.
+typedef struct {
+    command_t command;
+    response_t response;
+    response_stream_t stream;                   // replies that outgrow response_t
+    monitor_data_t history[ROOM_HISTORY_DEPTH];
+} client_session_t;
+
+#define SESSIONS_PER_CHUNK 8
+
+static mem_pool_t g_session_pool;
+static pthread_mutex_t g_session_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+static log_level_t governed_log_level(void);
+
+// Settings read from the config file, including those kept outside config_t
+typedef struct {
+    config_t config;
+    char snapshot_path[256];
+    int snapshot_interval;
+    int psi_stall_us;           // 0 disables the pressure triggers
+    int psi_window_us;
+    char plugin_dir[256];       // empty disables collector plugins
+    adaptive_policy_t adaptive;
+    double cpu_budget_percent;  // of one core; 0 disables the governor
+    long memory_budget_kb;      // 0: unlimited
+} daemon_settings_t;
+
+static void default_settings(daemon_settings_t *settings) {
+    memset(settings, 0, sizeof(*settings));
+    config_t *config = &settings->config;
+    strncpy(config->log_path, DEFAULT_LOG_FILE, sizeof(config->log_path) - 1);
+    config->log_level = LOG_INFO;
+    config->structured_logging = 0;
+    config->daemon_port = DEFAULT_PORT;
+    config->max_rooms = DEFAULT_MAX_ROOMS;
+    config->max_clients = DEFAULT_MAX_CLIENTS;
+    config->collection_interval = DEFAULT_COLLECTION_INTERVAL;
+    strncpy(config->fifo_path, DEFAULT_FIFO_PATH, sizeof(config->fifo_path) - 1);
+    strncpy(config->procfs_path, DEFAULT_PROCFS_PATH, sizeof(config->procfs_path) - 1);
+    strncpy(config->pid_file, DEFAULT_PID_FILE, sizeof(config->pid_file) - 1);
+    strncpy(settings->snapshot_path, DEFAULT_SNAPSHOT_FILE, sizeof(settings->snapshot_path) - 1);
+    settings->snapshot_interval = DEFAULT_SNAPSHOT_INTERVAL;
+    settings->psi_stall_us = PSI_DEFAULT_STALL_US;
+    settings->psi_window_us = PSI_DEFAULT_WINDOW_US;
+    strncpy(settings->plugin_dir, PLUGIN_DEFAULT_DIR, sizeof(settings->plugin_dir) - 1);
+    settings->adaptive.min_interval_ms = ADAPTIVE_DEFAULT_MIN_INTERVAL_MS;
+    settings->adaptive.max_samples_per_sec = ADAPTIVE_DEFAULT_MAX_RATE;
+    settings->adaptive.cpu_alert = ADAPTIVE_DEFAULT_ALERT_PERCENT;
+    settings->adaptive.memory_alert = ADAPTIVE_DEFAULT_ALERT_PERCENT;
+    settings->cpu_budget_percent = GOVERNOR_DEFAULT_BUDGET_PERCENT;
+    settings->memory_budget_kb = MEM_DEFAULT_BUDGET_KB;
+}
+
+// Parse `config_file` on top of the defaults. Returns 1 if the file was
+// missing, 0 if it was read.
+static int parse_configuration(const char *config_file, daemon_settings_t *settings) {
+    default_settings(settings);
+    config_t *config = &settings->config;
 
-int load_configuration(const char *config_file) {
     FILE *fp = fopen(config_file, "r");
     if (!fp) {
-        log_warn("Config file not found, using defaults");
-        strncpy(g_daemon_state.config.log_path, DEFAULT_LOG_FILE, sizeof(g_daemon_state.config.log_path));
-        g_daemon_state.config.log_level = LOG_INFO;
-        g_daemon_state.config.structured_logging = 1;
-        g_daemon_state.config.daemon_port = DEFAULT_PORT;
-        g_daemon_state.config.max_rooms = DEFAULT_MAX_ROOMS;
-        g daemon_state.config.max_clients = DEFAULT_MAX_CLIENTS;
-        g_daemon_state.config.collection_interval = DEFAULT_COLLECTION_INTERVAL;
-        strncpy(g_daemon_state.config.fifo_path, DEFAULT_FIFO_PATH, sizeof(g_daemon_state.config.fifo_path));
-        strncpy(g_daemon_state.config.procfs_path, DEFAULT_PROCFS_PATH, sizeof(g_daemon_state.config.procfs_path));
-        strncpy(g_daemon_state.config.pid_file, DEFAULT_PID_FILE, sizeof(g_daemon_state.config.pid_file));
-        return 0;
+        // Running without a config file has always meant JSON logs
+        config->structured_logging = 1;
+        return 1;
     }
 
     char line[512];
@@ -51,52 +165,266 @@ int load_configuration(const char *config_file) {
         if (sscanf(line, " %127[^=] = %255[^\"]", key, value) == 2) {
             char *k = key; while (*k == ' ' || *k == '\t') k++;
             char *v = value; while (*v == ' ' || *v == '\t') v++;
+            for (char *e = k + strlen(k); e > k && isspace((unsigned char)e[-1]); ) *--e = '\0';
+            for (char *e = v + strlen(v); e > v && isspace((unsigned char)e[-1]); ) *--e = '\0';
             if (strcasecmp(k, "log_path") == 0) {
-                strncpy(g_daemon_state.config.log_path, v, sizeof(g_daemon_state.config.log_path));
+                snprintf(config->log_path, sizeof(config->log_path), "%s", v);
             } else if (strcasecmp(k, "log_level") == 0) {
-                g_daemon_state.config.log_level = log_level_from_string(v);
+                config->log_level = log_level_from_string(v);
             } else if (strcasecmp(k, "structured_logging") == 0) {
-                g_daemon_state.config.structured_logging = (strcasecmp(v, "true") == 0) ? 1 : 0;
+                config->structured_logging = (strcasecmp(v, "true") == 0) ? 1 : 0;
             } else if (strcasecmp(k, "daemon_port") == 0) {
-                g_daemon_state.config.daemon_port = atoi(v);
+                config->daemon_port = atoi(v);
             } else if (strcasecmp(k, "max_rooms") == 0) {
-                g_daemon_state.config.max_rooms = atoi(v);
+                config->max_rooms = atoi(v);
             } else if (strcasecmp(k, "max_clients") == 0) {
-                g_daemon_state.config.max_clients = atoi(v);
+                config->max_clients = atoi(v);
             } else if (strcasecmp(k, "collection_interval") == 0) {
-                g_daemon_state.config.collection_interval = atoi(v);
+                config->collection_interval = atoi(v);
             } else if (strcasecmp(k, "fifo_path") == 0) {
-                strncpy(g_daemon_state.config.fifo_path, v, sizeof(g_daemon_state.config.fifo_path));
+                snprintf(config->fifo_path, sizeof(config->fifo_path), "%s", v);
             } else if (strcasecmp(k, "procfs_path") == 0) {
-                strncpy(g_daemon_state.config.procfs_path, v, sizeof(g_daemon_state.config.procfs_path));
+                snprintf(config->procfs_path, sizeof(config->procfs_path), "%s", v);
             } else if (strcasecmp(k, "pid_file") == 0) {
-                strncpy(g_daemon_state.config.pid_file, v, sizeof(g_daemon_state.config.pid_file));
+                snprintf(config->pid_file, sizeof(config->pid_file), "%s", v);
+            } else if (strcasecmp(k, "snapshot_path") == 0) {
+                snprintf(settings->snapshot_path, sizeof(settings->snapshot_path), "%s", v);
+            } else if (strcasecmp(k, "snapshot_interval") == 0) {
+                settings->snapshot_interval = atoi(v);
+            } else if (strcasecmp(k, "psi_stall_us") == 0) {
+                settings->psi_stall_us = atoi(v);
+            } else if (strcasecmp(k, "psi_window_us") == 0) {
+                settings->psi_window_us = atoi(v);
+            } else if (strcasecmp(k, "plugin_dir") == 0) {
+                snprintf(settings->plugin_dir, sizeof(settings->plugin_dir), "%s", v);
+            } else if (strcasecmp(k, "adaptive_min_interval_ms") == 0) {
+                settings->adaptive.min_interval_ms = atoi(v);
+            } else if (strcasecmp(k, "max_samples_per_sec") == 0) {
+                settings->adaptive.max_samples_per_sec = atof(v);
+            } else if (strcasecmp(k, "cpu_alert_percent") == 0) {
+                settings->adaptive.cpu_alert = (float)atof(v);
+            } else if (strcasecmp(k, "memory_alert_percent") == 0) {
+                settings->adaptive.memory_alert = (float)atof(v);
+            } else if (strcasecmp(k, "cpu_budget_percent") == 0) {
+                settings->cpu_budget_percent = atof(v);
+            } else if (strcasecmp(k, "memory_budget_kb") == 0) {
+                settings->memory_budget_kb = atol(v);
             }
         }
     }
 
     fclose(fp);
+    return 0;
+}
+
+int validate_configuration(const config_t *config) {
+    int valid = 1;
+    if (config->log_path[0] == '\0') {
+        log_error("Config: log_path is empty");
+        valid = 0;
+    }
+    if (config->daemon_port <= 0 || config->daemon_port > 65535) {
+        log_error("Config: daemon_port %d out of range", config->daemon_port);
+        valid = 0;
+    }
+    if (config->max_rooms <= 0 || config->max_rooms > ROOM_TABLE_CAPACITY) {
+        log_error("Config: max_rooms %d must be 1..%d", config->max_rooms, ROOM_TABLE_CAPACITY);
+        valid = 0;
+    }
+    if (config->max_clients <= 0 || config->max_clients > CLIENT_TABLE_CAPACITY) {
+        log_error("Config: max_clients %d must be 1..%d", config->max_clients, CLIENT_TABLE_CAPACITY);
+        valid = 0;
+    }
+    if (config->collection_interval <= 0) {
+        log_error("Config: collection_interval %d must be positive", config->collection_interval);
+        valid = 0;
+    }
+    return valid ? 0 : -1;
+}
+
+int load_configuration(const char *config_file) {
+    daemon_settings_t settings;
+    if (parse_configuration(config_file, &settings) != 0) {
+        log_warn("Config file not found, using defaults");
+    }
+    if (validate_configuration(&settings.config) != 0) {
+        return -1;
+    }
+
+    if (settings.adaptive.min_interval_ms <= 0) {
+        log_error("Config: adaptive_min_interval_ms %d must be positive", settings.adaptive.min_interval_ms);
+        return -1;
+    }
+    if (settings.memory_budget_kb < 0) {
+        log_error("Config: memory_budget_kb %ld must not be negative", settings.memory_budget_kb);
+        return -1;
+    }
+
+    g_daemon_state.config = settings.config;
+    adaptive_set_policy(&settings.adaptive);
+    g_cpu_budget_percent = settings.cpu_budget_percent;
+    mem_budget_set_limit((size_t)settings.memory_budget_kb * 1024);
+    snprintf(g_snapshot_path, sizeof(g_snapshot_path), "%s", settings.snapshot_path);
+    g_snapshot_interval = settings.snapshot_interval;
+    g_psi_stall_us = settings.psi_stall_us;
+    g_psi_window_us = settings.psi_window_us;
+    snprintf(g_plugin_dir, sizeof(g_plugin_dir), "%s", settings.plugin_dir);
+    snprintf(g_config_file, sizeof(g_config_file), "%s", config_file);
     log_info("Configuration loaded from %s", config_file);
     return 0;
 }
 
-static room_info_t* find_room(const char *room_name) {
-    if (!room_name) return NULL;
+// Highest occupied slot + 1 in a table, so shrinking never strands an entry
+static int rooms_in_use(void) {
+    int used = 0;
+    for (int i = 0; i < g_daemon_state.config.max_rooms; i++) {
+        if (g_daemon_state.rooms[i].state != ROOM_STATE_INACTIVE) used = i + 1;
+    }
+    return used;
+}
+
+static int clients_in_use(void) {
+    int used = 0;
+    for (int i = 0; i < g_daemon_state.config.max_clients; i++) {
+        if (g_daemon_state.clients[i].active) used = i + 1;
+    }
+    return used;
+}
+
+// Re-read the config file and apply what can change at runtime. Runs on the
+// main thread; SIGHUP only sets g_reload_requested.
+int reload_configuration(void) {
+    daemon_settings_t settings;
+    if (parse_configuration(g_config_file, &settings) != 0) {
+        log_error("Reload: config file %s not found, keeping current configuration", g_config_file);
+        return -1;
+    }
+    config_t *next = &settings.config;
+    if (validate_configuration(next) != 0 || settings.adaptive.min_interval_ms <= 0 ||
+        settings.memory_budget_kb < 0) {
+        log_error("Reload: invalid configuration, keeping current configuration");
+        return -1;
+    }
+
+    config_t *current = &g_daemon_state.config;
+    if (strcmp(next->log_path, current->log_path) != 0 ||
+        next->daemon_port != current->daemon_port ||
+        strcmp(next->fifo_path, current->fifo_path) != 0 ||
+        strcmp(next->procfs_path, current->procfs_path) != 0 ||
+        strcmp(next->pid_file, current->pid_file) != 0) {
+        log_warn("Reload: log_path, daemon_port, fifo_path, procfs_path and pid_file "
+                 "only take effect after a restart");
+    }
+    if (settings.psi_stall_us != g_psi_stall_us || settings.psi_window_us != g_psi_window_us) {
+        log_warn("Reload: psi_stall_us and psi_window_us only take effect after a restart");
+    }
+    if (strcmp(settings.plugin_dir, g_plugin_dir) != 0) {
+        log_warn("Reload: plugin_dir only takes effect after a restart");
+    }
+
+    // Take both tables so the limits and intervals change in one step
     pthread_mutex_lock(&g_daemon_state.rooms_mutex);
+    pthread_mutex_lock(&g_daemon_state.clients_mutex);
+    int rooms_used = rooms_in_use();
+    int clients_used = clients_in_use();
+    if (next->max_rooms < rooms_used || next->max_clients < clients_used) {
+        pthread_mutex_unlock(&g_daemon_state.clients_mutex);
+        pthread_mutex_unlock(&g_daemon_state.rooms_mutex);
+        log_error("Reload: max_rooms %d / max_clients %d would drop live slots (%d / %d in use)",
+                  next->max_rooms, next->max_clients, rooms_used, clients_used);
+        return -1;
+    }
+
+    // Rooms still on the old default interval follow the new one
+    int old_interval = current->collection_interval;
+    int retuned = 0;
+    if (next->collection_interval != old_interval) {
+        for (int i = 0; i < rooms_used; i++) {
+            room_info_t *room = &g_daemon_state.rooms[i];
+            if (room->state != ROOM_STATE_INACTIVE && room->collection_interval == old_interval) {
+                room->collection_interval = next->collection_interval;
+                adaptive_set_base(i, room->collection_interval * 1000);
+                shm_snapshot_publish_room(i, room);
+                retuned++;
+            }
+        }
+    }
+
+    current->log_level = next->log_level;
+    current->structured_logging = next->structured_logging;
+    current->max_rooms = next->max_rooms;
+    current->max_clients = next->max_clients;
+    current->collection_interval = next->collection_interval;
+    adaptive_set_policy(&settings.adaptive);
+    g_cpu_budget_percent = settings.cpu_budget_percent;
+    g_governor.budget_percent = settings.cpu_budget_percent;
+    pthread_cond_broadcast(&g_rooms_cond);
+    pthread_mutex_unlock(&g_daemon_state.clients_mutex);
+    pthread_mutex_unlock(&g_daemon_state.rooms_mutex);
+
+    logger_set_level(governed_log_level());
+    logger_set_structured_mode(next->structured_logging);
+    // Memory already held is kept; new reservations and history segments
+    // are refused or evicted until usage is back under the limit
+    size_t limit = (size_t)settings.memory_budget_kb * 1024;
+    mem_budget_set_limit(limit);
+    if (limit && mem_total_used() > limit) {
+        log_warn("Reload: memory in use (%zu kB) is over the new budget of %ld kB",
+                 mem_total_used() / 1024, settings.memory_budget_kb);
+    }
+    snprintf(g_snapshot_path, sizeof(g_snapshot_path), "%s", settings.snapshot_path);
+    g_snapshot_interval = settings.snapshot_interval;
+
+    log_info("Configuration reloaded from %s: max_rooms=%d max_clients=%d interval=%ds (%d rooms retuned)",
+             g_config_file, current->max_rooms, current->max_clients,
+             current->collection_interval, retuned);
+    return 0;
+}
+
+// Caller must hold rooms_mutex
+room_info_t* find_room(const char *room_name) {
+    if (!room_name) return NULL;
     for (int i=0; i<g_daemon_state.config.max_rooms; i++) {
         if (g_daemon_state.rooms[i].state != ROOM_STATE_INACTIVE &&
             strncmp(g_daemon_state.rooms[i].name, room_name, MAX_ROOM_NAME) == 0) {
-            pthread_mutex_unlock(&g_daemon_state.rooms_mutex);
             return &g_daemon_state.rooms[i];
         }
     }
-    pthread_mutex_unlock(&g_daemon_state.rooms_mutex);
     return NULL;
 }
 
+static int room_slot(const room_info_t *room) {
+    return (int)(room - g_daemon_state.rooms);
+}
+
+// Sleep until the room's next collection. The deadline is recomputed after
+// each wakeup so a reloaded interval applies to the sleep in progress; a
+// pressure stall ends the sleep early.
+static void wait_collection_interval(room_info_t *room) {
+    struct timespec started, deadline;
+    clock_gettime(CLOCK_MONOTONIC, &started);
+    pthread_mutex_lock(&g_daemon_state.rooms_mutex);
+    unsigned long pressure_events = g_pressure_events;
+    while (g_daemon_state.running && room->active && g_pressure_events == pressure_events) {
+        int interval_ms = adaptive_interval_ms(room_slot(room));
+        deadline = started;
+        deadline.tv_sec += interval_ms / 1000;
+        deadline.tv_nsec += (long)(interval_ms % 1000) * 1000000L;
+        if (deadline.tv_nsec >= 1000000000L) {
+            deadline.tv_sec++;
+            deadline.tv_nsec -= 1000000000L;
+        }
+        if (pthread_cond_timedwait(&g_rooms_cond, &g_daemon_state.rooms_mutex, &deadline) == ETIMEDOUT) {
+            break;
+        }
+    }
+    pthread_mutex_unlock(&g_daemon_state.rooms_mutex);
+}
+
 void* room_monitor_thread(void* arg) {
     room_info_t* room = (room_info_t*)arg;
     log_info("Starting monitoring thread for room %s", room->name);
+    unsigned long samples = 0;
     while (g_daemon_state.running && room->active) {
         monitor_data_t data = {0};
         if (ipc_read_kernel_data(room->name, &data) == 0) {
@@ -104,25 +432,241 @@ void* room_monitor_thread(void* arg) {
             room->latest_data = data;
             room->last_update = time(NULL);
             g_daemon_stats.data_points_collected++;
+            room_history_push(room_slot(room), &data);
+            int previous_ms = adaptive_interval_ms(room_slot(room));
+            int interval_ms = adaptive_observe(room_slot(room), &data);
+            if (++samples % (unsigned long)g_publish_every == 0) {
+                shm_snapshot_publish_room(room_slot(room), room);
+            }
             pthread_mutex_unlock(&g_daemon_state.rooms_mutex);
-            log_debug("Collected data for room %s: CPU=%.2f%% MEM=%.2f%% PROC=%d",
-            room->name, data.cpu_usage, data.memory_usage, data.process_count);
+            if (interval_ms != previous_ms) {
+                log_debug("Room %s now sampled every %d ms", room->name, interval_ms);
+            }
+            if (log_enabled(LOG_DEBUG)) {
+                char metrics[256];
+                monitor_data_format_log(&data, metrics, sizeof(metrics));
+                log_debug("Collected data for room %s: %s", room->name, metrics);
+            }
         } else {
             log_warn("Failed to collect data for room %s", room->name);
             room->error_count++;
             if (room->error_count > 10) {
                 log_error("Too many errors for room %s, stopping monitoring", room->name);
+                pthread_mutex_lock(&g_daemon_state.rooms_mutex);
                 room->state = ROOM_STATE_ERROR;
+                adaptive_stop(room_slot(room));
+                shm_snapshot_publish_room(room_slot(room), room);
+                pthread_mutex_unlock(&g_daemon_state.rooms_mutex);
                 break;
             }
         }
-        sleep(room->collection_interval);
+        wait_collection_interval(room);
     }
     log_info("Monitoring thread stopped for room %s", room->name);
     return NULL;
 }
 
-int create_room(const char *room_name, int collection_interval) {
+// Sleeps in poll() on the PSI trigger fds; costs nothing until the kernel
+// reports a stall
+static void* pressure_thread(void *arg) {
+    (void)arg;
+    while (g_daemon_state.running) {
+        int fired = psi_watch_wait(&g_psi, -1);
+        if (fired < 0) {
+            log_error("Pressure triggers failed: %s", strerror(errno));
+            break;
+        }
+        if (fired == 0) continue;
+
+        psi_watch_sample(&g_psi);
+        for (int r = 0; r < PSI_RESOURCES; r++) {
+            if (fired & PSI_BIT(r)) {
+                log_info("Pressure stall on %s: some avg10=%.2f full avg10=%.2f",
+                         psi_resource_name(r), g_psi.psi[r].some.avg10, g_psi.psi[r].full.avg10);
+            }
+        }
+        pthread_mutex_lock(&g_daemon_state.rooms_mutex);
+        g_pressure_events++;
+        pthread_cond_broadcast(&g_rooms_cond);
+        pthread_mutex_unlock(&g_daemon_state.rooms_mutex);
+    }
+    return NULL;
+}
+
+// Register a "some" trigger per resource and start the waiting thread.
+// Failure only loses early sampling on stalls.
+static int start_pressure_triggers(void) {
+    if (g_psi_stall_us <= 0) return 0;
+    if (psi_watch_init(&g_psi, PSI_DEFAULT_ROOT) != 0) {
+        log_warn("Pressure stall information unavailable: %s", strerror(errno));
+        return -1;
+    }
+    int registered = 0;
+    for (int r = 0; r < PSI_RESOURCES; r++) {
+        if (psi_watch_add_trigger(&g_psi, r, 0, (uint32_t)g_psi_stall_us, (uint32_t)g_psi_window_us) == 0) {
+            registered++;
+        } else {
+            log_warn("No %s pressure trigger (%dus in %dus): %s", psi_resource_name(r),
+                     g_psi_stall_us, g_psi_window_us, strerror(errno));
+        }
+    }
+    if (registered == 0 || pthread_create(&g_psi_thread, NULL, pressure_thread, NULL) != 0) {
+        psi_watch_free(&g_psi);
+        return -1;
+    }
+    g_psi_started = 1;
+    log_info("Pressure triggers armed on %d resources: %dus stalled per %dus",
+             registered, g_psi_stall_us, g_psi_window_us);
+    return 0;
+}
+
+static void stop_pressure_triggers(void) {
+    if (!g_psi_started) return;
+    psi_watch_interrupt(&g_psi);
+    pthread_join(g_psi_thread, NULL);
+    psi_watch_free(&g_psi);
+    g_psi_started = 0;
+}
+
+static uint64_t monotonic_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+// Sleeps until the earliest batch deadline, samples every due batch and
+// goes back to sleep; `show` reads the results under g_plugin_mutex
+static void* plugin_thread(void *arg) {
+    (void)arg;
+    pthread_mutex_lock(&g_plugin_mutex);
+    while (!g_plugins_stopping) {
+        uint64_t next_ns;
+        collector_sched_run(&g_plugin_sched, monotonic_ns(), &next_ns);
+        if (next_ns == UINT64_MAX) break;
+        struct timespec deadline = {
+            .tv_sec = (time_t)(next_ns / 1000000000ULL),
+            .tv_nsec = (long)(next_ns % 1000000000ULL)
+        };
+        while (!g_plugins_stopping &&
+               pthread_cond_timedwait(&g_plugin_cond, &g_plugin_mutex, &deadline) != ETIMEDOUT) {
+        }
+    }
+    pthread_mutex_unlock(&g_plugin_mutex);
+    return NULL;
+}
+
+// Load every collector in g_plugin_dir and schedule it at its own period.
+// A missing directory just means no plugins.
+static int start_collector_plugins(void) {
+    if (g_plugin_dir[0] == '\0') return 0;
+    int loaded = plugin_load_dir(g_plugin_dir);
+    if (loaded <= 0) {
+        if (loaded < 0) log_debug("No plugin directory %s", g_plugin_dir);
+        return 0;
+    }
+
+    collector_sched_init(&g_plugin_sched);
+    uint64_t now = monotonic_ns();
+    for (int i = 0; i < plugin_count(); i++) {
+        const collector_ops_t *ops = plugin_at(i);
+        if (collector_sched_add(&g_plugin_sched, ops, NULL, 0, now) < 0) {
+            log_warn("Collector plugin %s failed to initialise", ops->name);
+        }
+    }
+    if (g_plugin_sched.count == 0) {
+        collector_sched_free(&g_plugin_sched);
+        plugin_unload_all();
+        return -1;
+    }
+
+    pthread_condattr_t attr;
+    pthread_condattr_init(&attr);
+    pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+    pthread_cond_init(&g_plugin_cond, &attr);
+    pthread_condattr_destroy(&attr);
+    g_plugins_stopping = 0;
+    if (pthread_create(&g_plugin_thread, NULL, plugin_thread, NULL) != 0) {
+        log_error("Failed to create collector plugin thread");
+        pthread_cond_destroy(&g_plugin_cond);
+        collector_sched_free(&g_plugin_sched);
+        plugin_unload_all();
+        return -1;
+    }
+    g_plugins_started = 1;
+    log_info("Loaded %d collector plugins from %s in %d sampling batches",
+             g_plugin_sched.count, g_plugin_dir, g_plugin_sched.batch_count);
+    return 0;
+}
+
+static void stop_collector_plugins(void) {
+    if (!g_plugins_started) return;
+    pthread_mutex_lock(&g_plugin_mutex);
+    g_plugins_stopping = 1;
+    pthread_cond_signal(&g_plugin_cond);
+    pthread_mutex_unlock(&g_plugin_mutex);
+    pthread_join(g_plugin_thread, NULL);
+    pthread_cond_destroy(&g_plugin_cond);
+    collector_sched_free(&g_plugin_sched);
+    plugin_unload_all();
+    g_plugins_started = 0;
+}
+
+// Latest reported values of collector plugin `name` into `buf`. Returns -1
+// if no such plugin is loaded.
+static int show_collector_plugin(const char *name, char *buf, size_t size) {
+    if (!g_plugins_started) return -1;
+    pthread_mutex_lock(&g_plugin_mutex);
+    const collector_task_t *task = collector_sched_find(&g_plugin_sched, name);
+    int rc = -1;
+    if (task) {
+        if (task->has_sample) {
+            rc = collector_task_format(task, buf, size) < 0 ? -1 : 0;
+        } else {
+            snprintf(buf, size, "No sample yet");
+            rc = 0;
+        }
+    }
+    pthread_mutex_unlock(&g_plugin_mutex);
+    return rc;
+}
+
+// DEBUG and TRACE are dropped while the governor is at GOVERNOR_QUIET or above
+static log_level_t governed_log_level(void) {
+    log_level_t level = g_daemon_state.config.log_level;
+    if (g_governor.level >= GOVERNOR_QUIET && level < LOG_INFO) level = LOG_INFO;
+    return level;
+}
+
+// Measure the daemon's CPU use since the last tick and degrade or recover
+static void governor_tick(void) {
+    uint64_t cpu_us;
+    if (governor_self_cpu_us(&cpu_us) != 0) return;
+
+    pthread_mutex_lock(&g_daemon_state.rooms_mutex);
+    governor_level_t before = g_governor.level;
+    governor_level_t level = governor_update(&g_governor, cpu_us, monotonic_ns() / 1000);
+    double cpu_percent = g_governor.cpu_percent;
+    if (level != before) {
+        adaptive_set_hold(level >= GOVERNOR_SLOW);
+        g_publish_every = level >= GOVERNOR_COALESCE ? GOVERNOR_COALESCE_FACTOR : 1;
+        pthread_cond_broadcast(&g_rooms_cond);
+    }
+    pthread_mutex_unlock(&g_daemon_state.rooms_mutex);
+    if (level == before) return;
+
+    logger_set_level(governed_log_level());
+    if (level > before) {
+        log_warn("Daemon CPU %.2f%% over its %.2f%% budget: governor %s -> %s",
+                 cpu_percent, g_cpu_budget_percent,
+                 governor_level_name(before), governor_level_name(level));
+    } else {
+        log_info("Daemon CPU %.2f%% back under its %.2f%% budget: governor %s -> %s",
+                 cpu_percent, g_cpu_budget_percent,
+                 governor_level_name(before), governor_level_name(level));
+    }
+}
+
+int create_room(const char *room_name, int collection_interval, int max_interval) {
     if (!room_name) return -1;
     pthread_mutex_lock(&g_daemon_state.rooms_mutex);
     for(int i=0;i<g_daemon_state.config.max_rooms;i++) {
@@ -149,17 +693,83 @@ int create_room(const char *room_name, int collection_interval) {
     g_daemon_state.rooms[slot].collection_interval = collection_interval > 0 ? collection_interval : g_daemon_state.config.collection_interval;
     g_daemon_state.rooms[slot].active = 0;
     g_daemon_state.rooms[slot].error_count = 0;
+    int interval = g_daemon_state.rooms[slot].collection_interval;
+    adaptive_configure(slot, max_interval > interval ? max_interval * 1000 : 0);
+    room_history_clear(slot);
     g_daemon_state.room_count++;
     g_daemon_stats.rooms_created++;
+    shm_snapshot_publish_room(slot, &g_daemon_state.rooms[slot]);
     pthread_mutex_unlock(&g_daemon_state.rooms_mutex);
     log_info("Created new room %s", room_name);
     return 0;
 }
 
+// Room and client threads run on a fixed stack charged to their subsystem,
+// so max_rooms and max_clients stay within the memory budget. The caller
+// releases MEM_WORKER_STACK_SIZE after joining the thread.
+static int create_budgeted_thread(pthread_t *thread, mem_subsystem_t subsystem,
+                                  void *(*fn)(void *), void *arg) {
+    if (mem_reserve(subsystem, MEM_WORKER_STACK_SIZE) != 0) {
+        log_warn("Memory budget exhausted, refusing a new %s thread", mem_subsystem_name(subsystem));
+        return -1;
+    }
+    pthread_attr_t attr;
+    pthread_attr_init(&attr);
+    pthread_attr_setstacksize(&attr, MEM_WORKER_STACK_SIZE);
+    int rc = pthread_create(thread, &attr, fn, arg);
+    pthread_attr_destroy(&attr);
+    if (rc != 0) {
+        mem_release(subsystem, MEM_WORKER_STACK_SIZE);
+        return -1;
+    }
+    return 0;
+}
+
+// Stop and join a room's monitor thread, whatever state it left the room
+// in, and give its stack back. Called with rooms_mutex held; drops it while
+// joining. Returns -1 if another caller is already stopping the slot or the
+// slot no longer holds this room afterwards; the caller must not touch it.
+static int reap_room_thread(room_info_t *room) {
+    int slot = room_slot(room);
+    if (g_room_threads[slot] == ROOM_THREAD_STOPPING) return -1;
+    if (g_room_threads[slot] == ROOM_THREAD_NONE) return 0;
+
+    g_room_threads[slot] = ROOM_THREAD_STOPPING;
+    pthread_t thread = room->monitor_thread;
+    char name[MAX_ROOM_NAME];
+    memcpy(name, room->name, sizeof(name));
+    room->active = 0;
+    pthread_cond_broadcast(&g_rooms_cond);
+    pthread_mutex_unlock(&g_daemon_state.rooms_mutex);
+    pthread_join(thread, NULL);
+    mem_release(MEM_ROOMS, MEM_WORKER_STACK_SIZE);
+    pthread_mutex_lock(&g_daemon_state.rooms_mutex);
+
+    g_room_threads[slot] = ROOM_THREAD_NONE;
+    if (room->state == ROOM_STATE_INACTIVE || strncmp(room->name, name, sizeof(name)) != 0) {
+        return -1;
+    }
+    return 0;
+}
+
+// Slot is being joined by another command
+static int room_stopping(const room_info_t *room) {
+    return g_room_threads[room_slot(room)] == ROOM_THREAD_STOPPING;
+}
+
 int start_room(const char *room_name) {
     pthread_mutex_lock(&g_daemon_state.rooms_mutex);
     room_info_t *room = find_room(room_name);
-    if (!room) {
+    if (!room || room_stopping(room)) {
+        pthread_mutex_unlock(&g_daemon_state.rooms_mutex);
+        return -1;
+    }
+    if (room->state == ROOM_STATE_RUNNING) {
+        pthread_mutex_unlock(&g_daemon_state.rooms_mutex);
+        return 0;
+    }
+    // A room that stopped on errors still has its old thread to join
+    if (reap_room_thread(room) != 0) {
         pthread_mutex_unlock(&g_daemon_state.rooms_mutex);
         return -1;
     }
@@ -169,12 +779,18 @@ int start_room(const char *room_name) {
     }
     room->active = 1;
     room->state = ROOM_STATE_RUNNING;
-    if (pthread_create(&room->monitor_thread, NULL, room_monitor_thread, room) != 0) {
+    room->error_count = 0;
+    adaptive_start(room_slot(room), room->collection_interval * 1000);
+    if (create_budgeted_thread(&room->monitor_thread, MEM_ROOMS, room_monitor_thread, room) != 0) {
         log_error("Cannot start monitor thread for room %s", room_name);
         room->state = ROOM_STATE_ERROR;
+        adaptive_stop(room_slot(room));
+        shm_snapshot_publish_room(room_slot(room), room);
         pthread_mutex_unlock(&g_daemon_state.rooms_mutex);
         return -1;
     }
+    g_room_threads[room_slot(room)] = ROOM_THREAD_LIVE;
+    shm_snapshot_publish_room(room_slot(room), room);
     pthread_mutex_unlock(&g_daemon_state.rooms_mutex);
     ipc_write_kernel_control(room_name, 1);
     log_info("Started room %s", room_name);
@@ -184,19 +800,21 @@ int start_room(const char *room_name) {
 int stop_room(const char *room_name) {
     pthread_mutex_lock(&g_daemon_state.rooms_mutex);
     room_info_t *room = find_room(room_name);
-    if (!room) {
+    if (!room || room_stopping(room)) {
         pthread_mutex_unlock(&g_daemon_state.rooms_mutex);
         return -1;
     }
-    if(room->state != ROOM_STATE_RUNNING) {
+    if (room->state != ROOM_STATE_RUNNING && g_room_threads[room_slot(room)] == ROOM_THREAD_NONE) {
         pthread_mutex_unlock(&g_daemon_state.rooms_mutex);
         return 0;
     }
-    room->active = 0;
-    pthread_mutex_unlock(&g_daemon_state.rooms_mutex);
-    pthread_join(room->monitor_thread, NULL);
-    pthread_mutex_lock(&g_daemon_state.rooms_mutex);
+    if (reap_room_thread(room) != 0) {
+        pthread_mutex_unlock(&g_daemon_state.rooms_mutex);
+        return -1;
+    }
     room->state = ROOM_STATE_CREATED;
+    adaptive_stop(room_slot(room));
+    shm_snapshot_publish_room(room_slot(room), room);
     pthread_mutex_unlock(&g_daemon_state.rooms_mutex);
     ipc_write_kernel_control(room_name, 0);
     log_info("Stopped room %s", room_name);
@@ -206,33 +824,111 @@ int stop_room(const char *room_name) {
 int delete_room(const char *room_name) {
     pthread_mutex_lock(&g_daemon_state.rooms_mutex);
     room_info_t *room = find_room(room_name);
-    if (!room) {
+    if (!room || reap_room_thread(room) != 0) {
         pthread_mutex_unlock(&g_daemon_state.rooms_mutex);
         return -1;
     }
-    if(room->state == ROOM_STATE_RUNNING) {
-        room->active = 0;
-        pthread_mutex_unlock(&g_daemon_state.rooms_mutex);
-        pthread_join(room->monitor_thread, NULL);
-        pthread_mutex_lock(&g_daemon_state.rooms_mutex);
-    }
     memset(room, 0, sizeof(room_info_t));
     room->state = ROOM_STATE_INACTIVE;
+    shm_snapshot_clear_room(room_slot(room));
+    room_history_clear(room_slot(room));
+    adaptive_configure(room_slot(room), 0);
     g_daemon_state.room_count--;
     g_daemon_stats.rooms_deleted++;
-    pthread_mutex_unlock(&g daemon_state.rooms_mutex);
+    pthread_mutex_unlock(&g_daemon_state.rooms_mutex);
     log_info("Deleted room %s", room_name);
     return 0;
 }
+
+// Write every room with its recent history to the snapshot file
+int checkpoint_daemon_state(void) {
+    if (g_snapshot_path[0] == '\0') return 0;
+
+    state_snapshot_writer_t writer;
+    if (state_snapshot_begin(&writer) != 0) return -1;
+
+    monitor_data_t history[ROOM_HISTORY_DEPTH];
+    int rc = 0;
+    pthread_mutex_lock(&g_daemon_state.rooms_mutex);
+    for (int i = 0; i < g_daemon_state.config.max_rooms && rc == 0; i++) {
+        if (g_daemon_state.rooms[i].state == ROOM_STATE_INACTIVE) continue;
+        room_record_t record;
+        room_record_capture(&g_daemon_state.rooms[i], &record);
+        int count = room_history_copy(i, history, ROOM_HISTORY_DEPTH);
+        rc = state_snapshot_add_room(&writer, &record, history, count);
+    }
+    pthread_mutex_unlock(&g_daemon_state.rooms_mutex);
+
+    if (rc != 0) {
+        state_snapshot_abort(&writer);
+        log_error("Failed to build state snapshot");
+        return -1;
+    }
+    uint32_t rooms = writer.room_count;
+    if (state_snapshot_commit(&writer, g_snapshot_path) != 0) return -1;
+    log_debug("Checkpointed %u rooms to %s", rooms, g_snapshot_path);
+    return 0;
+}
+
+static int restore_snapshot_room(const room_record_t *record, const monitor_data_t *history,
+                                 int history_count, void *ctx) {
+    int *restored = ctx;
+    int slot = room_record_restore(record);
+    if (slot >= 0) {
+        pthread_mutex_lock(&g_daemon_state.rooms_mutex);
+        room_history_restore(slot, history, history_count);
+        pthread_mutex_unlock(&g_daemon_state.rooms_mutex);
+        (*restored)++;
+    }
+    return 0;
+}
+
+// Recreate rooms from the last checkpoint, if any
+int restore_daemon_state(void) {
+    if (g_snapshot_path[0] == '\0') return 0;
+
+    struct timespec t0, t1;
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+    int restored = 0;
+    int stored = state_snapshot_load(g_snapshot_path, restore_snapshot_room, &restored);
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+    if (stored <= 0) return stored;
+
+    double ms = (t1.tv_sec - t0.tv_sec) * 1000.0 + (t1.tv_nsec - t0.tv_nsec) / 1e6;
+    log_info("Restored %d/%d rooms from %s in %.3f ms", restored, stored, g_snapshot_path, ms);
+    log_performance("state_restore", ms);
+    return restored;
+}
+
+// Budget use per subsystem followed by the history pool
+static void format_memory_status(char *buf, size_t size) {
+    room_history_stats_t history;
+    pthread_mutex_lock(&g_daemon_state.rooms_mutex);
+    room_history_stats(&history);
+    pthread_mutex_unlock(&g_daemon_state.rooms_mutex);
+
+    int len = mem_budget_format(buf, size);
+    if (len >= 0 && (size_t)len < size) {
+        snprintf(buf + len, size - (size_t)len,
+                 ", History segments: %d of %d (%lu evicted, %lu samples dropped)",
+                 history.segments, history.capacity, history.evictions, history.dropped);
+    }
+}
+
 int process_command(const command_t *command, response_t *response) {
     if (!command || !response) return -1;
 
-    memset(response, 0, sizeof(response_t));
+    // Every reply is written with snprintf; clearing the whole response
+    // would cost more than the command
+    response->type = RESP_SUCCESS;
+    response->message[0] = '\0';
+    response->data[0] = '\0';
     response->timestamp = time(NULL);
 
+    // `list` is answered by stream_reply() and never gets here
     switch (command->type) {
     case CMD_CREATE_ROOM:
-        if (create_room(command->room_name, command->param1) == 0) {
+        if (create_room(command->room_name, command->param1, command->param2) == 0) {
             response->type = RESP_SUCCESS;
             snprintf(response->message, sizeof(response->message), 
                     "Room '%s' created", command->room_name);
@@ -282,44 +978,70 @@ int process_command(const command_t *command, response_t *response) {
             response->type = RESP_SUCCESS;
             snprintf(response->message, sizeof(response->message), 
                     "Room '%s' data", command->room_name);
-            snprintf(response->data, sizeof(response->data),
-                    "CPU: %.2f%%, Memory: %.2f%%, Processes: %d",
-                    room->latest_data.cpu_usage, room->latest_data.memory_usage,
-                    room->latest_data.process_count);
+            int slot = room_slot(room);
+            int interval_ms = room->state == ROOM_STATE_RUNNING ? adaptive_interval_ms(slot)
+                                                                 : room->collection_interval * 1000;
+            int max_ms = adaptive_max_ms(slot);
+            size_t size = sizeof(response->data);
+            if (command->param1 == SHOW_FORMAT_JSON) {
+                // Extend the sample object with the room's schedule
+                int len = monitor_data_format_json(&room->latest_data, response->data, size);
+                if (len > 0 && (size_t)len < size) {
+                    snprintf(response->data + len - 1, size - (size_t)len + 1,
+                             ",\"interval_ms\":%d,\"max_interval_ms\":%d}", interval_ms, max_ms);
+                }
+            } else {
+                int len = monitor_data_format_text(&room->latest_data, response->data, size);
+                if (len >= 0 && (size_t)len < size) {
+                    if (max_ms) {
+                        snprintf(response->data + len, size - (size_t)len,
+                                 ", Interval: %d ms (adaptive, max %d ms)", interval_ms, max_ms);
+                    } else {
+                        snprintf(response->data + len, size - (size_t)len, ", Interval: %d ms", interval_ms);
+                    }
+                }
+            }
+            pthread_mutex_unlock(&g_daemon_state.rooms_mutex);
+            break;
+        }
+        // Plugins sample under g_plugin_mutex, which is never taken inside rooms_mutex
+        pthread_mutex_unlock(&g_daemon_state.rooms_mutex);
+        if (show_collector_plugin(command->room_name, response->data, sizeof(response->data)) == 0) {
+            response->type = RESP_SUCCESS;
+            snprintf(response->message, sizeof(response->message),
+                    "Collector '%s' data", command->room_name);
         } else {
             response->type = RESP_ROOM_NOT_FOUND;
             snprintf(response->message, sizeof(response->message), 
                     "Room '%s' not found", command->room_name);
         }
-        pthread_mutex_unlock(&g_daemon_state.rooms_mutex);
-        break;
-    }
-    case CMD_LIST_ROOMS: {
-        pthread_mutex_lock(&g_daemon_state.rooms_mutex);
-        char room_list[MAX_MESSAGE_SIZE] = "";
-        for (int i = 0; i < g_daemon_state.config.max_rooms; i++) {
-            if (g_daemon_state.rooms[i].state != ROOM_STATE_INACTIVE) {
-                char tmp[128];
-                snprintf(tmp, sizeof(tmp), "%s (%s), ",
-                        g_daemon_state.rooms[i].name,
-                        g_daemon_state.rooms[i].state == ROOM_STATE_RUNNING ? "running" : "stopped");
-                strncat(room_list, tmp, sizeof(room_list) - strlen(room_list) - 1);
-            }
-        }
-        pthread_mutex_unlock(&g_daemon_state.rooms_mutex);
-        strncpy(response->data, room_list, sizeof(response->data));
-        response->type = RESP_SUCCESS;
-        snprintf(response->message, sizeof(response->message), "Active rooms");
         break;
     }
     case CMD_STATUS:
         response->type = RESP_SUCCESS;
+        if (command->param1 == STATUS_MEMORY) {
+            snprintf(response->message, sizeof(response->message), "Memory usage");
+            format_memory_status(response->data, sizeof(response->data));
+            break;
+        }
         snprintf(response->message, sizeof(response->message), "Daemon status");
+        pthread_mutex_lock(&g_daemon_state.rooms_mutex);
+        double sample_rate = adaptive_sample_rate();
+        double rate_cap = adaptive_rate_cap();
+        governor_t governor = g_governor;
+        pthread_mutex_unlock(&g_daemon_state.rooms_mutex);
+        // The cap only stops adaptive rooms shortening; fixed rooms can exceed it
+        char cap[48] = "no adaptive cap";
+        if (rate_cap > 0) snprintf(cap, sizeof(cap), "adaptive rooms capped at %.2f", rate_cap);
         snprintf(response->data, sizeof(response->data),
-                "Uptime: %ld seconds, Rooms: %d, Commands processed: %lu",
+                "Uptime: %ld seconds, Rooms: %d, Commands processed: %lu, Samples/sec: %.2f (%s), "
+                "Daemon CPU: %.2f%% (budget %.2f%%), Governor: %s (%lu escalations, %lu recoveries)",
                 time(NULL) - g_daemon_state.start_time,
                 g_daemon_state.room_count,
-                g_daemon_stats.commands_processed);
+                g_daemon_stats.commands_processed,
+                sample_rate, cap,
+                governor.cpu_percent, governor.budget_percent,
+                governor_level_name(governor.level), governor.escalations, governor.recoveries);
         break;
     default:
         response->type = RESP_INVALID_COMMAND;
@@ -336,6 +1058,9 @@ int receive_command_from_client(int client_socket, command_t *command) {
     if (received <= 0) return -1;
     buffer[received] = '\0';
     char cmd_str[64];
+    command->room_name[0] = '\0';
+    command->param1 = 0;
+    command->param2 = 0;
     if (sscanf(buffer, "%63s %63s %d %d", cmd_str, command->room_name, &command->param1, &command->param2) >= 1) {
         if (strcmp(cmd_str, "create") == 0) command->type = CMD_CREATE_ROOM;
         else if (strcmp(cmd_str, "start") == 0) command->type = CMD_START_ROOM;
@@ -344,36 +1069,193 @@ int receive_command_from_client(int client_socket, command_t *command) {
         else if (strcmp(cmd_str, "show") == 0) command->type = CMD_SHOW_ROOM;
         else if (strcmp(cmd_str, "list") == 0) command->type = CMD_LIST_ROOMS;
         else if (strcmp(cmd_str, "status") == 0) command->type = CMD_STATUS;
+        else if (strcmp(cmd_str, "memory") == 0) command->type = CMD_STATUS;
         else return -1;
+        if (command->type == CMD_SHOW_ROOM) {
+            // `show <room> json` picks JSON over the text summary and
+            // `show <room> history` streams the recent samples
+            char format[16] = "";
+            sscanf(buffer, "%*s %*s %15s", format);
+            command->param1 = strcmp(format, "json") == 0 ? SHOW_FORMAT_JSON :
+                              strcmp(format, "history") == 0 ? SHOW_FORMAT_HISTORY : SHOW_FORMAT_TEXT;
+        }
+        if (command->type == CMD_STATUS) {
+            // `memory` and `status memory` report the memory budget
+            int memory = strcmp(cmd_str, "memory") == 0 || strcmp(command->room_name, "memory") == 0;
+            command->param1 = memory ? STATUS_MEMORY : STATUS_SUMMARY;
+        }
         command->timestamp = time(NULL);
         return 0;
     }
     return -1;
 }
 
+// writev() with MSG_NOSIGNAL; resumes after partial sends until all is out
+static int send_iov(int fd, struct iovec *iov, int count) {
+    struct msghdr msg;
+    memset(&msg, 0, sizeof(msg));
+    msg.msg_iov = iov;
+    msg.msg_iovlen = (size_t)count;
+    while (msg.msg_iovlen > 0) {
+        ssize_t sent = sendmsg(fd, &msg, MSG_NOSIGNAL);
+        if (sent < 0) {
+            if (errno == EINTR) continue;
+            return -1;
+        }
+        while (msg.msg_iovlen > 0 && (size_t)sent >= msg.msg_iov->iov_len) {
+            sent -= (ssize_t)msg.msg_iov->iov_len;
+            msg.msg_iov++;
+            msg.msg_iovlen--;
+        }
+        if (msg.msg_iovlen > 0) {
+            msg.msg_iov->iov_base = (char *)msg.msg_iov->iov_base + sent;
+            msg.msg_iov->iov_len -= (size_t)sent;
+        }
+    }
+    return 0;
+}
+
+// Send the reply straight from the response fields, without staging a copy
 int send_response_to_client(int client_socket, const response_t *response) {
-    char buffer[2048];
-    int len = snprintf(buffer, sizeof(buffer), "%s: %s",
-                      (response->type == RESP_SUCCESS) ? "SUCCESS" : "ERROR",
-                      response->message);
+    static char data_label[] = "\nData: ";
+    static char newline[] = "\n";
+    char *status = response->type == RESP_SUCCESS ? "SUCCESS: " : "ERROR: ";
+    struct iovec iov[5];
+    int count = 0;
+    iov[count++] = (struct iovec){ status, strlen(status) };
+    iov[count++] = (struct iovec){ (char *)response->message,
+                                   strnlen(response->message, sizeof(response->message)) };
     if (response->data[0] != '\0') {
-        len += snprintf(buffer + len, sizeof(buffer) - len, "\nData: %s", response->data);
+        iov[count++] = (struct iovec){ data_label, sizeof(data_label) - 1 };
+        iov[count++] = (struct iovec){ (char *)response->data,
+                                       strnlen(response->data, sizeof(response->data)) };
+    }
+    iov[count++] = (struct iovec){ newline, sizeof(newline) - 1 };
+    return send_iov(client_socket, iov, count);
+}
+
+// Tell a client the budget has no room for it before hanging up
+static void refuse_client(int fd) {
+    static char refusal[] = "ERROR: Memory budget exhausted, try again later\n";
+    struct iovec iov = { refusal, sizeof(refusal) - 1 };
+    send_iov(fd, &iov, 1);
+}
+
+// `list` straight into the socket. rooms_mutex is held while a chunk is
+// filled and dropped while it drains, so a slow reader never stalls the
+// room threads and the walk stays linear in the number of rooms. Returns -1
+// once the client stops reading.
+static int stream_room_list(int fd, response_stream_t *out) {
+    response_stream_init(out, fd);
+    if (response_stream_printf(out, "SUCCESS: Active rooms") != 0) return -1;
+    int slot = 0, listed = 0, done = 0;
+    while (!done) {
+        pthread_mutex_lock(&g_daemon_state.rooms_mutex);
+        for (; slot < g_daemon_state.config.max_rooms; slot++) {
+            room_info_t *room = &g_daemon_state.rooms[slot];
+            if (room->state == ROOM_STATE_INACTIVE) continue;
+            if (response_stream_append(out, "%s%s (%s), ", listed ? "" : "\nData: ", room->name,
+                                       room->state == ROOM_STATE_RUNNING ? "running" : "stopped") != 0) {
+                break;
+            }
+            listed++;
+        }
+        done = slot >= g_daemon_state.config.max_rooms;
+        pthread_mutex_unlock(&g_daemon_state.rooms_mutex);
+        if (!done && response_stream_flush(out) != 0) return -1;
     }
-    len += snprintf(buffer + len, sizeof(buffer) - len, "\n");
-    return (send(client_socket, buffer, len, MSG_NOSIGNAL) == len) ? 0 : -1;
+    if (response_stream_printf(out, "\n") != 0) return -1;
+    return response_stream_flush(out);
+}
+
+// `show <room> history`, oldest sample first. Returns 1 for names that are
+// not rooms so the regular show reports them, -1 once the client stops
+// reading.
+static int stream_room_history(int fd, client_session_t *session) {
+    pthread_mutex_lock(&g_daemon_state.rooms_mutex);
+    room_info_t *room = find_room(session->command.room_name);
+    int count = room ? room_history_copy(room_slot(room), session->history, ROOM_HISTORY_DEPTH) : -1;
+    pthread_mutex_unlock(&g_daemon_state.rooms_mutex);
+    if (count < 0) return 1;
+
+    response_stream_t *out = &session->stream;
+    response_stream_init(out, fd);
+    if (response_stream_printf(out, "SUCCESS: Room '%s' history (%d samples)",
+                               session->command.room_name, count) != 0) {
+        return -1;
+    }
+    for (int i = 0; i < count; i++) {
+        char sample[256];
+        monitor_data_format_text(&session->history[i], sample, sizeof(sample));
+        if (response_stream_printf(out, "%s[%ld] %s; ", i ? "" : "\nData: ",
+                                   (long)session->history[i].timestamp, sample) != 0) {
+            return -1;
+        }
+    }
+    if (response_stream_printf(out, "\n") != 0) return -1;
+    return response_stream_flush(out);
+}
+
+// Answer commands whose reply can outgrow a response_t. Returns 1 when the
+// command takes the process_command() path instead and -1 when the client
+// stopped reading partway.
+static int stream_reply(int fd, client_session_t *session) {
+    const command_t *command = &session->command;
+    int rc = 1;
+    if (command->type == CMD_LIST_ROOMS) {
+        rc = stream_room_list(fd, &session->stream);
+    } else if (command->type == CMD_SHOW_ROOM && command->param1 == SHOW_FORMAT_HISTORY) {
+        rc = stream_room_history(fd, session);
+    }
+    if (rc == 0) g_daemon_stats.commands_processed++;
+    return rc;
+}
+
+// Wait until the socket is readable; returns 0 when the thread should stop
+static int wait_readable(int fd) {
+    while (g_daemon_state.running && !g_io_suspended) {
+        struct pollfd pfd = { .fd = fd, .events = POLLIN };
+        int rc = poll(&pfd, 1, IO_POLL_TIMEOUT_MS);
+        if (rc > 0) return 1;
+        if (rc < 0 && errno != EINTR) return 0;
+    }
+    return 0;
 }
 
 void* client_handler_thread(void *arg) {
     client_connection_t *client = (client_connection_t*)arg;
     log_info("Client connected: %s:%d",
              inet_ntoa(client->address.sin_addr), ntohs(client->address.sin_port));
-    while (g_daemon_state.running && client->active) {
-        command_t command;
-        response_t response;
-        if (receive_command_from_client(client->socket_fd, &command) != 0) break;
+    pthread_mutex_lock(&g_session_mutex);
+    client_session_t *session = mem_pool_alloc(&g_session_pool);
+    pthread_mutex_unlock(&g_session_mutex);
+    if (!session) {
+        log_warn("Memory budget exhausted, no session for client");
+        refuse_client(client->socket_fd);
+    }
+
+    while (session && g_daemon_state.running && client->active) {
+        if (!wait_readable(client->socket_fd)) break;
+        if (receive_command_from_client(client->socket_fd, &session->command) != 0) break;
         client->last_activity = time(NULL);
-        process_command(&command, &response);
-        send_response_to_client(client->socket_fd, &response);
+        int streamed = stream_reply(client->socket_fd, session);
+        if (streamed < 0) {
+            log_warn("Client %s stopped reading a streamed reply",
+                     inet_ntoa(client->address.sin_addr));
+            break;
+        }
+        if (streamed > 0) {
+            process_command(&session->command, &session->response);
+            if (send_response_to_client(client->socket_fd, &session->response) != 0) break;
+        }
+    }
+    pthread_mutex_lock(&g_session_mutex);
+    mem_pool_free(&g_session_pool, session);
+    pthread_mutex_unlock(&g_session_mutex);
+
+    if (g_io_suspended && client->active) {
+        // Connection is being handed to another process; leave it open
+        return NULL;
     }
     log_info("Client disconnected: %s:%d",
              inet_ntoa(client->address.sin_addr), ntohs(client->address.sin_port));
@@ -382,12 +1264,82 @@ void* client_handler_thread(void *arg) {
     return NULL;
 }
 
+// Join a slot's finished handler thread and give its stack back. Caller
+// holds clients_mutex or has stopped the network thread.
+static void reap_client_thread(int slot) {
+    if (!g_client_threads[slot]) return;
+    pthread_join(g_daemon_state.clients[slot].thread, NULL);
+    g_client_threads[slot] = 0;
+    mem_release(MEM_CLIENTS, MEM_WORKER_STACK_SIZE);
+}
+
+static int start_client_thread(int slot) {
+    if (create_budgeted_thread(&g_daemon_state.clients[slot].thread, MEM_CLIENTS,
+                               client_handler_thread, &g_daemon_state.clients[slot]) != 0) {
+        return -1;
+    }
+    g_client_threads[slot] = 1;
+    return 0;
+}
+
+// Take ownership of a connected socket and start its handler thread
+int adopt_client_connection(int client_socket, const struct sockaddr_in *address, time_t connect_time) {
+    pthread_mutex_lock(&g_daemon_state.clients_mutex);
+    int client_slot = -1;
+    for (int i = 0; i < g_daemon_state.config.max_clients; i++) {
+        if (!g_daemon_state.clients[i].active) {
+            client_slot = i;
+            break;
+        }
+    }
+    if (client_slot == -1) {
+        pthread_mutex_unlock(&g_daemon_state.clients_mutex);
+        log_warn("Max clients reached, rejecting connection");
+        close(client_socket);
+        return -1;
+    }
+    reap_client_thread(client_slot);
+    g_daemon_state.clients[client_slot].socket_fd = client_socket;
+    g_daemon_state.clients[client_slot].address = *address;
+    g_daemon_state.clients[client_slot].connect_time = connect_time;
+    g_daemon_state.clients[client_slot].last_activity = time(NULL);
+    g_daemon_state.clients[client_slot].authenticated = 1;
+    g_daemon_state.clients[client_slot].active = 1;
+    if (start_client_thread(client_slot) != 0) {
+        log_error("Failed to create client handler thread");
+        refuse_client(client_socket);
+        close(client_socket);
+        g_daemon_state.clients[client_slot].active = 0;
+        pthread_mutex_unlock(&g_daemon_state.clients_mutex);
+        return -1;
+    }
+    g_daemon_state.client_count++;
+    pthread_mutex_unlock(&g_daemon_state.clients_mutex);
+    return 0;
+}
+
+// Join handlers whose client has gone so their stacks are not held until
+// the slot is reused
+static void reap_finished_clients(void) {
+    pthread_mutex_lock(&g_daemon_state.clients_mutex);
+    for (int i = 0; i < g_daemon_state.config.max_clients; i++) {
+        if (g_client_threads[i] && !g_daemon_state.clients[i].active) reap_client_thread(i);
+    }
+    pthread_mutex_unlock(&g_daemon_state.clients_mutex);
+}
+
 void* network_thread(void *arg) {
     (void)arg;
     struct sockaddr_in client_addr;
     socklen_t client_len = sizeof(client_addr);
     log_info("Starting network thread on port %d", g_daemon_state.config.daemon_port);
-    while (g_daemon_state.running) {
+    while (g_daemon_state.running && !g_io_suspended) {
+        reap_finished_clients();
+        struct pollfd pfd = { .fd = g_daemon_state.server_socket, .events = POLLIN };
+        int rc = poll(&pfd, 1, IO_POLL_TIMEOUT_MS);
+        if (rc < 0 && errno != EINTR) break;
+        if (rc <= 0) continue;
+        client_len = sizeof(client_addr);
         int client_socket = accept(g_daemon_state.server_socket,
                                   (struct sockaddr*)&client_addr, &client_len);
         if (client_socket < 0) {
@@ -395,41 +1347,44 @@ void* network_thread(void *arg) {
                 log_error("Accept failed: %s", strerror(errno));
             continue;
         }
-        pthread_mutex_lock(&g_daemon_state.clients_mutex);
-        int client_slot = -1;
-        for (int i = 0; i < g_daemon_state.config.max_clients; i++) {
-            if (!g_daemon_state.clients[i].active) {
-                client_slot = i;
-                break;
-            }
-        }
-        if (client_slot == -1) {
-            pthread_mutex_unlock(&g_daemon_state.clients_mutex);
-            log_warn("Max clients reached, rejecting connection");
-            close(client_socket);
-            continue;
-        }
-        g_daemon_state.clients[client_slot].socket_fd = client_socket;
-        g_daemon_state.clients[client_slot].address = client_addr;
-        g_daemon_state.clients[client_slot].connect_time = time(NULL);
-        g_daemon_state.clients[client_slot].last_activity = time(NULL);
-        g_daemon_state.clients[client_slot].authenticated = 1;
-        g_daemon_state.clients[client_slot].active = 1;
-        if (pthread_create(&g_daemon_state.clients[client_slot].thread,
-                          NULL, client_handler_thread, &g_daemon_state.clients[client_slot]) != 0) {
-            log_error("Failed to create client handler thread");
-            close(client_socket);
-            g_daemon_state.clients[client_slot].active = 0;
-        } else {
-            g_daemon_state.client_count++;
-        }
-        pthread_mutex_unlock(&g_daemon_state.clients_mutex);
+        adopt_client_connection(client_socket, &client_addr, time(NULL));
     }
     log_info("Network thread stopped");
     return NULL;
 }
 
-static int initialize_server_socket(void) {
+// Park the accept loop and every client handler without closing sockets
+int suspend_network_io(void) {
+    g_io_suspended = 1;
+    pthread_join(g_daemon_state.network_thread, NULL);
+    for (int i = 0; i < g_daemon_state.config.max_clients; i++) {
+        if (g_daemon_state.clients[i].active) reap_client_thread(i);
+    }
+    log_info("Network I/O suspended");
+    return 0;
+}
+
+// Undo suspend_network_io() after a failed handoff
+int resume_network_io(void) {
+    g_io_suspended = 0;
+    pthread_mutex_lock(&g_daemon_state.clients_mutex);
+    for (int i = 0; i < g_daemon_state.config.max_clients; i++) {
+        if (g_daemon_state.clients[i].active && start_client_thread(i) != 0) {
+            log_error("Failed to restart client handler thread");
+            close(g_daemon_state.clients[i].socket_fd);
+            g_daemon_state.clients[i].active = 0;
+        }
+    }
+    pthread_mutex_unlock(&g_daemon_state.clients_mutex);
+    if (pthread_create(&g_daemon_state.network_thread, NULL, network_thread, NULL) != 0) {
+        log_error("Failed to restart network thread");
+        return -1;
+    }
+    log_info("Network I/O resumed");
+    return 0;
+}
+
+int initialize_server_socket(void) {
     int server_socket = socket(AF_INET, SOCK_STREAM, 0);
     if (server_socket < 0) {
         log_error("Failed to create socket: %s", strerror(errno));
@@ -455,19 +1410,25 @@ static int initialize_server_socket(void) {
     return server_socket;
 }
 
-static void signal_handler(int sig) {
+void signal_handler(int sig) {
+    if (sig == SIGHUP) {
+        // Reload happens on the main loop, outside signal context
+        g_reload_requested = 1;
+        return;
+    }
     log_info("Received signal %d, stopping daemon", sig);
     g_daemon_state.running = 0;
 }
 
-static int install_signal_handlers(void) {
+int install_signal_handlers(void) {
     signal(SIGINT, signal_handler);
     signal(SIGTERM, signal_handler);
+    signal(SIGHUP, signal_handler);
     signal(SIGPIPE, SIG_IGN);
     return 0;
 }
 
-static int create_pid_file(const char *pid_file) {
+int create_pid_file(const char *pid_file) {
     FILE *fp = fopen(pid_file, "w");
     if (!fp) return -1;
     fprintf(fp, "%d\n", getpid());
@@ -475,23 +1436,44 @@ static int create_pid_file(const char *pid_file) {
     return 0;
 }
 
-static int remove_pid_file(const char *pid_file) {
+int remove_pid_file(const char *pid_file) {
     return unlink(pid_file);
 }
 
-static void cleanup_on_exit(void) {
+void cleanup_on_exit(void) {
     log_info("Cleaning up before exit");
     g_daemon_state.running = 0;
 
-    // Stop all room threads
+    // Record the rooms as they were running so the next start resumes them
+    checkpoint_daemon_state();
+
+    // Stop all room threads. They take rooms_mutex to publish samples, so
+    // join them only after releasing it. Slots a client command is already
+    // stopping are left to that command.
+    int stopping[g_daemon_state.config.max_rooms];
+    pthread_t threads[g_daemon_state.config.max_rooms];
     pthread_mutex_lock(&g_daemon_state.rooms_mutex);
     for (int i = 0; i < g_daemon_state.config.max_rooms; i++) {
-        if (g_daemon_state.rooms[i].active) {
-            g_daemon_state.rooms[i].active = 0;
-            pthread_join(g_daemon_state.rooms[i].monitor_thread, NULL);
+        // Includes threads that already exited on errors
+        stopping[i] = g_room_threads[i] == ROOM_THREAD_LIVE;
+        if (stopping[i]) {
+            g_room_threads[i] = ROOM_THREAD_STOPPING;
+            threads[i] = g_daemon_state.rooms[i].monitor_thread;
         }
+        g_daemon_state.rooms[i].active = 0;
     }
+    pthread_cond_broadcast(&g_rooms_cond);
     pthread_mutex_unlock(&g_daemon_state.rooms_mutex);
+    for (int i = 0; i < g_daemon_state.config.max_rooms; i++) {
+        if (stopping[i]) {
+            pthread_join(threads[i], NULL);
+            mem_release(MEM_ROOMS, MEM_WORKER_STACK_SIZE);
+        }
+    }
+    stop_pressure_triggers();
+    stop_collector_plugins();
+
+    upgrade_listener_stop();
 
     // Close server socket
     if (g_daemon_state.server_socket >= 0)
@@ -503,13 +1485,17 @@ static void cleanup_on_exit(void) {
         if (g_daemon_state.clients[i].active) {
             close(g_daemon_state.clients[i].socket_fd);
             g_daemon_state.clients[i].active = 0;
-            pthread_join(g_daemon_state.clients[i].thread, NULL);
         }
+        reap_client_thread(i);
     }
     pthread_mutex_unlock(&g_daemon_state.clients_mutex);
+    mem_pool_destroy(&g_session_pool);
 
-    // Clean up IPC and logger
+    // Clean up IPC, shared memory, history and logger
     ipc_cleanup();
+    shm_snapshot_cleanup();
+    room_history_cleanup();
+    adaptive_cleanup();
     remove_pid_file(g_daemon_state.config.pid_file);
     logger_cleanup();
 }
@@ -517,11 +1503,17 @@ static void cleanup_on_exit(void) {
 int main(int argc, char *argv[]) {
     const char *config_file = DEFAULT_CONFIG_FILE;
     int daemon_mode = 0;
+    int upgrade_mode = 0;
+    int supervise_mode = 0;
     for (int i = 1; i < argc; i++) {
         if (strcmp(argv[i], "--config") == 0 && i + 1 < argc) {
             config_file = argv[++i];
         } else if (strcmp(argv[i], "--daemon") == 0) {
             daemon_mode = 1;
+        } else if (strcmp(argv[i], "--upgrade") == 0) {
+            upgrade_mode = 1;
+        } else if (strcmp(argv[i], "--supervise") == 0) {
+            supervise_mode = 1;
         }
     }
 
@@ -540,6 +1532,32 @@ int main(int argc, char *argv[]) {
     }
 
     log_info("=== Process Monitor Integration Daemon Starting ===");
+
+    // The supervisor can only watch a daemon it forked itself
+    if (supervise_mode && upgrade_mode) {
+        log_error("--upgrade cannot be combined with --supervise");
+        logger_cleanup();
+        return 1;
+    }
+
+    // Under --supervise the listening socket is owned by the supervisor so
+    // connections queue in its backlog while a crashed daemon is replaced
+    int listen_fd = -1;
+    if (supervise_mode) {
+        listen_fd = initialize_server_socket();
+        if (listen_fd < 0) {
+            log_error("Failed to create server socket");
+            return 1;
+        }
+        int exit_status = 0;
+        int rc = supervisor_run(&exit_status);
+        if (rc != 0) {
+            close(listen_fd);
+            logger_cleanup();
+            return rc < 0 ? 1 : exit_status;
+        }
+    }
+
     log_info("PID: %d", getpid());
 
     // Initialize global state
@@ -547,18 +1565,73 @@ int main(int argc, char *argv[]) {
     g_daemon_state.start_time = time(NULL);
     pthread_mutex_init(&g_daemon_state.rooms_mutex, NULL);
     pthread_mutex_init(&g_daemon_state.clients_mutex, NULL);
+    pthread_condattr_t cond_attr;
+    pthread_condattr_init(&cond_attr);
+    pthread_condattr_setclock(&cond_attr, CLOCK_MONOTONIC);
+    pthread_cond_init(&g_rooms_cond, &cond_attr);
+    pthread_condattr_destroy(&cond_attr);
 
     // Install signal handlers
     install_signal_handlers();
 
+    // A restarted child picks up config edits made since the supervisor started
+    if (supervise_mode && supervisor_restarts() > 0) {
+        reload_configuration();
+    }
+
+    // The fixed tables are held whatever the budget says
+    mem_charge(MEM_ROOMS, sizeof(g_daemon_state.rooms));
+    mem_charge(MEM_CLIENTS, sizeof(g_daemon_state.clients));
+    mem_pool_init(&g_session_pool, MEM_CLIENTS, sizeof(client_session_t), SESSIONS_PER_CHUNK);
+
+    // History and the shared table cover every slot so max_rooms can grow on reload
+    if (room_history_init(ROOM_TABLE_CAPACITY) != 0) {
+        log_warn("Room history unavailable");
+    }
+    if (adaptive_init(ROOM_TABLE_CAPACITY) != 0) {
+        return 1;
+    }
+
+    // Take over sockets and rooms from the running daemon. The old process
+    // stops collecting once it has sent its state.
+    upgrade_state_t handoff;
+    memset(&handoff, 0, sizeof(handoff));
+    if (upgrade_mode) {
+        if (upgrade_receive_state(UPGRADE_SOCKET_PATH, &handoff) != 0) {
+            log_error("Upgrade handoff failed");
+            return 1;
+        }
+        // Take over before starting anything; if the old process did not
+        // let go, it is still serving and this one must not
+        if (upgrade_complete(&handoff, 1) != 0) {
+            log_error("Running daemon did not release its sockets, exiting");
+            return 1;
+        }
+        g_daemon_state.start_time = (time_t)handoff.header.start_time;
+        g_daemon_stats = handoff.header.stats;
+    }
+
     // Initialize IPC system
     if (ipc_init() != 0) {
         log_error("Failed to initialize IPC");
         return 1;
     }
 
+    // Publish room table for local readers (optional)
+    if (shm_snapshot_init(NULL, ROOM_TABLE_CAPACITY) != 0) {
+        log_warn("Shared memory snapshot unavailable, continuing without it");
+    } else {
+        mem_charge(MEM_SHARED, SHM_SNAPSHOT_SIZE(ROOM_TABLE_CAPACITY));
+    }
+
     // Initialize server socket
-    g_daemon_state.server_socket = initialize_server_socket();
+    if (upgrade_mode) {
+        g_daemon_state.server_socket = handoff.listen_fd;
+    } else if (listen_fd >= 0) {
+        g_daemon_state.server_socket = listen_fd;
+    } else {
+        g_daemon_state.server_socket = initialize_server_socket();
+    }
     if (g_daemon_state.server_socket < 0) {
         log_error("Failed to create server socket");
         return 1;
@@ -573,14 +1646,71 @@ int main(int argc, char *argv[]) {
         return 1;
     }
 
+    if (upgrade_mode) {
+        int restored = 0;
+        const monitor_data_t *history = handoff.history;
+        for (uint32_t i = 0; i < handoff.header.room_count; i++) {
+            int slot = room_record_restore(&handoff.rooms[i]);
+            if (slot >= 0) {
+                pthread_mutex_lock(&g_daemon_state.rooms_mutex);
+                room_history_restore(slot, history, (int)handoff.history_counts[i]);
+                pthread_mutex_unlock(&g_daemon_state.rooms_mutex);
+                restored++;
+            }
+            history += handoff.history_counts[i];
+        }
+        for (uint32_t i = 0; i < handoff.header.client_count; i++) {
+            adopt_client_connection(handoff.client_fds[i], &handoff.clients[i].address,
+                                    (time_t)handoff.clients[i].connect_time);
+        }
+        upgrade_release(&handoff);
+        log_info("Upgrade complete: resumed %d/%u rooms and %u clients",
+                 restored, handoff.header.room_count, handoff.header.client_count);
+    } else {
+        restore_daemon_state();
+    }
+
+    start_pressure_triggers();
+    start_collector_plugins();
+
+    // Accept future upgrade requests
+    if (upgrade_listener_start(UPGRADE_SOCKET_PATH) != 0) {
+        log_warn("Upgrade socket unavailable, --upgrade handoff disabled");
+    }
+
+    governor_init(&g_governor, g_cpu_budget_percent);
+
     // Main loop
+    time_t last_status = time(NULL);
+    time_t last_checkpoint = time(NULL);
     while (g_daemon_state.running) {
-        sleep(10);
-        log_debug("Daemon uptime: %ld seconds, rooms: %d, clients: %d, commands: %lu",
-                  time(NULL) - g_daemon_state.start_time,
-                  g_daemon_state.room_count,
-                  g_daemon_state.client_count,
-                  g_daemon_stats.commands_processed);
+        // Beat several times a second so the supervisor catches a hang quickly
+        for (int tick = 0; tick < 1000 / SUPERVISOR_HEARTBEAT_INTERVAL_MS &&
+                           g_daemon_state.running; tick++) {
+            supervisor_heartbeat();
+            usleep(SUPERVISOR_HEARTBEAT_INTERVAL_MS * 1000);
+        }
+        if (g_reload_requested) {
+            g_reload_requested = 0;
+            reload_configuration();
+        }
+        governor_tick();
+        time_t now = time(NULL);
+        // Only this thread moves the governor, so its level is read unlocked
+        int checkpoint_interval = g_snapshot_interval *
+            (g_governor.level >= GOVERNOR_COALESCE ? GOVERNOR_COALESCE_FACTOR : 1);
+        if (g_snapshot_interval > 0 && now - last_checkpoint >= checkpoint_interval) {
+            checkpoint_daemon_state();
+            last_checkpoint = now;
+        }
+        if (now - last_status >= 10) {
+            log_debug("Daemon uptime: %ld seconds, rooms: %d, clients: %d, commands: %lu",
+                      now - g_daemon_state.start_time,
+                      g_daemon_state.room_count,
+                      g_daemon_state.client_count,
+                      g_daemon_stats.commands_processed);
+            last_status = now;
+        }
     }
 
     // Cleanup on exit
@@ -16,6 +16,17 @@
 #define DEFAULT_MAX_ROOMS 10
 #define DEFAULT_MAX_CLIENTS 50
 #define DEFAULT_COLLECTION_INTERVAL 5
+#define DEFAULT_SNAPSHOT_FILE "/tmp/monitor_daemon.snap"
+#define DEFAULT_SNAPSHOT_INTERVAL 30
+
+// `show` output formats, carried in command_t.param1
+#define SHOW_FORMAT_TEXT 0
+#define SHOW_FORMAT_JSON 1
+#define SHOW_FORMAT_HISTORY 2     // streamed by the client handler
+
+// Sections of the status reply (command_t.param1 of CMD_STATUS)
+#define STATUS_SUMMARY 0
+#define STATUS_MEMORY 1
 
 // Thread types
 typedef enum {
@@ -46,7 +57,8 @@ int validate_configuration(const config_t *config);
 void print_configuration(void);
 
 // Room management functions
-int create_room(const char *room_name, int collection_interval);
+// max_interval > collection_interval makes the room adaptive (seconds)
+int create_room(const char *room_name, int collection_interval, int max_interval);
 int start_room(const char *room_name);
 int stop_room(const char *room_name);
 int delete_room(const char *room_name);
@@ -54,12 +66,21 @@ room_info_t* find_room(const char *room_name);
 int get_room_data(const char *room_name, monitor_data_t *data);
 int list_rooms(char *buffer, size_t buffer_size);
 
+// State snapshot functions
+int checkpoint_daemon_state(void);
+int restore_daemon_state(void);
+
 // Client management functions
 int accept_client_connection(int server_socket);
 void* client_handler_thread(void *arg);
 int send_response_to_client(int client_socket, const response_t *response);
 int receive_command_from_client(int client_socket, command_t *command);
 void disconnect_client(int client_id);
+int adopt_client_connection(int client_socket, const struct sockaddr_in *address, time_t connect_time);
+
+// Upgrade handoff support
+int suspend_network_io(void);
+int resume_network_io(void);
 
 // Command processing functions
 int process_command(const command_t *command, response_t *response);
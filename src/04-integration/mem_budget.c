@@ -0,0 +1,182 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include "mem_budget.h"
+#include "logger.h"
+
+#define MEM_ALIGN 16
+#define ROUND_UP(n) (((n) + MEM_ALIGN - 1) & ~(size_t)(MEM_ALIGN - 1))
+
+struct mem_chunk {
+    mem_chunk_t *next;
+    size_t bytes;           // charged to the pool's subsystem
+};
+
+static const char *subsystem_names[MEM_SUBSYSTEMS] = { "rooms", "clients", "history", "snapshot", "shm" };
+
+static pthread_mutex_t budget_mutex = PTHREAD_MUTEX_INITIALIZER;
+static size_t budget_limit = (size_t)MEM_DEFAULT_BUDGET_KB * 1024;
+static size_t used[MEM_SUBSYSTEMS];
+static size_t total_used = 0;
+static unsigned long refusals = 0;
+
+void mem_budget_set_limit(size_t bytes) {
+    pthread_mutex_lock(&budget_mutex);
+    budget_limit = bytes;
+    pthread_mutex_unlock(&budget_mutex);
+}
+
+size_t mem_budget_limit(void) {
+    pthread_mutex_lock(&budget_mutex);
+    size_t limit = budget_limit;
+    pthread_mutex_unlock(&budget_mutex);
+    return limit;
+}
+
+int mem_reserve(mem_subsystem_t subsystem, size_t bytes) {
+    if ((unsigned)subsystem >= MEM_SUBSYSTEMS) return -1;
+    pthread_mutex_lock(&budget_mutex);
+    if (budget_limit && (total_used > budget_limit || bytes > budget_limit - total_used)) {
+        refusals++;
+        pthread_mutex_unlock(&budget_mutex);
+        return -1;
+    }
+    used[subsystem] += bytes;
+    total_used += bytes;
+    pthread_mutex_unlock(&budget_mutex);
+    return 0;
+}
+
+void mem_charge(mem_subsystem_t subsystem, size_t bytes) {
+    if ((unsigned)subsystem >= MEM_SUBSYSTEMS) return;
+    pthread_mutex_lock(&budget_mutex);
+    used[subsystem] += bytes;
+    total_used += bytes;
+    pthread_mutex_unlock(&budget_mutex);
+}
+
+void mem_release(mem_subsystem_t subsystem, size_t bytes) {
+    if ((unsigned)subsystem >= MEM_SUBSYSTEMS) return;
+    pthread_mutex_lock(&budget_mutex);
+    if (bytes > used[subsystem]) {
+        log_warn("Memory accounting for %s released %zu bytes of %zu",
+                 subsystem_names[subsystem], bytes, used[subsystem]);
+        bytes = used[subsystem];
+    }
+    used[subsystem] -= bytes;
+    total_used -= bytes;
+    pthread_mutex_unlock(&budget_mutex);
+}
+
+size_t mem_used(mem_subsystem_t subsystem) {
+    if ((unsigned)subsystem >= MEM_SUBSYSTEMS) return 0;
+    pthread_mutex_lock(&budget_mutex);
+    size_t bytes = used[subsystem];
+    pthread_mutex_unlock(&budget_mutex);
+    return bytes;
+}
+
+size_t mem_total_used(void) {
+    pthread_mutex_lock(&budget_mutex);
+    size_t bytes = total_used;
+    pthread_mutex_unlock(&budget_mutex);
+    return bytes;
+}
+
+unsigned long mem_refusals(void) {
+    pthread_mutex_lock(&budget_mutex);
+    unsigned long count = refusals;
+    pthread_mutex_unlock(&budget_mutex);
+    return count;
+}
+
+const char *mem_subsystem_name(mem_subsystem_t subsystem) {
+    return (unsigned)subsystem < MEM_SUBSYSTEMS ? subsystem_names[subsystem] : "unknown";
+}
+
+int mem_budget_format(char *buf, size_t size) {
+    pthread_mutex_lock(&budget_mutex);
+    size_t snapshot[MEM_SUBSYSTEMS];
+    memcpy(snapshot, used, sizeof(snapshot));
+    size_t total = total_used, limit = budget_limit;
+    unsigned long refused = refusals;
+    pthread_mutex_unlock(&budget_mutex);
+
+    int len;
+    if (limit) {
+        len = snprintf(buf, size, "Used: %zu kB of %zu kB (%.1f%%)", total / 1024, limit / 1024,
+                       100.0 * (double)total / (double)limit);
+    } else {
+        len = snprintf(buf, size, "Used: %zu kB (unlimited)", total / 1024);
+    }
+    for (int i = 0; i < MEM_SUBSYSTEMS && len >= 0 && (size_t)len < size; i++) {
+        len += snprintf(buf + len, size - (size_t)len, ", %s: %zu kB", subsystem_names[i], snapshot[i] / 1024);
+    }
+    if (len >= 0 && (size_t)len < size) {
+        len += snprintf(buf + len, size - (size_t)len, ", Refused: %lu", refused);
+    }
+    return len;
+}
+
+void mem_pool_init(mem_pool_t *pool, mem_subsystem_t subsystem, size_t block_size, int blocks_per_chunk) {
+    memset(pool, 0, sizeof(*pool));
+    pool->subsystem = subsystem;
+    // Free blocks hold the free-list link
+    pool->block_size = ROUND_UP(block_size < sizeof(void *) ? sizeof(void *) : block_size);
+    pool->blocks_per_chunk = blocks_per_chunk > 0 ? blocks_per_chunk : 1;
+}
+
+static int pool_grow(mem_pool_t *pool) {
+    size_t bytes = ROUND_UP(sizeof(mem_chunk_t)) + pool->block_size * (size_t)pool->blocks_per_chunk;
+    if (mem_reserve(pool->subsystem, bytes) != 0) return -1;
+    mem_chunk_t *chunk = malloc(bytes);
+    if (!chunk) {
+        mem_release(pool->subsystem, bytes);
+        return -1;
+    }
+    chunk->next = pool->chunks;
+    chunk->bytes = bytes;
+    pool->chunks = chunk;
+    pool->chunk_count++;
+
+    char *block = (char *)chunk + ROUND_UP(sizeof(mem_chunk_t));
+    for (int i = 0; i < pool->blocks_per_chunk; i++, block += pool->block_size) {
+        *(void **)block = pool->free_list;
+        pool->free_list = block;
+    }
+    return 0;
+}
+
+void *mem_pool_alloc(mem_pool_t *pool) {
+    if (!pool->free_list && pool_grow(pool) != 0) return NULL;
+    void *block = pool->free_list;
+    pool->free_list = *(void **)block;
+    pool->in_use++;
+    return block;
+}
+
+void mem_pool_free(mem_pool_t *pool, void *block) {
+    if (!block) return;
+    *(void **)block = pool->free_list;
+    pool->free_list = block;
+    pool->in_use--;
+}
+
+int mem_pool_capacity(const mem_pool_t *pool) {
+    return pool->chunk_count * pool->blocks_per_chunk;
+}
+
+void mem_pool_destroy(mem_pool_t *pool) {
+    mem_chunk_t *chunk = pool->chunks;
+    while (chunk) {
+        mem_chunk_t *next = chunk->next;
+        mem_release(pool->subsystem, chunk->bytes);
+        free(chunk);
+        chunk = next;
+    }
+    pool->chunks = NULL;
+    pool->free_list = NULL;
+    pool->chunk_count = 0;
+    pool->in_use = 0;
+}
@@ -0,0 +1,59 @@
+#ifndef MEM_BUDGET_H
+#define MEM_BUDGET_H
+
+#include <stddef.h>
+
+// One byte budget for the daemon's long-lived memory. Each subsystem
+// charges what it holds; a reservation that would take the total past the
+// limit fails and the caller decides what to give up. Fixed-size objects
+// come from block pools that grow a chunk at a time and keep freed blocks
+// for reuse, so steady-state churn never goes back to malloc.
+
+#define MEM_DEFAULT_BUDGET_KB 32768     // half of a 64 MB board
+#define MEM_WORKER_STACK_SIZE (256 * 1024)
+
+typedef enum {
+    MEM_ROOMS = 0,          // room table and room thread stacks
+    MEM_CLIENTS,            // client table and handler thread stacks
+    MEM_HISTORY,            // per-room sample history
+    MEM_SNAPSHOT,           // checkpoint buffer while it is being built
+    MEM_SHARED,             // shared memory room table
+    MEM_SUBSYSTEMS
+} mem_subsystem_t;
+
+// Thread safe
+void mem_budget_set_limit(size_t bytes);        // 0: unlimited
+size_t mem_budget_limit(void);
+// Take `bytes` from the budget; -1 when it would go over the limit
+int mem_reserve(mem_subsystem_t subsystem, size_t bytes);
+// Account memory the daemon holds whatever the limit, e.g. static tables
+void mem_charge(mem_subsystem_t subsystem, size_t bytes);
+void mem_release(mem_subsystem_t subsystem, size_t bytes);
+size_t mem_used(mem_subsystem_t subsystem);
+size_t mem_total_used(void);
+unsigned long mem_refusals(void);
+const char *mem_subsystem_name(mem_subsystem_t subsystem);
+// "Used: N kB of M kB, rooms: ..." for the memory command
+int mem_budget_format(char *buf, size_t size);
+
+typedef struct mem_chunk mem_chunk_t;
+
+typedef struct {
+    mem_subsystem_t subsystem;
+    size_t block_size;
+    int blocks_per_chunk;
+    void *free_list;
+    mem_chunk_t *chunks;
+    int chunk_count;
+    int in_use;
+} mem_pool_t;
+
+// Pools are not locked; the owner serialises access
+void mem_pool_init(mem_pool_t *pool, mem_subsystem_t subsystem, size_t block_size, int blocks_per_chunk);
+// NULL when no block is free and the budget refuses another chunk
+void *mem_pool_alloc(mem_pool_t *pool);
+void mem_pool_free(mem_pool_t *pool, void *block);
+int mem_pool_capacity(const mem_pool_t *pool);
+void mem_pool_destroy(mem_pool_t *pool);
+
+#endif /* MEM_BUDGET_H */
@@ -0,0 +1,201 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdarg.h>
+#include <string.h>
+#include "metric_schema.h"
+
+// A schema entry whose member is missing fails to compile here, and one
+// whose declared type disagrees with the member gets a negative array size
+#define METRIC_TYPE_CHECK(field, type, tag, label, unit) \
+    typedef char metric_type_check_##field[ \
+        __builtin_types_compatible_p(__typeof__(((monitor_data_t *)0)->field), METRIC_CTYPE_##type) ? 1 : -1];
+MONITOR_METRICS(METRIC_TYPE_CHECK)
+#undef METRIC_TYPE_CHECK
+
+const metric_field_t monitor_metric_fields[MONITOR_METRIC_COUNT] = {
+#define METRIC_FIELD(field, type, tag, label, unit) \
+    { #field, tag, sizeof(tag) - 1, label, unit, METRIC_FIELD_##type, offsetof(monitor_data_t, field) },
+    MONITOR_METRICS(METRIC_FIELD)
+#undef METRIC_FIELD
+};
+
+// Output cursor for the snprintf-style formatters
+typedef struct {
+    char *buf;
+    size_t size;
+    size_t len;         // length of the full text, possibly > size
+} text_out_t;
+
+__attribute__((format(printf, 2, 3)))
+static void text_printf(text_out_t *out, const char *format, ...) {
+    size_t used = out->len < out->size ? out->len : out->size;
+    va_list args;
+    va_start(args, format);
+    int n = vsnprintf(out->buf ? out->buf + used : NULL, out->size - used, format, args);
+    va_end(args);
+    if (n > 0) out->len += (size_t)n;
+}
+
+static void text_value(text_out_t *out, const metric_field_t *f, const monitor_data_t *data) {
+    const char *p = (const char *)data + f->offset;
+    switch (f->type) {
+    case METRIC_FIELD_FLOAT:
+        text_printf(out, "%.2f", *(const float *)p);
+        break;
+    case METRIC_FIELD_ULONG:
+        text_printf(out, "%lu", *(const unsigned long *)p);
+        break;
+    case METRIC_FIELD_INT:
+        text_printf(out, "%d", *(const int *)p);
+        break;
+    }
+}
+
+int monitor_data_format_fifo(const monitor_data_t *data, char *buf, size_t size) {
+    text_out_t out = { buf, size, 0 };
+    text_printf(&out, MONITOR_FIFO_PREFIX "%s", data->room_name);
+    for (int i = 0; i < MONITOR_METRIC_COUNT; i++) {
+        const metric_field_t *f = &monitor_metric_fields[i];
+        text_printf(&out, "|%s:", f->tag);
+        text_value(&out, f, data);
+    }
+    return (int)out.len;
+}
+
+static const metric_field_t *field_by_tag(const char *tag, size_t len) {
+    for (int i = 0; i < MONITOR_METRIC_COUNT; i++) {
+        const metric_field_t *f = &monitor_metric_fields[i];
+        if (f->tag_len == len && memcmp(f->tag, tag, len) == 0) return f;
+    }
+    return NULL;
+}
+
+// Parse one value at `s` into its member; returns the end of the number,
+// or `s` if there was none
+static const char *store_value(const metric_field_t *f, const char *s, monitor_data_t *data) {
+    char *p = (char *)data + f->offset;
+    char *end;
+    switch (f->type) {
+    case METRIC_FIELD_FLOAT: {
+        float v = strtof(s, &end);
+        if (end != s) *(float *)p = v;
+        break;
+    }
+    case METRIC_FIELD_ULONG: {
+        unsigned long v = strtoul(s, &end, 10);
+        if (end != s) *(unsigned long *)p = v;
+        break;
+    }
+    case METRIC_FIELD_INT: {
+        long v = strtol(s, &end, 10);
+        if (end != s) *(int *)p = (int)v;
+        break;
+    }
+    default:
+        end = (char *)s;
+        break;
+    }
+    return end;
+}
+
+int monitor_data_parse_fifo(const char *line, monitor_data_t *data) {
+    const size_t prefix = sizeof(MONITOR_FIFO_PREFIX) - 1;
+    if (strncmp(line, MONITOR_FIFO_PREFIX, prefix) != 0) return -1;
+
+    const char *p = line + prefix;
+    size_t name_len = strcspn(p, "|\n");
+    if (name_len > 0) {
+        if (name_len >= sizeof(data->room_name)) name_len = sizeof(data->room_name) - 1;
+        memcpy(data->room_name, p, name_len);
+        data->room_name[name_len] = '\0';
+    }
+    p += strcspn(p, "|\n");
+
+    int found = 0;
+    while (*p == '|') {
+        const char *tag = ++p;
+        p += strcspn(p, ":|\n");
+        if (*p != ':') continue;
+        const metric_field_t *f = field_by_tag(tag, (size_t)(p - tag));
+        p++;
+        if (f) {
+            const char *end = store_value(f, p, data);
+            if (end != p) found++;
+            p = end;
+        }
+        p += strcspn(p, "|\n");
+    }
+    return found;
+}
+
+int monitor_data_format_text(const monitor_data_t *data, char *buf, size_t size) {
+    text_out_t out = { buf, size, 0 };
+    for (int i = 0; i < MONITOR_METRIC_COUNT; i++) {
+        const metric_field_t *f = &monitor_metric_fields[i];
+        text_printf(&out, "%s%s: ", i ? ", " : "", f->label);
+        text_value(&out, f, data);
+        text_printf(&out, "%s", f->unit);
+    }
+    return (int)out.len;
+}
+
+int monitor_data_format_log(const monitor_data_t *data, char *buf, size_t size) {
+    text_out_t out = { buf, size, 0 };
+    for (int i = 0; i < MONITOR_METRIC_COUNT; i++) {
+        const metric_field_t *f = &monitor_metric_fields[i];
+        text_printf(&out, "%s%s=", i ? " " : "", f->name);
+        text_value(&out, f, data);
+    }
+    return (int)out.len;
+}
+
+static void text_json_string(text_out_t *out, const char *s) {
+    text_printf(out, "\"");
+    for (; *s; s++) {
+        unsigned char c = (unsigned char)*s;
+        if (c == '"' || c == '\\') {
+            text_printf(out, "\\%c", c);
+        } else if (c < 0x20) {
+            text_printf(out, "\\u%04x", c);
+        } else {
+            text_printf(out, "%c", c);
+        }
+    }
+    text_printf(out, "\"");
+}
+
+int monitor_data_format_json(const monitor_data_t *data, char *buf, size_t size) {
+    text_out_t out = { buf, size, 0 };
+    text_printf(&out, "{\"room\":");
+    text_json_string(&out, data->room_name);
+    text_printf(&out, ",\"timestamp\":%lld", (long long)data->timestamp);
+    for (int i = 0; i < MONITOR_METRIC_COUNT; i++) {
+        const metric_field_t *f = &monitor_metric_fields[i];
+        text_printf(&out, ",\"%s\":", f->name);
+        text_value(&out, f, data);
+    }
+    text_printf(&out, "}");
+    return (int)out.len;
+}
+
+static uint32_t fnv1a32(uint32_t hash, const void *data, size_t len) {
+    const unsigned char *p = data;
+    for (size_t i = 0; i < len; i++) {
+        hash ^= p[i];
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+uint32_t monitor_schema_id(void) {
+    uint32_t hash = 2166136261u;
+    uint32_t size = (uint32_t)sizeof(monitor_data_t);
+    hash = fnv1a32(hash, &size, sizeof(size));
+    for (int i = 0; i < MONITOR_METRIC_COUNT; i++) {
+        const metric_field_t *f = &monitor_metric_fields[i];
+        uint32_t layout[2] = { (uint32_t)f->type, (uint32_t)f->offset };
+        hash = fnv1a32(hash, f->name, strlen(f->name) + 1);
+        hash = fnv1a32(hash, layout, sizeof(layout));
+    }
+    return hash;
+}
@@ -0,0 +1,76 @@
+#ifndef METRIC_SCHEMA_H
+#define METRIC_SCHEMA_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "../commom/data_structures.h"
+
+// Every per-sample metric of monitor_data_t, in wire order. The FIFO
+// parser and writer, `show` text, log lines, JSON and the snapshot schema
+// id are all generated from this list, so a new metric is one line here
+// plus the member in monitor_data_t.
+//
+//   X(field, type, tag, label, unit)
+//     field  member of monitor_data_t; its C type is checked at compile time
+//     type   FLOAT, ULONG or INT
+//     tag    FIFO key, as in "DATA:room|CPU:45.2|MEM:67.8|FREE:2048|PROC:123"
+//     label  `show` label, as in "CPU: 45.20%"
+//     unit   printed after the value in `show` text
+#define MONITOR_METRICS(X) \
+    X(cpu_usage,     FLOAT, "CPU",  "CPU",         "%")   \
+    X(memory_usage,  FLOAT, "MEM",  "Memory",      "%")   \
+    X(memory_free,   ULONG, "FREE", "Free memory", " kB") \
+    X(process_count, INT,   "PROC", "Processes",   "")
+
+#define METRIC_CTYPE_FLOAT float
+#define METRIC_CTYPE_ULONG unsigned long
+#define METRIC_CTYPE_INT int
+
+#define MONITOR_FIFO_PREFIX "DATA:"
+
+typedef enum {
+    METRIC_FIELD_FLOAT,
+    METRIC_FIELD_ULONG,
+    METRIC_FIELD_INT
+} metric_field_type_t;
+
+typedef enum {
+#define METRIC_ENUM(field, type, tag, label, unit) MONITOR_METRIC_##field,
+    MONITOR_METRICS(METRIC_ENUM)
+#undef METRIC_ENUM
+    MONITOR_METRIC_COUNT
+} monitor_metric_t;
+
+typedef struct {
+    const char *name;           // JSON and log key: the member name
+    const char *tag;
+    size_t tag_len;
+    const char *label;
+    const char *unit;
+    metric_field_type_t type;
+    size_t offset;              // into monitor_data_t
+} metric_field_t;
+
+extern const metric_field_t monitor_metric_fields[MONITOR_METRIC_COUNT];
+
+// The formatters are snprintf-style: they return the length the full text
+// needs, so a return >= size means it was truncated.
+
+// "DATA:room|CPU:45.20|MEM:67.80|FREE:2048|PROC:123"
+int monitor_data_format_fifo(const monitor_data_t *data, char *buf, size_t size);
+// Fill `data` from a FIFO line; fields the line lacks are left untouched
+// and unknown tags are skipped. Returns the number of metrics read, or -1
+// if the line does not start with MONITOR_FIFO_PREFIX.
+int monitor_data_parse_fifo(const char *line, monitor_data_t *data);
+// "CPU: 45.20%, Memory: 67.80%, Free memory: 2048 kB, Processes: 123"
+int monitor_data_format_text(const monitor_data_t *data, char *buf, size_t size);
+// "cpu_usage=45.20 memory_usage=67.80 memory_free=2048 process_count=123"
+int monitor_data_format_log(const monitor_data_t *data, char *buf, size_t size);
+// {"room":"web","timestamp":1700000000,"cpu_usage":45.20,...}
+int monitor_data_format_json(const monitor_data_t *data, char *buf, size_t size);
+
+// Fingerprint of the field names, types and offsets. Stored with raw
+// monitor_data_t copies so a reordered or retyped schema is not misread.
+uint32_t monitor_schema_id(void);
+
+#endif /* METRIC_SCHEMA_H */
@@ -0,0 +1,59 @@
+#include <string.h>
+#include <sys/time.h>
+#include <sys/resource.h>
+#include "overhead_governor.h"
+
+static const char *level_names[GOVERNOR_LEVELS] = { "normal", "quiet", "slow", "coalesce" };
+
+void governor_init(governor_t *gov, double budget_percent) {
+    memset(gov, 0, sizeof(*gov));
+    gov->budget_percent = budget_percent;
+}
+
+governor_level_t governor_update(governor_t *gov, uint64_t cpu_us, uint64_t wall_us) {
+    if (!gov->has_last || wall_us <= gov->last_wall_us || cpu_us < gov->last_cpu_us) {
+        gov->last_cpu_us = cpu_us;
+        gov->last_wall_us = wall_us;
+        gov->has_last = 1;
+        return gov->level;
+    }
+    double percent = 100.0 * (double)(cpu_us - gov->last_cpu_us) / (double)(wall_us - gov->last_wall_us);
+    gov->last_cpu_us = cpu_us;
+    gov->last_wall_us = wall_us;
+    // Half-weight smoothing, so one busy tick fades instead of pinning a level
+    gov->cpu_percent = gov->ticks++ ? (gov->cpu_percent + percent) / 2 : percent;
+
+    if (gov->budget_percent <= 0) {
+        gov->level = GOVERNOR_NORMAL;
+        gov->calm_ticks = 0;
+        return gov->level;
+    }
+    if (gov->cpu_percent > gov->budget_percent) {
+        gov->calm_ticks = 0;
+        if (gov->level < GOVERNOR_LEVELS - 1) {
+            gov->level++;
+            gov->escalations++;
+        }
+    } else if (gov->cpu_percent < gov->budget_percent * GOVERNOR_RECOVER_FRACTION) {
+        if (gov->level > GOVERNOR_NORMAL && ++gov->calm_ticks >= GOVERNOR_RECOVER_TICKS) {
+            gov->level--;
+            gov->recoveries++;
+            gov->calm_ticks = 0;
+        }
+    } else {
+        gov->calm_ticks = 0;
+    }
+    return gov->level;
+}
+
+const char *governor_level_name(governor_level_t level) {
+    return (unsigned)level < GOVERNOR_LEVELS ? level_names[level] : "unknown";
+}
+
+int governor_self_cpu_us(uint64_t *cpu_us) {
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0) return -1;
+    *cpu_us = (uint64_t)usage.ru_utime.tv_sec * 1000000ULL + (uint64_t)usage.ru_utime.tv_usec +
+              (uint64_t)usage.ru_stime.tv_sec * 1000000ULL + (uint64_t)usage.ru_stime.tv_usec;
+    return 0;
+}
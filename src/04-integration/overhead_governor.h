@@ -0,0 +1,45 @@
+#ifndef OVERHEAD_GOVERNOR_H
+#define OVERHEAD_GOVERNOR_H
+
+#include <stdint.h>
+
+// Keeps the daemon's own CPU use under a budget. Each tick feeds the
+// process CPU time; while the smoothed use is over budget the governor
+// steps one level further per tick, and it steps back one level after
+// GOVERNOR_RECOVER_TICKS ticks below GOVERNOR_RECOVER_FRACTION of it.
+
+#define GOVERNOR_DEFAULT_BUDGET_PERCENT 2.0     // of one core
+#define GOVERNOR_RECOVER_FRACTION 0.5
+#define GOVERNOR_RECOVER_TICKS 5
+#define GOVERNOR_COALESCE_FACTOR 4              // samples per shm publish, checkpoint stretch
+
+typedef enum {
+    GOVERNOR_NORMAL = 0,
+    GOVERNOR_QUIET,         // DEBUG and TRACE logging dropped
+    GOVERNOR_SLOW,          // adaptive rooms held at their interval cap
+    GOVERNOR_COALESCE,      // shm publishes and checkpoints coalesced
+    GOVERNOR_LEVELS
+} governor_level_t;
+
+typedef struct {
+    double budget_percent;          // <= 0 disables the governor
+    governor_level_t level;
+    double cpu_percent;             // smoothed, of one core
+    uint64_t last_cpu_us;
+    uint64_t last_wall_us;
+    int has_last;
+    unsigned long ticks;            // measured intervals
+    int calm_ticks;
+    unsigned long escalations;
+    unsigned long recoveries;
+} governor_t;
+
+void governor_init(governor_t *gov, double budget_percent);
+// Feed cumulative process CPU time and a monotonic clock, both in
+// microseconds. Returns the level to run at.
+governor_level_t governor_update(governor_t *gov, uint64_t cpu_us, uint64_t wall_us);
+const char *governor_level_name(governor_level_t level);
+// User plus system time of every thread in the process
+int governor_self_cpu_us(uint64_t *cpu_us);
+
+#endif /* OVERHEAD_GOVERNOR_H */
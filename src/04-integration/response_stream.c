@@ -0,0 +1,83 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdarg.h>
+#include <errno.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include "response_stream.h"
+
+void response_stream_init(response_stream_t *stream, int fd) {
+    stream->fd = fd;
+    stream->len = 0;
+    stream->sent = 0;
+    stream->failed = 0;
+}
+
+// Non-blocking sends, waiting in poll() while the socket buffer is full
+static int send_bytes(response_stream_t *stream, const char *data, size_t len) {
+    while (len > 0 && !stream->failed) {
+        ssize_t n = send(stream->fd, data, len, MSG_NOSIGNAL | MSG_DONTWAIT);
+        if (n > 0) {
+            data += n;
+            len -= (size_t)n;
+            stream->sent += (size_t)n;
+            continue;
+        }
+        if (n < 0 && errno == EINTR) continue;
+        if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+            struct pollfd pfd = { .fd = stream->fd, .events = POLLOUT };
+            int rc = poll(&pfd, 1, RESPONSE_STREAM_STALL_MS);
+            if (rc > 0 || (rc < 0 && errno == EINTR)) continue;
+        }
+        stream->failed = 1;
+    }
+    return stream->failed ? -1 : 0;
+}
+
+int response_stream_flush(response_stream_t *stream) {
+    if (stream->failed) return -1;
+    int rc = send_bytes(stream, stream->buf, stream->len);
+    stream->len = 0;
+    return rc;
+}
+
+static int stream_vappend(response_stream_t *stream, const char *fmt, va_list args) {
+    size_t room = sizeof(stream->buf) - stream->len;
+    int n = vsnprintf(stream->buf + stream->len, room, fmt, args);
+    if (n < 0 || (size_t)n >= sizeof(stream->buf)) return -1;
+    if ((size_t)n >= room) return 1;
+    stream->len += (size_t)n;
+    return 0;
+}
+
+int response_stream_append(response_stream_t *stream, const char *fmt, ...) {
+    va_list args;
+    va_start(args, fmt);
+    int rc = stream_vappend(stream, fmt, args);
+    va_end(args);
+    return rc;
+}
+
+int response_stream_printf(response_stream_t *stream, const char *fmt, ...) {
+    if (stream->failed) return -1;
+    va_list args, retry;
+    va_start(args, fmt);
+    va_copy(retry, args);
+    int rc = stream_vappend(stream, fmt, args);
+    if (rc == 1 && response_stream_flush(stream) == 0) {
+        rc = stream_vappend(stream, fmt, retry);
+    } else if (rc == -1) {
+        // Too big for any chunk: send what is buffered, then the entry itself
+        int n = vsnprintf(NULL, 0, fmt, retry);
+        char *big = n >= 0 ? malloc((size_t)n + 1) : NULL;
+        va_end(retry);
+        va_start(retry, fmt);
+        if (big && vsnprintf(big, (size_t)n + 1, fmt, retry) == n && response_stream_flush(stream) == 0) {
+            rc = send_bytes(stream, big, (size_t)n);
+        }
+        free(big);
+    }
+    va_end(retry);
+    va_end(args);
+    return stream->failed ? -1 : rc;
+}
@@ -0,0 +1,36 @@
+#ifndef RESPONSE_STREAM_H
+#define RESPONSE_STREAM_H
+
+#include <stddef.h>
+
+// Replies of any length written a chunk at a time into a socket. Entries
+// are formatted into a fixed chunk and the chunk is sent when the next one
+// does not fit, so a listing costs one pass and one chunk of memory however
+// many entries it has. Sends wait for the peer to drain its receive buffer,
+// giving up after RESPONSE_STREAM_STALL_MS without progress.
+
+#define RESPONSE_STREAM_CHUNK 4096
+#define RESPONSE_STREAM_STALL_MS 5000
+
+typedef struct {
+    int fd;
+    size_t len;                 // bytes waiting in buf
+    size_t sent;                // bytes already in the socket
+    int failed;
+    char buf[RESPONSE_STREAM_CHUNK];
+} response_stream_t;
+
+void response_stream_init(response_stream_t *stream, int fd);
+// Format into the chunk without touching the socket: 0 when appended, 1 when
+// the chunk is too full (nothing written), -1 when the entry can never fit.
+// Safe to call with locks held.
+int response_stream_append(response_stream_t *stream, const char *fmt, ...)
+    __attribute__((format(printf, 2, 3)));
+// Append, flushing first when the chunk is full. Entries larger than a
+// chunk are sent on their own.
+int response_stream_printf(response_stream_t *stream, const char *fmt, ...)
+    __attribute__((format(printf, 2, 3)));
+// Send what is buffered; -1 once the peer is gone or stalled
+int response_stream_flush(response_stream_t *stream);
+
+#endif /* RESPONSE_STREAM_H */
@@ -0,0 +1,171 @@
+#include <stdlib.h>
+#include <string.h>
+#include "room_history.h"
+#include "mem_budget.h"
+#include "logger.h"
+
+// Segments per pool chunk: one room's full history
+#define SEGMENTS_PER_CHUNK (ROOM_HISTORY_DEPTH / ROOM_HISTORY_SEGMENT + 1)
+
+typedef struct history_segment {
+    struct history_segment *next;       // towards newer samples
+    unsigned long seq;                  // allocation order, lower is older
+    int count;
+    monitor_data_t samples[ROOM_HISTORY_SEGMENT];
+} history_segment_t;
+
+// Segment list per slot; `first` is the oldest live sample in `oldest`
+typedef struct {
+    history_segment_t *oldest;
+    history_segment_t *newest;
+    int first;
+    int count;
+} room_history_t;
+
+static room_history_t *histories = NULL;
+static int history_capacity = 0;
+static mem_pool_t segment_pool;
+static unsigned long next_seq = 0;
+static unsigned long evictions = 0;
+static unsigned long dropped = 0;
+
+int room_history_init(int capacity) {
+    if (capacity <= 0) return -1;
+    histories = calloc((size_t)capacity, sizeof(room_history_t));
+    if (!histories) {
+        log_error("Failed to allocate history for %d rooms", capacity);
+        return -1;
+    }
+    mem_charge(MEM_HISTORY, sizeof(room_history_t) * (size_t)capacity);
+    mem_pool_init(&segment_pool, MEM_HISTORY, sizeof(history_segment_t), SEGMENTS_PER_CHUNK);
+    history_capacity = capacity;
+    return 0;
+}
+
+static room_history_t *history_at(int slot) {
+    if (!histories || slot < 0 || slot >= history_capacity) return NULL;
+    return &histories[slot];
+}
+
+// Unlink a room's oldest segment, dropping the samples still in it
+static history_segment_t *take_oldest(room_history_t *h) {
+    history_segment_t *seg = h->oldest;
+    h->oldest = seg->next;
+    if (!h->oldest) h->newest = NULL;
+    h->count -= seg->count - h->first;
+    h->first = 0;
+    return seg;
+}
+
+// The oldest segment that may be evicted for `requester`: any of its own,
+// or one that is not another room's only segment
+static room_history_t *eviction_victim(const room_history_t *requester) {
+    room_history_t *victim = NULL;
+    for (int i = 0; i < history_capacity; i++) {
+        room_history_t *h = &histories[i];
+        if (!h->oldest || (h != requester && h->oldest == h->newest)) continue;
+        if (!victim || h->oldest->seq < victim->oldest->seq) victim = h;
+    }
+    return victim;
+}
+
+static history_segment_t *acquire_segment(room_history_t *h) {
+    history_segment_t *seg = mem_pool_alloc(&segment_pool);
+    if (!seg) {
+        room_history_t *victim = eviction_victim(h);
+        if (!victim) return NULL;
+        seg = take_oldest(victim);
+        evictions++;
+    }
+    seg->next = NULL;
+    seg->seq = next_seq++;
+    seg->count = 0;
+    return seg;
+}
+
+void room_history_push(int slot, const monitor_data_t *data) {
+    room_history_t *h = history_at(slot);
+    if (!h || !data) return;
+
+    if (!h->newest || h->newest->count == ROOM_HISTORY_SEGMENT) {
+        history_segment_t *seg = acquire_segment(h);
+        if (!seg) {
+            dropped++;
+            return;
+        }
+        if (h->newest) h->newest->next = seg;
+        else h->oldest = seg;
+        h->newest = seg;
+    }
+    h->newest->samples[h->newest->count++] = *data;
+    h->count++;
+
+    if (h->count > ROOM_HISTORY_DEPTH) {
+        h->first++;
+        h->count--;
+        if (h->first == h->oldest->count) mem_pool_free(&segment_pool, take_oldest(h));
+    }
+}
+
+void room_history_clear(int slot) {
+    room_history_t *h = history_at(slot);
+    if (!h) return;
+    while (h->oldest) mem_pool_free(&segment_pool, take_oldest(h));
+}
+
+int room_history_count(int slot) {
+    room_history_t *h = history_at(slot);
+    return h ? h->count : 0;
+}
+
+// Copy up to max_samples of the newest samples, oldest first
+int room_history_copy(int slot, monitor_data_t *out, int max_samples) {
+    room_history_t *h = history_at(slot);
+    if (!h || !out || max_samples <= 0) return 0;
+
+    int n = h->count < max_samples ? h->count : max_samples;
+    int skip = h->count - n;
+    int copied = 0;
+    int start = h->first;
+    for (history_segment_t *seg = h->oldest; seg && copied < n; seg = seg->next, start = 0) {
+        int avail = seg->count - start;
+        if (skip >= avail) {
+            skip -= avail;
+            continue;
+        }
+        start += skip;
+        avail -= skip;
+        skip = 0;
+        memcpy(out + copied, seg->samples + start, sizeof(monitor_data_t) * (size_t)avail);
+        copied += avail;
+    }
+    return copied;
+}
+
+// Replace a slot's history with samples ordered oldest first
+void room_history_restore(int slot, const monitor_data_t *samples, int count) {
+    if (!history_at(slot) || !samples) return;
+
+    room_history_clear(slot);
+    if (count > ROOM_HISTORY_DEPTH) {
+        samples += count - ROOM_HISTORY_DEPTH;
+        count = ROOM_HISTORY_DEPTH;
+    }
+    for (int i = 0; i < count; i++) room_history_push(slot, &samples[i]);
+}
+
+void room_history_stats(room_history_stats_t *stats) {
+    stats->segments = segment_pool.in_use;
+    stats->capacity = mem_pool_capacity(&segment_pool);
+    stats->evictions = evictions;
+    stats->dropped = dropped;
+}
+
+void room_history_cleanup(void) {
+    if (!histories) return;
+    mem_pool_destroy(&segment_pool);
+    mem_release(MEM_HISTORY, sizeof(room_history_t) * (size_t)history_capacity);
+    free(histories);
+    histories = NULL;
+    history_capacity = 0;
+}
@@ -0,0 +1,31 @@
+#ifndef ROOM_HISTORY_H
+#define ROOM_HISTORY_H
+
+#include "../commom/data_structures.h"
+
+// Recent samples kept per room slot
+#define ROOM_HISTORY_DEPTH 60
+// Samples per pooled segment; a room holds at most
+// ROOM_HISTORY_DEPTH / ROOM_HISTORY_SEGMENT + 1 segments
+#define ROOM_HISTORY_SEGMENT 15
+
+typedef struct {
+    int segments;               // in use across all rooms
+    int capacity;               // allocated in the pool
+    unsigned long evictions;    // segments taken from the oldest history
+    unsigned long dropped;      // samples not kept for lack of memory
+} room_history_stats_t;
+
+// All functions expect the caller to hold rooms_mutex. Segments come from
+// the MEM_HISTORY budget; when it is spent, a new segment is taken from the
+// oldest history of any room, never from another room's newest segment.
+int room_history_init(int capacity);
+void room_history_push(int slot, const monitor_data_t *data);
+void room_history_clear(int slot);
+int room_history_count(int slot);
+int room_history_copy(int slot, monitor_data_t *out, int max_samples);
+void room_history_restore(int slot, const monitor_data_t *samples, int count);
+void room_history_stats(room_history_stats_t *stats);
+void room_history_cleanup(void);
+
+#endif /* ROOM_HISTORY_H */
@@ -0,0 +1,52 @@
+#include <string.h>
+#include <time.h>
+#include "room_record.h"
+#include "main_daemon.h"
+#include "shm_snapshot.h"
+#include "adaptive_interval.h"
+#include "logger.h"
+
+// Caller must hold rooms_mutex
+void room_record_capture(const room_info_t *room, room_record_t *record) {
+    memset(record, 0, sizeof(*record));
+    memcpy(record->name, room->name, sizeof(record->name));
+    record->name[sizeof(record->name) - 1] = '\0';
+    record->state = (int32_t)room->state;
+    record->collection_interval = room->collection_interval;
+    record->error_count = room->error_count;
+    record->max_interval = adaptive_max_ms((int)(room - g_daemon_state.rooms)) / 1000;
+    record->created_time = (int64_t)room->created_time;
+    record->last_update = (int64_t)room->last_update;
+    record->latest_data = room->latest_data;
+}
+
+// Recreate a room from its record and restart collection if it was running.
+// Returns the room slot, or -1 if the room could not be recreated.
+int room_record_restore(const room_record_t *record) {
+    char name[MAX_ROOM_NAME];
+    strncpy(name, record->name, sizeof(name) - 1);
+    name[sizeof(name) - 1] = '\0';
+
+    if (create_room(name, record->collection_interval, record->max_interval) != 0) {
+        log_warn("Cannot restore room %s", name);
+        return -1;
+    }
+
+    int slot = -1;
+    pthread_mutex_lock(&g_daemon_state.rooms_mutex);
+    room_info_t *room = find_room(name);
+    if (room) {
+        slot = (int)(room - g_daemon_state.rooms);
+        room->created_time = (time_t)record->created_time;
+        room->last_update = (time_t)record->last_update;
+        room->latest_data = record->latest_data;
+        room->error_count = record->error_count;
+        shm_snapshot_publish_room(slot, room);
+    }
+    pthread_mutex_unlock(&g_daemon_state.rooms_mutex);
+
+    if (record->state == ROOM_STATE_RUNNING && start_room(name) != 0) {
+        log_warn("Restored room %s but could not restart it", name);
+    }
+    return slot;
+}
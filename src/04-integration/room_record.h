@@ -0,0 +1,23 @@
+#ifndef ROOM_RECORD_H
+#define ROOM_RECORD_H
+
+#include <stdint.h>
+#include "../commom/data_structures.h"
+
+// Fixed-size, pointer-free copy of a room used when room definitions leave
+// the process (upgrade handoff, state snapshots)
+typedef struct {
+    char name[MAX_ROOM_NAME];
+    int32_t state;
+    int32_t collection_interval;
+    int32_t error_count;
+    int32_t max_interval;       // adaptive cap in seconds, 0 for a fixed interval
+    int64_t created_time;
+    int64_t last_update;
+    monitor_data_t latest_data;
+} room_record_t;
+
+void room_record_capture(const room_info_t *room, room_record_t *record);
+int room_record_restore(const room_record_t *record);
+
+#endif /* ROOM_RECORD_H */
@@ -0,0 +1,157 @@
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "shm_reader.h"
+
+#define READ_RETRIES 64
+
+struct monitor_shm {
+    char name[64];
+    const shm_snapshot_header_t *hdr;
+    size_t size;
+    int last_slot;   // Hint for repeated lookups of the same room
+};
+
+static int map_segment(monitor_shm_t *shm) {
+    int fd = shm_open(shm->name, O_RDONLY, 0);
+    if (fd < 0) {
+        return -1;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size < (off_t)sizeof(shm_snapshot_header_t)) {
+        close(fd);
+        return -1;
+    }
+
+    void *addr = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (addr == MAP_FAILED) {
+        return -1;
+    }
+
+    const shm_snapshot_header_t *hdr = addr;
+    if (__atomic_load_n(&hdr->magic, __ATOMIC_ACQUIRE) != SHM_SNAPSHOT_MAGIC ||
+        hdr->version != SHM_SNAPSHOT_VERSION ||
+        hdr->header_size != sizeof(shm_snapshot_header_t) ||
+        hdr->entry_size != sizeof(shm_snapshot_entry_t) ||
+        SHM_SNAPSHOT_SIZE(hdr->capacity) > (size_t)st.st_size) {
+        munmap(addr, (size_t)st.st_size);
+        return -1;
+    }
+
+    shm->hdr = hdr;
+    shm->size = (size_t)st.st_size;
+    shm->last_slot = 0;
+    return 0;
+}
+
+static void unmap_segment(monitor_shm_t *shm) {
+    if (shm->hdr) {
+        munmap((void *)shm->hdr, shm->size);
+        shm->hdr = NULL;
+        shm->size = 0;
+    }
+}
+
+// Attach to the segment (NULL selects the daemon default name)
+monitor_shm_t *monitor_shm_open(const char *shm_name) {
+    monitor_shm_t *shm = calloc(1, sizeof(*shm));
+    if (!shm) return NULL;
+
+    strncpy(shm->name, shm_name ? shm_name : SHM_SNAPSHOT_NAME, sizeof(shm->name) - 1);
+    if (map_segment(shm) != 0) {
+        free(shm);
+        return NULL;
+    }
+    return shm;
+}
+
+// Re-attach after MONITOR_SHM_STALE
+int monitor_shm_reopen(monitor_shm_t *shm) {
+    if (!shm) return -1;
+    unmap_segment(shm);
+    return map_segment(shm);
+}
+
+void monitor_shm_close(monitor_shm_t *shm) {
+    if (!shm) return;
+    unmap_segment(shm);
+    free(shm);
+}
+
+int monitor_shm_capacity(const monitor_shm_t *shm) {
+    return (shm && shm->hdr) ? (int)shm->hdr->capacity : 0;
+}
+
+uint64_t monitor_shm_generation(const monitor_shm_t *shm) {
+    return (shm && shm->hdr) ? __atomic_load_n(&shm->hdr->generation, __ATOMIC_ACQUIRE) : 0;
+}
+
+static const shm_snapshot_entry_t *entry_at(const monitor_shm_t *shm, int slot) {
+    const char *base = (const char *)shm->hdr + shm->hdr->header_size;
+    return (const shm_snapshot_entry_t *)(base + (size_t)slot * sizeof(shm_snapshot_entry_t));
+}
+
+// Copy one entry under its seqlock
+static int read_entry(const monitor_shm_t *shm, int slot, monitor_shm_room_t *room) {
+    const shm_snapshot_entry_t *entry = entry_at(shm, slot);
+
+    for (int attempt = 0; attempt < READ_RETRIES; attempt++) {
+        uint32_t seq = __atomic_load_n(&entry->seq, __ATOMIC_ACQUIRE);
+        if (seq & 1) {
+            continue;
+        }
+
+        room->slot = slot;
+        room->state = (room_state_t)entry->state;
+        room->collection_interval = entry->collection_interval;
+        room->error_count = entry->error_count;
+        room->last_update = (time_t)entry->last_update;
+        memcpy(room->name, entry->name, sizeof(room->name));
+        room->data = entry->data;
+
+        __atomic_thread_fence(__ATOMIC_ACQUIRE);
+        if (__atomic_load_n(&entry->seq, __ATOMIC_RELAXED) != seq) {
+            continue;
+        }
+
+        room->name[sizeof(room->name) - 1] = '\0';
+        return room->state == ROOM_STATE_INACTIVE ? MONITOR_SHM_NOT_FOUND : MONITOR_SHM_OK;
+    }
+    return MONITOR_SHM_BUSY;
+}
+
+static int segment_live(const monitor_shm_t *shm) {
+    return shm && shm->hdr &&
+           __atomic_load_n(&shm->hdr->magic, __ATOMIC_ACQUIRE) == SHM_SNAPSHOT_MAGIC;
+}
+
+int monitor_shm_read_slot(const monitor_shm_t *shm, int slot, monitor_shm_room_t *room) {
+    if (!segment_live(shm)) return MONITOR_SHM_STALE;
+    if (!room || slot < 0 || slot >= (int)shm->hdr->capacity) return MONITOR_SHM_NOT_FOUND;
+    return read_entry(shm, slot, room);
+}
+
+// Look up a room by name, starting from the slot that matched last time
+int monitor_shm_find(monitor_shm_t *shm, const char *room_name, monitor_shm_room_t *room) {
+    if (!segment_live(shm)) return MONITOR_SHM_STALE;
+    if (!room_name || !room) return MONITOR_SHM_NOT_FOUND;
+
+    int capacity = (int)shm->hdr->capacity;
+    for (int n = 0; n < capacity; n++) {
+        int slot = (shm->last_slot + n) % capacity;
+        int rc = read_entry(shm, slot, room);
+        if (rc == MONITOR_SHM_OK && strncmp(room->name, room_name, MAX_ROOM_NAME) == 0) {
+            shm->last_slot = slot;
+            return rc;
+        }
+        if (rc == MONITOR_SHM_BUSY) {
+            return rc;
+        }
+    }
+    return MONITOR_SHM_NOT_FOUND;
+}
@@ -0,0 +1,38 @@
+#ifndef SHM_READER_H
+#define SHM_READER_H
+
+#include <stdint.h>
+#include "shm_snapshot.h"
+
+// Read-only client library for the daemon's shared-memory room table.
+// Lookups never enter the kernel: they copy one entry under its seqlock.
+
+// Return codes
+#define MONITOR_SHM_OK 0
+#define MONITOR_SHM_NOT_FOUND -1
+#define MONITOR_SHM_STALE -2      // Daemon retired the segment; call monitor_shm_reopen()
+#define MONITOR_SHM_BUSY -3       // Writer kept the entry busy for every retry
+
+// Consistent copy of one room slot
+typedef struct {
+    int slot;
+    room_state_t state;
+    int collection_interval;
+    int error_count;
+    time_t last_update;
+    char name[MAX_ROOM_NAME];
+    monitor_data_t data;
+} monitor_shm_room_t;
+
+typedef struct monitor_shm monitor_shm_t;
+
+monitor_shm_t *monitor_shm_open(const char *shm_name);
+int monitor_shm_reopen(monitor_shm_t *shm);
+void monitor_shm_close(monitor_shm_t *shm);
+
+int monitor_shm_capacity(const monitor_shm_t *shm);
+uint64_t monitor_shm_generation(const monitor_shm_t *shm);
+int monitor_shm_read_slot(const monitor_shm_t *shm, int slot, monitor_shm_room_t *room);
+int monitor_shm_find(monitor_shm_t *shm, const char *room_name, monitor_shm_room_t *room);
+
+#endif /* SHM_READER_H */
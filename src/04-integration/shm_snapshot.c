@@ -0,0 +1,177 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <errno.h>
+#include <time.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "shm_snapshot.h"
+#include "logger.h"
+
+typedef struct {
+    char name[64];
+    shm_snapshot_header_t *hdr;
+    size_t size;
+    int capacity;
+} shm_snapshot_context_t;
+
+static shm_snapshot_context_t shm_ctx = {"", NULL, 0, 0};
+
+// Mark a segment as abandoned so attached readers know to reopen it
+static void retire_segment(shm_snapshot_header_t *hdr) {
+    __atomic_store_n(&hdr->magic, 0, __ATOMIC_RELEASE);
+}
+
+// Map the segment (NULL name selects SHM_SNAPSHOT_NAME), reusing an existing
+// one of the same shape so attached readers keep working across restarts
+int shm_snapshot_init(const char *name, int capacity) {
+    if (capacity <= 0) {
+        return -1;
+    }
+    strncpy(shm_ctx.name, name ? name : SHM_SNAPSHOT_NAME, sizeof(shm_ctx.name) - 1);
+    shm_ctx.name[sizeof(shm_ctx.name) - 1] = '\0';
+
+    size_t size = SHM_SNAPSHOT_SIZE(capacity);
+    int fd = shm_open(shm_ctx.name, O_RDWR | O_CREAT, 0644);
+    if (fd < 0) {
+        log_error("Failed to open shared memory %s: %s", shm_ctx.name, strerror(errno));
+        return -1;
+    }
+
+    uint64_t generation = 0;
+    struct stat st;
+    if (fstat(fd, &st) == 0 && st.st_size >= (off_t)sizeof(shm_snapshot_header_t)) {
+        shm_snapshot_header_t *old = mmap(NULL, (size_t)st.st_size, PROT_READ | PROT_WRITE,
+                                          MAP_SHARED, fd, 0);
+        if (old != MAP_FAILED) {
+            int reusable = old->magic == SHM_SNAPSHOT_MAGIC &&
+                           old->version == SHM_SNAPSHOT_VERSION &&
+                           old->entry_size == sizeof(shm_snapshot_entry_t) &&
+                           (size_t)st.st_size == size;
+            generation = old->generation;
+            if (reusable) {
+                close(fd);
+                shm_ctx.hdr = old;
+                shm_ctx.size = size;
+                shm_ctx.capacity = capacity;
+                for (int i = 0; i < capacity; i++) {
+                    shm_snapshot_clear_room(i);
+                }
+                old->daemon_pid = (int32_t)getpid();
+                old->start_time = (int64_t)time(NULL);
+                __atomic_store_n(&old->generation, generation + 1, __ATOMIC_RELEASE);
+                log_info("Shared memory snapshot %s reused: %d slots, generation %llu",
+                         shm_ctx.name, capacity, (unsigned long long)(generation + 1));
+                return 0;
+            }
+            retire_segment(old);
+            munmap(old, (size_t)st.st_size);
+        }
+        // Different layout: detach attached readers onto a fresh segment
+        close(fd);
+        shm_unlink(shm_ctx.name);
+        fd = shm_open(shm_ctx.name, O_RDWR | O_CREAT | O_EXCL, 0644);
+        if (fd < 0) {
+            log_error("Failed to recreate shared memory %s: %s", shm_ctx.name, strerror(errno));
+            return -1;
+        }
+    }
+
+    if (ftruncate(fd, (off_t)size) != 0) {
+        log_error("Failed to size shared memory: %s", strerror(errno));
+        close(fd);
+        shm_unlink(shm_ctx.name);
+        return -1;
+    }
+
+    void *addr = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (addr == MAP_FAILED) {
+        log_error("Failed to map shared memory: %s", strerror(errno));
+        shm_unlink(shm_ctx.name);
+        return -1;
+    }
+
+    // ftruncate() zero-fills, so every entry starts with seq 0 and state INACTIVE
+    shm_snapshot_header_t *hdr = addr;
+    hdr->version = SHM_SNAPSHOT_VERSION;
+    hdr->header_size = sizeof(shm_snapshot_header_t);
+    hdr->entry_size = sizeof(shm_snapshot_entry_t);
+    hdr->capacity = (uint32_t)capacity;
+    hdr->daemon_pid = (int32_t)getpid();
+    hdr->generation = generation + 1;
+    hdr->start_time = (int64_t)time(NULL);
+
+    // Readers treat the segment as valid only once the magic is visible
+    __atomic_store_n(&hdr->magic, SHM_SNAPSHOT_MAGIC, __ATOMIC_RELEASE);
+
+    shm_ctx.hdr = hdr;
+    shm_ctx.size = size;
+    shm_ctx.capacity = capacity;
+
+    log_info("Shared memory snapshot %s ready: %d slots, %zu bytes, generation %llu",
+             shm_ctx.name, capacity, size, (unsigned long long)hdr->generation);
+    return 0;
+}
+
+static shm_snapshot_entry_t *begin_write(int slot) {
+    if (!shm_ctx.hdr || slot < 0 || slot >= shm_ctx.capacity) {
+        return NULL;
+    }
+    shm_snapshot_entry_t *entry = &shm_snapshot_entries(shm_ctx.hdr)[slot];
+    __atomic_store_n(&entry->seq, entry->seq + 1, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+    return entry;
+}
+
+static void end_write(shm_snapshot_entry_t *entry) {
+    __atomic_store_n(&entry->seq, entry->seq + 1, __ATOMIC_RELEASE);
+}
+
+// Publish a room slot. Callers serialise writers per slot (rooms_mutex).
+void shm_snapshot_publish_room(int slot, const room_info_t *room) {
+    if (!room) return;
+
+    shm_snapshot_entry_t *entry = begin_write(slot);
+    if (!entry) return;
+
+    entry->state = (int32_t)room->state;
+    entry->collection_interval = room->collection_interval;
+    entry->error_count = room->error_count;
+    entry->last_update = (int64_t)room->last_update;
+    memcpy(entry->name, room->name, sizeof(entry->name));
+    entry->name[sizeof(entry->name) - 1] = '\0';
+    entry->data = room->latest_data;
+
+    end_write(entry);
+}
+
+// Mark a slot as free after its room was deleted
+void shm_snapshot_clear_room(int slot) {
+    shm_snapshot_entry_t *entry = begin_write(slot);
+    if (!entry) return;
+
+    entry->state = ROOM_STATE_INACTIVE;
+    entry->collection_interval = 0;
+    entry->error_count = 0;
+    entry->last_update = 0;
+    memset(entry->name, 0, sizeof(entry->name));
+    memset(&entry->data, 0, sizeof(entry->data));
+
+    end_write(entry);
+}
+
+// Retire, unmap and remove the segment
+void shm_snapshot_cleanup(void) {
+    if (!shm_ctx.hdr) return;
+
+    retire_segment(shm_ctx.hdr);
+    munmap(shm_ctx.hdr, shm_ctx.size);
+    shm_unlink(shm_ctx.name);
+    shm_ctx.hdr = NULL;
+    shm_ctx.size = 0;
+    shm_ctx.capacity = 0;
+    log_info("Shared memory snapshot removed");
+}
@@ -0,0 +1,48 @@
+#ifndef SHM_SNAPSHOT_H
+#define SHM_SNAPSHOT_H
+
+#include <stdint.h>
+#include "../commom/data_structures.h"
+
+// Shared-memory room table published by the daemon for local readers
+#define SHM_SNAPSHOT_NAME "/monitor_rooms"
+#define SHM_SNAPSHOT_MAGIC 0x4d4f4e53u   // "MONS"
+#define SHM_SNAPSHOT_VERSION 1
+
+// Segment header, followed by `capacity` entries
+typedef struct {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t header_size;
+    uint32_t entry_size;
+    uint32_t capacity;
+    int32_t daemon_pid;
+    uint64_t generation;      // Bumped each time a daemon (re)creates the segment
+    int64_t start_time;
+} __attribute__((aligned(64))) shm_snapshot_header_t;
+
+// One room slot. `seq` is a seqlock: odd while the daemon rewrites the entry.
+typedef struct {
+    volatile uint32_t seq;
+    int32_t state;
+    int32_t collection_interval;
+    int32_t error_count;
+    int64_t last_update;
+    char name[MAX_ROOM_NAME];
+    monitor_data_t data;
+} __attribute__((aligned(64))) shm_snapshot_entry_t;
+
+#define SHM_SNAPSHOT_SIZE(capacity) \
+    (sizeof(shm_snapshot_header_t) + (size_t)(capacity) * sizeof(shm_snapshot_entry_t))
+
+static inline shm_snapshot_entry_t *shm_snapshot_entries(shm_snapshot_header_t *hdr) {
+    return (shm_snapshot_entry_t *)((char *)hdr + hdr->header_size);
+}
+
+// Publisher side (daemon only)
+int shm_snapshot_init(const char *name, int capacity);
+void shm_snapshot_publish_room(int slot, const room_info_t *room);
+void shm_snapshot_clear_room(int slot);
+void shm_snapshot_cleanup(void);
+
+#endif /* SHM_SNAPSHOT_H */
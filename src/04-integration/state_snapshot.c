@@ -0,0 +1,199 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <errno.h>
+#include <time.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "state_snapshot.h"
+#include "metric_schema.h"
+#include "mem_budget.h"
+#include "logger.h"
+
+#define SNAPSHOT_INITIAL_CAPACITY 4096
+
+static uint64_t fnv1a64(const void *data, size_t len) {
+    const unsigned char *p = data;
+    uint64_t hash = 0xcbf29ce484222325ULL;
+    for (size_t i = 0; i < len; i++) {
+        hash ^= p[i];
+        hash *= 0x100000001b3ULL;
+    }
+    return hash;
+}
+
+static int writer_reserve(state_snapshot_writer_t *writer, size_t extra) {
+    if (writer->len + extra <= writer->cap) return 0;
+    size_t cap = writer->cap ? writer->cap : SNAPSHOT_INITIAL_CAPACITY;
+    while (cap < writer->len + extra) cap *= 2;
+    if (mem_reserve(MEM_SNAPSHOT, cap - writer->cap) != 0) {
+        log_warn("Memory budget refused %zu bytes for the state snapshot", cap - writer->cap);
+        return -1;
+    }
+    char *buf = realloc(writer->buf, cap);
+    if (!buf) {
+        mem_release(MEM_SNAPSHOT, cap - writer->cap);
+        return -1;
+    }
+    writer->buf = buf;
+    writer->cap = cap;
+    return 0;
+}
+
+static int writer_append(state_snapshot_writer_t *writer, const void *data, size_t len) {
+    if (writer_reserve(writer, len) != 0) return -1;
+    memcpy(writer->buf + writer->len, data, len);
+    writer->len += len;
+    return 0;
+}
+
+int state_snapshot_begin(state_snapshot_writer_t *writer) {
+    memset(writer, 0, sizeof(*writer));
+    // Header is filled in by commit once the payload is known
+    if (writer_reserve(writer, sizeof(state_snapshot_header_t)) != 0) return -1;
+    writer->len = sizeof(state_snapshot_header_t);
+    return 0;
+}
+
+int state_snapshot_add_room(state_snapshot_writer_t *writer, const room_record_t *record,
+                            const monitor_data_t *history, int history_count) {
+    if (!writer->buf || !record || history_count < 0) return -1;
+
+    state_snapshot_room_t room;
+    memset(&room, 0, sizeof(room));
+    room.record = *record;
+    room.history_count = (uint32_t)history_count;
+
+    if (writer_append(writer, &room, sizeof(room)) != 0 ||
+        writer_append(writer, history, sizeof(monitor_data_t) * (size_t)history_count) != 0) {
+        return -1;
+    }
+    writer->room_count++;
+    return 0;
+}
+
+void state_snapshot_abort(state_snapshot_writer_t *writer) {
+    mem_release(MEM_SNAPSHOT, writer->cap);
+    free(writer->buf);
+    memset(writer, 0, sizeof(*writer));
+}
+
+static int write_all(int fd, const char *buf, size_t len) {
+    while (len > 0) {
+        ssize_t n = write(fd, buf, len);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            return -1;
+        }
+        buf += n;
+        len -= (size_t)n;
+    }
+    return 0;
+}
+
+// Write to `path`.tmp, fsync and rename so readers only ever see a whole file
+int state_snapshot_commit(state_snapshot_writer_t *writer, const char *path) {
+    if (!writer->buf || !path) return -1;
+
+    state_snapshot_header_t *hdr = (state_snapshot_header_t *)writer->buf;
+    memset(hdr, 0, sizeof(*hdr));
+    hdr->magic = STATE_SNAPSHOT_MAGIC;
+    hdr->version = STATE_SNAPSHOT_VERSION;
+    hdr->room_record_size = sizeof(room_record_t);
+    hdr->sample_size = sizeof(monitor_data_t);
+    hdr->sample_schema = monitor_schema_id();
+    hdr->room_count = writer->room_count;
+    hdr->created = (int64_t)time(NULL);
+    hdr->payload_size = writer->len - sizeof(*hdr);
+    hdr->checksum = fnv1a64(writer->buf + sizeof(*hdr), hdr->payload_size);
+
+    char tmp_path[300];
+    snprintf(tmp_path, sizeof(tmp_path), "%s.tmp", path);
+
+    int fd = open(tmp_path, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0600);
+    if (fd < 0) {
+        log_error("Failed to open snapshot %s: %s", tmp_path, strerror(errno));
+        state_snapshot_abort(writer);
+        return -1;
+    }
+
+    int rc = 0;
+    if (write_all(fd, writer->buf, writer->len) != 0 || fsync(fd) != 0) {
+        log_error("Failed to write snapshot %s: %s", tmp_path, strerror(errno));
+        rc = -1;
+    }
+    close(fd);
+
+    if (rc == 0 && rename(tmp_path, path) != 0) {
+        log_error("Failed to install snapshot %s: %s", path, strerror(errno));
+        rc = -1;
+    }
+    if (rc != 0) {
+        unlink(tmp_path);
+    }
+
+    state_snapshot_abort(writer);
+    return rc;
+}
+
+// Map the snapshot and hand each room to `fn`. Returns the number of rooms
+// visited, 0 when no snapshot exists, or -1 when the file is unusable.
+int state_snapshot_load(const char *path, state_snapshot_room_fn fn, void *ctx) {
+    int fd = open(path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        if (errno == ENOENT) return 0;
+        log_error("Failed to open snapshot %s: %s", path, strerror(errno));
+        return -1;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size < (off_t)sizeof(state_snapshot_header_t)) {
+        log_warn("Ignoring truncated snapshot %s", path);
+        close(fd);
+        return -1;
+    }
+
+    size_t size = (size_t)st.st_size;
+    const char *base = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (base == MAP_FAILED) {
+        log_error("Failed to map snapshot %s: %s", path, strerror(errno));
+        return -1;
+    }
+
+    const state_snapshot_header_t *hdr = (const state_snapshot_header_t *)base;
+    if (hdr->magic != STATE_SNAPSHOT_MAGIC || hdr->version != STATE_SNAPSHOT_VERSION ||
+        hdr->room_record_size != sizeof(room_record_t) ||
+        hdr->sample_size != sizeof(monitor_data_t) ||
+        hdr->sample_schema != monitor_schema_id() ||
+        hdr->payload_size != size - sizeof(*hdr) ||
+        hdr->checksum != fnv1a64(base + sizeof(*hdr), hdr->payload_size)) {
+        log_warn("Ignoring incompatible or corrupt snapshot %s", path);
+        munmap((void *)base, size);
+        return -1;
+    }
+
+    const char *p = base + sizeof(*hdr);
+    const char *end = base + size;
+    uint32_t visited = 0;
+    while (visited < hdr->room_count) {
+        if ((size_t)(end - p) < sizeof(state_snapshot_room_t)) break;
+        const state_snapshot_room_t *room = (const state_snapshot_room_t *)p;
+        size_t history_bytes = sizeof(monitor_data_t) * (size_t)room->history_count;
+        if (room->history_count > (size_t)(end - p) / sizeof(monitor_data_t) ||
+            (size_t)(end - p) - sizeof(*room) < history_bytes) {
+            break;
+        }
+        const monitor_data_t *history = (const monitor_data_t *)(p + sizeof(*room));
+        if (fn && fn(&room->record, history, (int)room->history_count, ctx) != 0) {
+            break;
+        }
+        p += sizeof(*room) + history_bytes;
+        visited++;
+    }
+
+    munmap((void *)base, size);
+    return (int)visited;
+}
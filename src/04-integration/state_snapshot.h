@@ -0,0 +1,53 @@
+#ifndef STATE_SNAPSHOT_H
+#define STATE_SNAPSHOT_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "room_record.h"
+
+// On-disk checkpoint of room definitions, states and recent history
+#define STATE_SNAPSHOT_MAGIC 0x4d534e50u   // "MSNP"
+#define STATE_SNAPSHOT_VERSION 2
+
+// File layout: header, then per room a state_snapshot_room_t followed by
+// `history_count` monitor_data_t samples (oldest first)
+typedef struct {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t room_record_size;
+    uint32_t sample_size;
+    uint32_t room_count;
+    uint32_t sample_schema;   // monitor_schema_id() of the stored samples
+    int64_t created;
+    uint64_t payload_size;
+    uint64_t checksum;        // FNV-1a over the payload
+} state_snapshot_header_t;
+
+typedef struct {
+    room_record_t record;
+    uint32_t history_count;
+    uint32_t reserved;
+} state_snapshot_room_t;
+
+// Snapshot being assembled in memory
+typedef struct {
+    char *buf;
+    size_t len;
+    size_t cap;
+    uint32_t room_count;
+} state_snapshot_writer_t;
+
+// Called once per stored room; `history` points into the mapped file
+typedef int (*state_snapshot_room_fn)(const room_record_t *record,
+                                      const monitor_data_t *history, int history_count,
+                                      void *ctx);
+
+int state_snapshot_begin(state_snapshot_writer_t *writer);
+int state_snapshot_add_room(state_snapshot_writer_t *writer, const room_record_t *record,
+                            const monitor_data_t *history, int history_count);
+int state_snapshot_commit(state_snapshot_writer_t *writer, const char *path);
+void state_snapshot_abort(state_snapshot_writer_t *writer);
+
+int state_snapshot_load(const char *path, state_snapshot_room_fn fn, void *ctx);
+
+#endif /* STATE_SNAPSHOT_H */
@@ -0,0 +1,207 @@
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <errno.h>
+#include <signal.h>
+#include <poll.h>
+#include <time.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <sys/prctl.h>
+#include "supervisor.h"
+#include "logger.h"
+
+static struct {
+    int heartbeat_fd;                  // write end, child only
+    int restarts;                      // children started after the first
+    volatile sig_atomic_t stop_requested;
+    volatile sig_atomic_t reload_requested;
+} supervisor_ctx = { -1, 0, 0, 0 };
+
+static long long now_ms(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (long long)ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
+}
+
+static void supervisor_signal(int sig) {
+    if (sig == SIGHUP) {
+        supervisor_ctx.reload_requested = 1;
+    } else {
+        supervisor_ctx.stop_requested = 1;
+    }
+}
+
+static void install_supervisor_signals(void) {
+    struct sigaction sa;
+    memset(&sa, 0, sizeof(sa));
+    sa.sa_handler = supervisor_signal;   // no SA_RESTART: poll() must wake up
+    sigemptyset(&sa.sa_mask);
+    sigaction(SIGTERM, &sa, NULL);
+    sigaction(SIGINT, &sa, NULL);
+    sigaction(SIGHUP, &sa, NULL);
+    signal(SIGPIPE, SIG_IGN);
+}
+
+int supervisor_active(void) {
+    return supervisor_ctx.heartbeat_fd >= 0;
+}
+
+int supervisor_restarts(void) {
+    return supervisor_ctx.restarts;
+}
+
+void supervisor_heartbeat(void) {
+    if (supervisor_ctx.heartbeat_fd < 0) return;
+    char beat = 'H';
+    // Non-blocking: a full pipe already tells the supervisor we are alive
+    if (write(supervisor_ctx.heartbeat_fd, &beat, 1) < 0 && errno != EAGAIN) {
+        log_debug("Heartbeat write failed: %s", strerror(errno));
+    }
+}
+
+// Child side of the fork: keep the write end and die with the supervisor
+static void become_child(int heartbeat_fds[2], pid_t supervisor_pid) {
+    close(heartbeat_fds[0]);
+    fcntl(heartbeat_fds[1], F_SETFL, O_NONBLOCK);
+    supervisor_ctx.heartbeat_fd = heartbeat_fds[1];
+    signal(SIGTERM, SIG_DFL);
+    signal(SIGINT, SIG_DFL);
+    signal(SIGHUP, SIG_IGN);           // until the daemon installs its handler
+    prctl(PR_SET_PDEATHSIG, SIGTERM);
+    if (getppid() != supervisor_pid) _exit(1);
+}
+
+// Watch one child until it exits; returns its wait status
+static int watch_child(pid_t pid, int heartbeat_fd) {
+    long long last_beat = now_ms();
+    long long timeout_ms = SUPERVISOR_STARTUP_TIMEOUT_MS;   // until the first beat
+    long long stop_sent = 0;
+    int status = 0;
+    struct pollfd pfd = { .fd = heartbeat_fd, .events = POLLIN };
+
+    for (;;) {
+        if (supervisor_ctx.stop_requested && !stop_sent) {
+            log_info("Supervisor stopping daemon %d", (int)pid);
+            kill(pid, SIGTERM);
+            stop_sent = now_ms();
+        }
+        if (supervisor_ctx.reload_requested) {
+            supervisor_ctx.reload_requested = 0;
+            kill(pid, SIGHUP);
+        }
+
+        int ready = poll(&pfd, 1, SUPERVISOR_POLL_MS);
+        if (ready > 0) {
+            char buf[64];
+            ssize_t n = read(heartbeat_fd, buf, sizeof(buf));
+            if (n > 0) {
+                last_beat = now_ms();
+                timeout_ms = SUPERVISOR_HEARTBEAT_TIMEOUT_MS;
+            } else if (n == 0) {
+                // Write end closed: the child is exiting or already gone
+                while (waitpid(pid, &status, 0) < 0 && errno == EINTR) {}
+                return status;
+            }
+        }
+
+        pid_t done = waitpid(pid, &status, WNOHANG);
+        if (done == pid) return status;
+
+        long long now = now_ms();
+        if (stop_sent) {
+            if (now - stop_sent > SUPERVISOR_STOP_TIMEOUT_MS) {
+                log_warn("Daemon %d ignored SIGTERM, killing it", (int)pid);
+                kill(pid, SIGKILL);
+                stop_sent = now;
+            }
+        } else if (now - last_beat > timeout_ms) {
+            log_error("Daemon %d missed heartbeats for %lld ms, killing it",
+                      (int)pid, now - last_beat);
+            kill(pid, SIGKILL);
+            last_beat = now;
+        }
+    }
+}
+
+// Sleep for the backoff delay unless asked to stop first
+static void backoff_wait(int delay_ms) {
+    long long until = now_ms() + delay_ms;
+    while (!supervisor_ctx.stop_requested) {
+        long long left = until - now_ms();
+        if (left <= 0) break;
+        poll(NULL, 0, (int)left);
+    }
+}
+
+int supervisor_run(int *exit_status) {
+    pid_t supervisor_pid = getpid();
+    int backoff_ms = 0;
+
+    install_supervisor_signals();
+    log_info("Supervisor %d started", (int)supervisor_pid);
+
+    while (!supervisor_ctx.stop_requested) {
+        int fds[2];
+        if (pipe2(fds, O_CLOEXEC) != 0) {
+            log_error("Supervisor cannot create heartbeat pipe: %s", strerror(errno));
+            *exit_status = 1;
+            return supervisor_ctx.restarts ? 1 : -1;
+        }
+
+        long long started = now_ms();
+        pid_t pid = fork();
+        if (pid < 0) {
+            log_error("Supervisor fork failed: %s", strerror(errno));
+            close(fds[0]);
+            close(fds[1]);
+            if (supervisor_ctx.restarts == 0) return -1;
+            backoff_wait(SUPERVISOR_BACKOFF_MAX_MS);
+            continue;
+        }
+        if (pid == 0) {
+            become_child(fds, supervisor_pid);
+            return 0;
+        }
+
+        close(fds[1]);
+        log_info("Supervisor started daemon %d", (int)pid);
+        int status = watch_child(pid, fds[0]);
+        close(fds[0]);
+        long long uptime_ms = now_ms() - started;
+
+        // A supervised daemon refuses --upgrade handoffs, so exiting 0 is a stop
+        if (supervisor_ctx.stop_requested || (WIFEXITED(status) && WEXITSTATUS(status) == 0)) {
+            log_info("Daemon %d exited, supervisor stopping", (int)pid);
+            *exit_status = WIFEXITED(status) ? WEXITSTATUS(status) : 0;
+            return 1;
+        }
+
+        if (WIFSIGNALED(status)) {
+            log_error("Daemon %d killed by signal %d after %lld ms",
+                      (int)pid, WTERMSIG(status), uptime_ms);
+        } else {
+            log_error("Daemon %d exited with status %d after %lld ms",
+                      (int)pid, WEXITSTATUS(status), uptime_ms);
+        }
+
+        // First crash after a stable run restarts at once; a crash loop backs off
+        if (uptime_ms >= SUPERVISOR_STABLE_SECS * 1000LL) {
+            backoff_ms = 0;
+        } else if (backoff_ms == 0) {
+            backoff_ms = SUPERVISOR_BACKOFF_MIN_MS;
+        } else if (backoff_ms < SUPERVISOR_BACKOFF_MAX_MS) {
+            backoff_ms *= 2;
+            if (backoff_ms > SUPERVISOR_BACKOFF_MAX_MS) backoff_ms = SUPERVISOR_BACKOFF_MAX_MS;
+        }
+        supervisor_ctx.restarts++;
+        if (backoff_ms > 0) {
+            log_warn("Restarting daemon in %d ms (restart %d)", backoff_ms, supervisor_ctx.restarts);
+            backoff_wait(backoff_ms);
+        }
+    }
+
+    *exit_status = 0;
+    return 1;
+}
@@ -0,0 +1,32 @@
+#ifndef SUPERVISOR_H
+#define SUPERVISOR_H
+
+// Heartbeat and restart policy for `--supervise`
+// A hang is caught within HEARTBEAT_TIMEOUT_MS + POLL_MS and the restart
+// follows at once after a stable run, which keeps hang-to-recovery under 1 s.
+// Only the main loop beats; a stuck room or client thread is not detected.
+#define SUPERVISOR_POLL_MS 100
+#define SUPERVISOR_HEARTBEAT_INTERVAL_MS 100    // main loop tick of the daemon
+#define SUPERVISOR_HEARTBEAT_TIMEOUT_MS 500     // no heartbeat for this long: child is hung
+#define SUPERVISOR_STARTUP_TIMEOUT_MS 10000     // allowance for startup before the first beat
+#define SUPERVISOR_STOP_TIMEOUT_MS 10000        // grace period after forwarding SIGTERM
+#define SUPERVISOR_BACKOFF_MIN_MS 100
+#define SUPERVISOR_BACKOFF_MAX_MS 30000
+#define SUPERVISOR_STABLE_SECS 10               // uptime that resets the backoff
+
+// Fork the daemon and restart it whenever it dies or stops sending
+// heartbeats. Returns 0 in the child, which carries on with normal startup.
+// In the supervisor it returns 1 once supervision ends, with the status the
+// process should exit with in *exit_status; -1 if the first fork failed.
+int supervisor_run(int *exit_status);
+
+// Called periodically by the supervised daemon; no-op when unsupervised
+void supervisor_heartbeat(void);
+
+// Non-zero in a daemon started by the supervisor
+int supervisor_active(void);
+
+// Number of times the daemon has been restarted (0 for the first child)
+int supervisor_restarts(void);
+
+#endif /* SUPERVISOR_H */
@@ -0,0 +1,159 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include "../adaptive_interval.h"
+
+static monitor_data_t sample(float cpu, float memory) {
+    monitor_data_t data;
+    memset(&data, 0, sizeof(data));
+    data.cpu_usage = cpu;
+    data.memory_usage = memory;
+    return data;
+}
+
+static void set_policy(int min_ms, double max_rate) {
+    adaptive_policy_t policy = { min_ms, max_rate, 90.0f, 90.0f };
+    adaptive_set_policy(&policy);
+}
+
+static void reset_slots(int count) {
+    for (int i = 0; i < count; i++) adaptive_configure(i, 0);
+}
+
+static void test_fixed_room(void) {
+    reset_slots(4);
+    set_policy(250, 0);
+    adaptive_configure(0, 0);
+    adaptive_start(0, 5000);
+    monitor_data_t spike = sample(99, 99), idle = sample(1, 1);
+    for (int i = 0; i < 10; i++) {
+        assert(adaptive_observe(0, i % 2 ? &spike : &idle) == 5000);
+    }
+    adaptive_set_base(0, 2000);
+    assert(adaptive_interval_ms(0) == 2000);
+    assert(adaptive_max_ms(0) == 0);
+    printf("✓ Fixed rooms keep their collection interval\n");
+}
+
+static void test_stable_room_stretches(void) {
+    reset_slots(4);
+    set_policy(250, 0);
+    adaptive_configure(0, 8000);
+    adaptive_start(0, 1000);
+    monitor_data_t flat = sample(10, 20);
+    int previous = 1000, samples = 0;
+    while (adaptive_interval_ms(0) < 8000 && samples < 200) {
+        int next = adaptive_observe(0, &flat);
+        assert(next >= previous && "Stable samples must never shorten the interval");
+        previous = next;
+        samples++;
+    }
+    assert(adaptive_interval_ms(0) == 8000);
+    assert(samples > ADAPTIVE_STABLE_SAMPLES * 5 && "Stretching is gradual");
+    for (int i = 0; i < 10; i++) assert(adaptive_observe(0, &flat) == 8000);
+    printf("✓ Stable rooms stretch to their cap in %d samples\n", samples);
+}
+
+static void test_volatile_room_shortens(void) {
+    reset_slots(4);
+    set_policy(250, 0);
+    adaptive_configure(0, 8000);
+    adaptive_start(0, 4000);
+    monitor_data_t low = sample(10, 20), high = sample(40, 20);
+    adaptive_observe(0, &low);
+    assert(adaptive_observe(0, &high) == 2000);
+    assert(adaptive_observe(0, &low) == 1000);
+    for (int i = 0; i < 10; i++) adaptive_observe(0, i % 2 ? &low : &high);
+    assert(adaptive_interval_ms(0) == 250);
+
+    // Once the signal settles the interval grows back
+    for (int i = 0; i < 40; i++) adaptive_observe(0, &low);
+    assert(adaptive_interval_ms(0) > 1000);
+    printf("✓ Volatile rooms shorten to the floor and recover\n");
+}
+
+static void test_alert_proximity(void) {
+    reset_slots(4);
+    set_policy(500, 0);
+    adaptive_configure(0, 8000);
+    adaptive_start(0, 4000);
+    monitor_data_t hot = sample(85, 10), tight = sample(10, 88);
+    assert(adaptive_observe(0, &hot) == 2000);
+    assert(adaptive_observe(0, &hot) == 1000);
+    assert(adaptive_observe(0, &tight) == 500);
+    assert(adaptive_observe(0, &tight) == 500);
+    printf("✓ Samples near an alert threshold shorten the interval\n");
+}
+
+static void test_sample_budget(void) {
+    reset_slots(4);
+    set_policy(100, 10.0);
+    adaptive_start(0, 200);             // fixed, 5 samples/sec
+    adaptive_configure(1, 10000);
+    adaptive_configure(2, 10000);
+    adaptive_start(1, 1000);
+    adaptive_start(2, 1000);
+    monitor_data_t low = sample(10, 20), high = sample(60, 20);
+    for (int i = 0; i < 20; i++) {
+        adaptive_observe(1, i % 2 ? &low : &high);
+        adaptive_observe(2, i % 2 ? &low : &high);
+        assert(adaptive_sample_rate() <= 10.0 + 1e-9);
+    }
+    // Whichever room shortens first takes the headroom; together they use all of it
+    assert(adaptive_interval_ms(1) < 1000 || adaptive_interval_ms(2) < 1000);
+    assert(adaptive_sample_rate() > 9.0);
+    int before = adaptive_interval_ms(1) + adaptive_interval_ms(2);
+
+    // Stopping the fixed room frees its share
+    adaptive_stop(0);
+    for (int i = 0; i < 20; i++) {
+        adaptive_observe(1, i % 2 ? &low : &high);
+        adaptive_observe(2, i % 2 ? &low : &high);
+        assert(adaptive_sample_rate() <= 10.0 + 1e-9);
+    }
+    assert(adaptive_interval_ms(1) + adaptive_interval_ms(2) < before);
+    assert(adaptive_sample_rate() > 9.0);
+
+    // With no headroom left adaptive rooms back off to their cap
+    set_policy(100, 1.0);
+    adaptive_start(0, 1000);
+    adaptive_observe(1, &high);
+    adaptive_observe(2, &high);
+    assert(adaptive_interval_ms(1) == 10000 && adaptive_interval_ms(2) == 10000);
+
+    // The budget never stretches fixed rooms; they alone may exceed it
+    adaptive_start(3, 200);
+    assert(adaptive_observe(3, &high) == 200 && adaptive_sample_rate() > adaptive_rate_cap());
+    adaptive_stop(3);
+    printf("✓ Shortening stays within the samples/sec budget (%.2f/s)\n", adaptive_sample_rate());
+}
+
+static void test_hold_at_cap(void) {
+    reset_slots(4);
+    set_policy(250, 0);
+    adaptive_configure(0, 6000);
+    adaptive_start(0, 1000);
+    adaptive_start(1, 1000);            // fixed
+    adaptive_set_hold(1);
+    assert(adaptive_interval_ms(0) == 6000 && adaptive_interval_ms(1) == 1000);
+    monitor_data_t hot = sample(95, 10);
+    assert(adaptive_observe(0, &hot) == 6000);
+    adaptive_set_hold(0);
+    assert(adaptive_observe(0, &hot) == 3000);
+    printf("✓ A hold keeps adaptive rooms at their cap\n");
+}
+
+int main() {
+    printf("Testing adaptive intervals...\n");
+    assert(adaptive_init(4) == 0);
+    test_fixed_room();
+    test_stable_room_stretches();
+    test_volatile_room_shortens();
+    test_alert_proximity();
+    test_sample_budget();
+    test_hold_at_cap();
+    adaptive_cleanup();
+    printf("All adaptive interval tests passed!\n");
+    return 0;
+}
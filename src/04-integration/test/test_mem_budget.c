@@ -0,0 +1,152 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include "../mem_budget.h"
+#include "../room_history.h"
+
+static monitor_data_t sample(float cpu) {
+    monitor_data_t data;
+    memset(&data, 0, sizeof(data));
+    data.cpu_usage = cpu;
+    return data;
+}
+
+static void test_reserve_and_release(void) {
+    mem_budget_set_limit(1000);
+    assert(mem_reserve(MEM_CLIENTS, 600) == 0);
+    assert(mem_reserve(MEM_ROOMS, 500) == -1);
+    assert(mem_refusals() == 1);
+    assert(mem_reserve(MEM_ROOMS, 400) == 0);
+    assert(mem_total_used() == 1000);
+
+    // Charges go over the limit; reservations then fail until it drops
+    mem_charge(MEM_SHARED, 100);
+    assert(mem_reserve(MEM_ROOMS, 1) == -1);
+    mem_release(MEM_SHARED, 100);
+    mem_release(MEM_ROOMS, 400);
+    assert(mem_reserve(MEM_ROOMS, 400) == 0);
+
+    char buf[256];
+    mem_budget_format(buf, sizeof(buf));
+    assert(strstr(buf, "of 0 kB") && strstr(buf, "clients: 0 kB") && strstr(buf, "Refused: 2"));
+
+    mem_release(MEM_ROOMS, 400);
+    mem_release(MEM_CLIENTS, 600);
+    assert(mem_total_used() == 0);
+    mem_budget_set_limit(0);
+    assert(mem_reserve(MEM_SNAPSHOT, (size_t)1 << 40) == 0);
+    mem_release(MEM_SNAPSHOT, (size_t)1 << 40);
+    assert(strcmp(mem_subsystem_name(MEM_HISTORY), "history") == 0);
+    printf("✓ Reservations stop at the limit and are accounted per subsystem\n");
+}
+
+static void test_pool(void) {
+    mem_pool_t pool;
+    mem_pool_init(&pool, MEM_CLIENTS, 24, 4);
+    void *a = mem_pool_alloc(&pool);
+    assert(a && ((size_t)a % 16) == 0 && mem_pool_capacity(&pool) == 4);
+    size_t chunk = mem_used(MEM_CLIENTS);
+    assert(chunk >= 4 * 24);
+
+    // Freed blocks are reused before the pool grows
+    mem_pool_free(&pool, a);
+    assert(mem_pool_alloc(&pool) == a);
+    void *blocks[8];
+    for (int i = 0; i < 3; i++) blocks[i] = mem_pool_alloc(&pool);
+    assert(pool.in_use == 4 && mem_pool_capacity(&pool) == 4);
+
+    // A full budget refuses the next chunk
+    mem_budget_set_limit(mem_total_used());
+    assert(mem_pool_alloc(&pool) == NULL);
+    mem_budget_set_limit(0);
+    blocks[3] = mem_pool_alloc(&pool);
+    assert(blocks[3] && mem_pool_capacity(&pool) == 8 && mem_used(MEM_CLIENTS) == 2 * chunk);
+
+    mem_pool_destroy(&pool);
+    assert(mem_used(MEM_CLIENTS) == 0);
+    printf("✓ Pools reuse freed blocks and grow within the budget\n");
+}
+
+static void test_history_ring(void) {
+    assert(room_history_init(4) == 0);
+    for (int i = 0; i < 100; i++) {
+        monitor_data_t data = sample((float)i);
+        room_history_push(0, &data);
+    }
+    assert(room_history_count(0) == ROOM_HISTORY_DEPTH);
+
+    monitor_data_t out[ROOM_HISTORY_DEPTH];
+    assert(room_history_copy(0, out, ROOM_HISTORY_DEPTH) == ROOM_HISTORY_DEPTH);
+    for (int i = 0; i < ROOM_HISTORY_DEPTH; i++) assert(out[i].cpu_usage == 40 + i);
+    assert(room_history_copy(0, out, 7) == 7 && out[0].cpu_usage == 93 && out[6].cpu_usage == 99);
+
+    room_history_restore(1, out, 7);
+    assert(room_history_count(1) == 7);
+    room_history_clear(0);
+    assert(room_history_count(0) == 0);
+
+    room_history_stats_t stats;
+    room_history_stats(&stats);
+    assert(stats.segments == 1 && stats.evictions == 0);
+    room_history_cleanup();
+    assert(mem_used(MEM_HISTORY) == 0);
+    printf("✓ Segmented history keeps the newest %d samples in order\n", ROOM_HISTORY_DEPTH);
+}
+
+static void test_history_eviction(void) {
+    assert(room_history_init(4) == 0);
+    monitor_data_t data = sample(0);
+    room_history_push(0, &data);
+
+    // Freeze the budget at one chunk: room 0 holds one segment, four free
+    mem_budget_set_limit(mem_total_used());
+    for (int i = 0; i <= ROOM_HISTORY_DEPTH; i++) {
+        data = sample((float)i);
+        room_history_push(1, &data);
+    }
+    // Room 0's only segment is spared, so room 1 recycled its own oldest
+    room_history_stats_t stats;
+    room_history_stats(&stats);
+    assert(stats.evictions == 1 && stats.capacity == stats.segments);
+    assert(room_history_count(0) == 1);
+    assert(room_history_count(1) == ROOM_HISTORY_DEPTH + 1 - ROOM_HISTORY_SEGMENT);
+
+    // A new room takes the oldest segment of the room that has several
+    data = sample(100);
+    room_history_push(2, &data);
+    assert(room_history_count(2) == 1 && room_history_count(0) == 1);
+    monitor_data_t out[ROOM_HISTORY_DEPTH];
+    int n = room_history_copy(1, out, ROOM_HISTORY_DEPTH);
+    assert(n == ROOM_HISTORY_DEPTH + 1 - 2 * ROOM_HISTORY_SEGMENT);
+    assert(out[0].cpu_usage == 2 * ROOM_HISTORY_SEGMENT && out[n - 1].cpu_usage == ROOM_HISTORY_DEPTH);
+
+    room_history_cleanup();
+    mem_budget_set_limit(0);
+    printf("✓ A spent budget evicts the oldest history segment first\n");
+}
+
+static void test_history_drops_without_victims(void) {
+    assert(room_history_init(2) == 0);
+    mem_budget_set_limit(mem_total_used());
+    monitor_data_t data = sample(1);
+    room_history_push(0, &data);
+    room_history_stats_t stats;
+    room_history_stats(&stats);
+    assert(room_history_count(0) == 0 && stats.dropped == 1 && stats.capacity == 0);
+    room_history_cleanup();
+    mem_budget_set_limit(0);
+    assert(mem_total_used() == 0);
+    printf("✓ Samples are dropped when the budget has no room for history\n");
+}
+
+int main() {
+    printf("Testing memory budget...\n");
+    test_reserve_and_release();
+    test_pool();
+    test_history_ring();
+    test_history_eviction();
+    test_history_drops_without_victims();
+    printf("All memory budget tests passed!\n");
+    return 0;
+}
@@ -0,0 +1,142 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include <time.h>
+#include "../metric_schema.h"
+
+static double now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+static void fill_sample(monitor_data_t *data) {
+    memset(data, 0, sizeof(*data));
+    snprintf(data->room_name, sizeof(data->room_name), "web");
+    data->cpu_usage = 45.25f;
+    data->memory_usage = 67.5f;
+    data->memory_free = 2048;
+    data->process_count = 123;
+    data->timestamp = 1700000000;
+}
+
+static void test_schema_table(void) {
+    assert(MONITOR_METRIC_COUNT == 4);
+    for (int i = 0; i < MONITOR_METRIC_COUNT; i++) {
+        const metric_field_t *f = &monitor_metric_fields[i];
+        assert(f->tag_len == strlen(f->tag));
+        assert(f->offset < sizeof(monitor_data_t));
+        for (int j = 0; j < i; j++) {
+            assert(strcmp(f->tag, monitor_metric_fields[j].tag) != 0 && "FIFO tags must be unique");
+        }
+    }
+    assert(monitor_metric_fields[MONITOR_METRIC_process_count].type == METRIC_FIELD_INT);
+    assert(monitor_schema_id() == monitor_schema_id() && monitor_schema_id() != 0);
+    printf("✓ Schema table matches monitor_data_t\n");
+}
+
+static void test_fifo_round_trip(void) {
+    monitor_data_t in, out;
+    fill_sample(&in);
+    char line[256];
+    int len = monitor_data_format_fifo(&in, line, sizeof(line));
+    assert(len == (int)strlen(line));
+    assert(strcmp(line, "DATA:web|CPU:45.25|MEM:67.50|FREE:2048|PROC:123") == 0);
+
+    memset(&out, 0, sizeof(out));
+    assert(monitor_data_parse_fifo(line, &out) == MONITOR_METRIC_COUNT);
+    assert(strcmp(out.room_name, "web") == 0);
+    assert(out.cpu_usage == in.cpu_usage && out.memory_usage == in.memory_usage);
+    assert(out.memory_free == in.memory_free && out.process_count == in.process_count);
+    printf("✓ FIFO lines round-trip through the generated parser\n");
+}
+
+static void test_fifo_tolerance(void) {
+    monitor_data_t data;
+    memset(&data, 0, sizeof(data));
+    data.memory_free = 77;
+
+    // The original three-metric format still parses; FREE is left alone
+    assert(monitor_data_parse_fifo("DATA:db|CPU:45.2|MEM:67.8|PROC:12\n", &data) == 3);
+    assert(strcmp(data.room_name, "db") == 0 && data.process_count == 12 && data.memory_free == 77);
+
+    // Unknown tags, empty values and stray tokens are skipped
+    assert(monitor_data_parse_fifo("DATA:db|DISK:9|CPU:|junk|PROC:5|MEM", &data) == 1);
+    assert(data.process_count == 5 && data.cpu_usage > 45.1f && data.cpu_usage < 45.3f);
+
+    assert(monitor_data_parse_fifo("STATUS:ok", &data) == -1);
+    assert(monitor_data_parse_fifo("DATA:", &data) == 0);
+
+    char long_name[200];
+    memset(long_name, 'x', sizeof(long_name));
+    memcpy(long_name, "DATA:", 5);
+    long_name[sizeof(long_name) - 1] = '\0';
+    assert(monitor_data_parse_fifo(long_name, &data) == 0);
+    assert(strlen(data.room_name) == sizeof(data.room_name) - 1);
+    printf("✓ Old, partial and malformed FIFO lines are handled\n");
+}
+
+static void test_text_formats(void) {
+    monitor_data_t data;
+    fill_sample(&data);
+    char buf[256];
+
+    monitor_data_format_text(&data, buf, sizeof(buf));
+    assert(strcmp(buf, "CPU: 45.25%, Memory: 67.50%, Free memory: 2048 kB, Processes: 123") == 0);
+
+    monitor_data_format_log(&data, buf, sizeof(buf));
+    assert(strcmp(buf, "cpu_usage=45.25 memory_usage=67.50 memory_free=2048 process_count=123") == 0);
+
+    monitor_data_format_json(&data, buf, sizeof(buf));
+    assert(strcmp(buf, "{\"room\":\"web\",\"timestamp\":1700000000,\"cpu_usage\":45.25,"
+                       "\"memory_usage\":67.50,\"memory_free\":2048,\"process_count\":123}") == 0);
+
+    snprintf(data.room_name, sizeof(data.room_name), "a\"b\\c\n");
+    monitor_data_format_json(&data, buf, sizeof(buf));
+    assert(strncmp(buf, "{\"room\":\"a\\\"b\\\\c\\u000a\",", 24) == 0);
+    printf("✓ Text, log and JSON output follow the schema\n");
+}
+
+static void test_truncation(void) {
+    monitor_data_t data;
+    fill_sample(&data);
+    char full[256], small[16];
+    int need = monitor_data_format_text(&data, full, sizeof(full));
+    assert(monitor_data_format_text(&data, small, sizeof(small)) == need);
+    assert(strlen(small) == sizeof(small) - 1 && strncmp(small, full, sizeof(small) - 1) == 0);
+    assert(monitor_data_format_json(&data, NULL, 0) == (int)strlen(
+        "{\"room\":\"web\",\"timestamp\":1700000000,\"cpu_usage\":45.25,"
+        "\"memory_usage\":67.50,\"memory_free\":2048,\"process_count\":123}"));
+    printf("✓ Formatters report the full length when truncated\n");
+}
+
+static void bench_parse(void) {
+    monitor_data_t data;
+    fill_sample(&data);
+    char line[256];
+    monitor_data_format_fifo(&data, line, sizeof(line));
+
+    const int rounds = 200000;
+    int found = 0;
+    double t0 = now_ns();
+    for (int i = 0; i < rounds; i++) found += monitor_data_parse_fifo(line, &data);
+    double t1 = now_ns();
+    for (int i = 0; i < rounds; i++) monitor_data_format_fifo(&data, line, sizeof(line));
+    double t2 = now_ns();
+    assert(found == rounds * MONITOR_METRIC_COUNT);
+    printf("  FIFO parse %.0f ns/line, format %.0f ns/line\n",
+           (t1 - t0) / rounds, (t2 - t1) / rounds);
+}
+
+int main() {
+    printf("Testing metric schema...\n");
+    test_schema_table();
+    test_fifo_round_trip();
+    test_fifo_tolerance();
+    test_text_formats();
+    test_truncation();
+    bench_parse();
+    printf("All metric schema tests passed!\n");
+    return 0;
+}
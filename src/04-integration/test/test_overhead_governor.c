@@ -0,0 +1,117 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include <time.h>
+#include "../overhead_governor.h"
+
+#define SEC 1000000ULL
+
+// Advance one second of wall clock during which the process used `percent`
+// of a core
+static governor_level_t tick(governor_t *gov, uint64_t *cpu, uint64_t *wall, double percent) {
+    *wall += SEC;
+    *cpu += (uint64_t)(percent * SEC / 100.0);
+    return governor_update(gov, *cpu, *wall);
+}
+
+static void test_escalates_one_level_per_tick(void) {
+    governor_t gov;
+    governor_init(&gov, 2.0);
+    uint64_t cpu = 0, wall = 0;
+    assert(governor_update(&gov, cpu, wall) == GOVERNOR_NORMAL);
+    assert(tick(&gov, &cpu, &wall, 1.0) == GOVERNOR_NORMAL);
+    assert(tick(&gov, &cpu, &wall, 9.0) == GOVERNOR_QUIET);
+    assert(tick(&gov, &cpu, &wall, 9.0) == GOVERNOR_SLOW);
+    assert(tick(&gov, &cpu, &wall, 9.0) == GOVERNOR_COALESCE);
+    assert(tick(&gov, &cpu, &wall, 9.0) == GOVERNOR_COALESCE);
+    assert(gov.escalations == 3 && gov.recoveries == 0);
+    assert(gov.cpu_percent > 8.0 && gov.cpu_percent < 9.01);
+    printf("✓ Sustained overhead escalates one level per tick\n");
+}
+
+static void test_recovers_with_hysteresis(void) {
+    governor_t gov;
+    governor_init(&gov, 2.0);
+    uint64_t cpu = 0, wall = 0;
+    governor_update(&gov, cpu, wall);
+    for (int i = 0; i < 5; i++) tick(&gov, &cpu, &wall, 10.0);
+    assert(gov.level == GOVERNOR_COALESCE);
+
+    // Between half the budget and the budget: hold the level
+    for (int i = 0; i < 20; i++) assert(tick(&gov, &cpu, &wall, 1.5) == GOVERNOR_COALESCE);
+
+    // Well under budget: one step back per GOVERNOR_RECOVER_TICKS
+    int ticks = 0;
+    while (gov.level != GOVERNOR_NORMAL && ticks < 100) {
+        tick(&gov, &cpu, &wall, 0.1);
+        ticks++;
+    }
+    assert(gov.level == GOVERNOR_NORMAL && gov.recoveries == 3);
+    assert(ticks >= 3 * GOVERNOR_RECOVER_TICKS && ticks <= 3 * GOVERNOR_RECOVER_TICKS + 2);
+    printf("✓ Recovery steps back after %d calm ticks\n", ticks);
+}
+
+static void test_single_spike_is_smoothed(void) {
+    governor_t gov;
+    governor_init(&gov, 2.0);
+    uint64_t cpu = 0, wall = 0;
+    governor_update(&gov, cpu, wall);
+    for (int i = 0; i < 5; i++) tick(&gov, &cpu, &wall, 0.5);
+    assert(tick(&gov, &cpu, &wall, 3.0) == GOVERNOR_NORMAL);
+    assert(tick(&gov, &cpu, &wall, 0.5) == GOVERNOR_NORMAL);
+    printf("✓ A short spike under twice the budget does not escalate\n");
+}
+
+static void test_disabled_and_clock_jumps(void) {
+    governor_t gov;
+    governor_init(&gov, 2.0);
+    uint64_t cpu = 0, wall = 0;
+    governor_update(&gov, cpu, wall);
+    for (int i = 0; i < 3; i++) tick(&gov, &cpu, &wall, 50.0);
+    assert(gov.level == GOVERNOR_COALESCE);
+
+    // A reload that disables the budget restores normal operation
+    gov.budget_percent = 0;
+    assert(tick(&gov, &cpu, &wall, 50.0) == GOVERNOR_NORMAL);
+
+    // No elapsed time or a CPU counter going backwards only re-baselines
+    gov.budget_percent = 2.0;
+    double before = gov.cpu_percent;
+    assert(governor_update(&gov, cpu + SEC, wall) == GOVERNOR_NORMAL);
+    assert(governor_update(&gov, 0, wall + SEC) == GOVERNOR_NORMAL);
+    assert(gov.cpu_percent == before);
+    assert(strcmp(governor_level_name(GOVERNOR_SLOW), "slow") == 0);
+    assert(strcmp(governor_level_name(GOVERNOR_LEVELS), "unknown") == 0);
+    printf("✓ Disabled budgets and clock anomalies are handled\n");
+}
+
+static void test_self_cpu(void) {
+    uint64_t before, after;
+    assert(governor_self_cpu_us(&before) == 0);
+    clock_t start = clock();
+    volatile unsigned long spin = 0;
+    while ((double)(clock() - start) / CLOCKS_PER_SEC < 0.05) spin++;
+    assert(governor_self_cpu_us(&after) == 0);
+    assert(after - before >= 40000);
+
+    // Measuring has to be cheap enough to run every tick
+    struct timespec t0, t1;
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+    for (int i = 0; i < 10000; i++) governor_self_cpu_us(&after);
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+    double ns = ((t1.tv_sec - t0.tv_sec) * 1e9 + (t1.tv_nsec - t0.tv_nsec)) / 10000;
+    printf("✓ Process CPU time measured (%llu us spun, %.0f ns per reading)\n",
+           (unsigned long long)(after - before), ns);
+}
+
+int main() {
+    printf("Testing overhead governor...\n");
+    test_escalates_one_level_per_tick();
+    test_recovers_with_hysteresis();
+    test_single_spike_is_smoothed();
+    test_disabled_and_clock_jumps();
+    test_self_cpu();
+    printf("All overhead governor tests passed!\n");
+    return 0;
+}
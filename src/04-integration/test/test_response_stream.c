@@ -0,0 +1,171 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include <time.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/socket.h>
+#include "../response_stream.h"
+
+typedef struct {
+    int fd;
+    int delay_us;           // pause before each read, to hold the writer back
+    char *data;
+    size_t len;
+} reader_t;
+
+static void *read_all(void *arg) {
+    reader_t *reader = arg;
+    size_t cap = 1 << 16;
+    reader->data = malloc(cap);
+    char chunk[1024];
+    ssize_t n;
+    while (1) {
+        if (reader->delay_us) usleep((useconds_t)reader->delay_us);
+        if ((n = read(reader->fd, chunk, sizeof(chunk))) <= 0) break;
+        if (reader->len + (size_t)n + 1 > cap) {
+            cap *= 2;
+            reader->data = realloc(reader->data, cap);
+        }
+        memcpy(reader->data + reader->len, chunk, (size_t)n);
+        reader->len += (size_t)n;
+    }
+    reader->data[reader->len] = '\0';
+    return NULL;
+}
+
+static void socket_pair(int fds[2]) {
+    assert(socketpair(AF_UNIX, SOCK_STREAM, 0, fds) == 0);
+    int small = 4096;
+    setsockopt(fds[0], SOL_SOCKET, SO_SNDBUF, &small, sizeof(small));
+    setsockopt(fds[1], SOL_SOCKET, SO_RCVBUF, &small, sizeof(small));
+}
+
+static double now_ms(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000.0 + ts.tv_nsec / 1e6;
+}
+
+// Stream `entries` room names the way `list` does; returns the elapsed ms
+static double stream_entries(int entries, int delay_us, reader_t *reader) {
+    int fds[2];
+    socket_pair(fds);
+    memset(reader, 0, sizeof(*reader));
+    reader->fd = fds[1];
+    reader->delay_us = delay_us;
+    pthread_t thread;
+    pthread_create(&thread, NULL, read_all, reader);
+
+    static response_stream_t out;
+    double t0 = now_ms();
+    response_stream_init(&out, fds[0]);
+    response_stream_printf(&out, "SUCCESS: Active rooms");
+    for (int i = 0; i < entries; i++) {
+        assert(response_stream_printf(&out, "%sroom-%05d (running), ", i ? "" : "\nData: ", i) == 0);
+    }
+    response_stream_printf(&out, "\n");
+    assert(response_stream_flush(&out) == 0);
+    double elapsed = now_ms() - t0;
+    assert(out.sent == strlen("SUCCESS: Active rooms\nData: \n") + (size_t)entries * strlen("room-00000 (running), "));
+
+    close(fds[0]);
+    pthread_join(thread, NULL);
+    close(fds[1]);
+    return elapsed;
+}
+
+static void test_long_list_is_complete(void) {
+    reader_t reader;
+    stream_entries(10000, 0, &reader);
+    assert(strncmp(reader.data, "SUCCESS: Active rooms\nData: room-00000 (running), ", 50) == 0);
+    assert(strstr(reader.data, "room-09999 (running), \n") == reader.data + reader.len - 23);
+    int seen = 0;
+    for (char *p = reader.data; (p = strstr(p, "room-")); p++) {
+        assert(atoi(p + 5) == seen);
+        seen++;
+    }
+    assert(seen == 10000);
+    free(reader.data);
+    printf("✓ 10000 entries arrive complete and in order\n");
+}
+
+static void test_backpressure(void) {
+    // A slow reader keeps the socket buffer full; the writer waits instead of failing
+    reader_t reader;
+    stream_entries(2000, 200, &reader);
+    assert(strstr(reader.data, "room-01999 (running), \n") != NULL);
+    free(reader.data);
+    printf("✓ Writer waits for a slow reader\n");
+}
+
+static void test_append_and_oversized_entries(void) {
+    int fds[2];
+    socket_pair(fds);
+    reader_t reader;
+    memset(&reader, 0, sizeof(reader));
+    reader.fd = fds[1];
+    pthread_t thread;
+    pthread_create(&thread, NULL, read_all, &reader);
+
+    static response_stream_t out;
+    response_stream_init(&out, fds[0]);
+    char filler[RESPONSE_STREAM_CHUNK];
+    memset(filler, 'x', sizeof(filler) - 100);
+    filler[sizeof(filler) - 100] = '\0';
+    assert(response_stream_append(&out, "%s", filler) == 0);
+    assert(response_stream_append(&out, "%0200d", 0) == 1);
+    assert(out.len == strlen(filler) && out.sent == 0);
+
+    // Bigger than a chunk: sent on its own after what is buffered
+    char *big = malloc(3 * RESPONSE_STREAM_CHUNK);
+    memset(big, 'y', 3 * RESPONSE_STREAM_CHUNK - 1);
+    big[3 * RESPONSE_STREAM_CHUNK - 1] = '\0';
+    assert(response_stream_append(&out, "%s", big) == -1);
+    assert(response_stream_printf(&out, "%s", big) == 0);
+    assert(response_stream_printf(&out, "end") == 0 && response_stream_flush(&out) == 0);
+    close(fds[0]);
+    pthread_join(thread, NULL);
+    close(fds[1]);
+
+    assert(reader.len == strlen(filler) + strlen(big) + 3);
+    assert(reader.data[strlen(filler)] == 'y' && strcmp(reader.data + reader.len - 3, "end") == 0);
+    free(big);
+    free(reader.data);
+    printf("✓ Full chunks and oversized entries are handled\n");
+}
+
+static void test_closed_peer(void) {
+    int fds[2];
+    socket_pair(fds);
+    close(fds[1]);
+    static response_stream_t out;
+    response_stream_init(&out, fds[0]);
+    response_stream_printf(&out, "lost");
+    assert(response_stream_flush(&out) == -1 && out.failed);
+    assert(response_stream_printf(&out, "more") == -1);
+    close(fds[0]);
+    printf("✓ A closed peer fails the stream\n");
+}
+
+static void bench_linear(void) {
+    static const int sizes[] = {1000, 10000, 100000};
+    for (size_t i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++) {
+        reader_t reader;
+        double ms = stream_entries(sizes[i], 0, &reader);
+        printf("  %6d entries: %.3f ms (%.0f ns/entry)\n", sizes[i], ms, ms * 1e6 / sizes[i]);
+        free(reader.data);
+    }
+}
+
+int main() {
+    printf("Testing response stream...\n");
+    test_long_list_is_complete();
+    test_backpressure();
+    test_append_and_oversized_entries();
+    test_closed_peer();
+    bench_linear();
+    printf("All response stream tests passed!\n");
+    return 0;
+}
@@ -0,0 +1,90 @@
+#include <stdio.h>
+#include <string.h>
+#include <assert.h>
+#include <time.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include "../shm_snapshot.h"
+#include "../shm_reader.h"
+
+#define TEST_SHM_NAME "/monitor_rooms_test"
+#define TEST_CAPACITY 16
+#define LOOKUPS 1000000
+
+static double now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+int main() {
+    printf("Testing shared-memory room snapshot...\n");
+
+    assert(shm_snapshot_init(TEST_SHM_NAME, TEST_CAPACITY) == 0 && "Publisher init failed");
+
+    monitor_shm_t *shm = monitor_shm_open(TEST_SHM_NAME);
+    assert(shm && "Reader attach failed");
+    assert(monitor_shm_capacity(shm) == TEST_CAPACITY);
+    uint64_t generation = monitor_shm_generation(shm);
+
+    room_info_t room;
+    memset(&room, 0, sizeof(room));
+    strncpy(room.name, "cpu-room", sizeof(room.name) - 1);
+    room.state = ROOM_STATE_RUNNING;
+    room.collection_interval = 2;
+    room.latest_data.cpu_usage = 42.5f;
+    room.latest_data.process_count = 123;
+    shm_snapshot_publish_room(5, &room);
+
+    monitor_shm_room_t view;
+    assert(monitor_shm_find(shm, "cpu-room", &view) == MONITOR_SHM_OK && "Lookup failed");
+    assert(view.slot == 5);
+    assert(view.state == ROOM_STATE_RUNNING);
+    assert(view.data.cpu_usage == 42.5f);
+    assert(view.data.process_count == 123);
+    assert(monitor_shm_find(shm, "memory-room", &view) == MONITOR_SHM_NOT_FOUND);
+
+    printf("Testing slot clear...\n");
+    shm_snapshot_clear_room(5);
+    assert(monitor_shm_read_slot(shm, 5, &view) == MONITOR_SHM_NOT_FOUND);
+
+    printf("Testing restart keeps readers attached...\n");
+    shm_snapshot_publish_room(5, &room);
+    assert(shm_snapshot_init(TEST_SHM_NAME, TEST_CAPACITY) == 0);
+    assert(monitor_shm_generation(shm) == generation + 1);
+    assert(monitor_shm_read_slot(shm, 5, &view) == MONITOR_SHM_NOT_FOUND && "Restart must reset slots");
+    shm_snapshot_publish_room(5, &room);
+
+    double start = now_ns();
+    for (int i = 0; i < LOOKUPS; i++) {
+        monitor_shm_find(shm, "cpu-room", &view);
+    }
+    double per_lookup = (now_ns() - start) / LOOKUPS;
+    printf("Lookup by name: %.1f ns\n", per_lookup);
+
+    printf("Testing retired segment...\n");
+    shm_snapshot_cleanup();
+    assert(monitor_shm_find(shm, "cpu-room", &view) == MONITOR_SHM_STALE);
+    assert(monitor_shm_reopen(shm) != 0);
+    monitor_shm_close(shm);
+
+    printf("Testing header with a bad entry offset...\n");
+    int fd = shm_open(TEST_SHM_NAME, O_CREAT | O_RDWR | O_TRUNC, 0600);
+    assert(fd >= 0);
+    assert(ftruncate(fd, SHM_SNAPSHOT_SIZE(TEST_CAPACITY)) == 0);
+    shm_snapshot_header_t hdr;
+    memset(&hdr, 0, sizeof(hdr));
+    hdr.magic = SHM_SNAPSHOT_MAGIC;
+    hdr.version = SHM_SNAPSHOT_VERSION;
+    hdr.header_size = 1u << 30;
+    hdr.entry_size = sizeof(shm_snapshot_entry_t);
+    hdr.capacity = TEST_CAPACITY;
+    assert(pwrite(fd, &hdr, sizeof(hdr), 0) == (ssize_t)sizeof(hdr));
+    close(fd);
+    assert(monitor_shm_open(TEST_SHM_NAME) == NULL && "Reader must reject a foreign header size");
+    shm_unlink(TEST_SHM_NAME);
+
+    printf("All shared-memory snapshot tests passed!\n");
+    return 0;
+}
@@ -0,0 +1,136 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include <time.h>
+#include <unistd.h>
+#include "../state_snapshot.h"
+#include "../room_history.h"
+#include "../mem_budget.h"
+
+#define TEST_SNAPSHOT_PATH "/tmp/monitor_snapshot_test.snap"
+
+static double now_ms(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e3 + ts.tv_nsec / 1e6;
+}
+
+static void fill_record(room_record_t *record, int i) {
+    memset(record, 0, sizeof(*record));
+    snprintf(record->name, sizeof(record->name), "room-%d", i);
+    record->state = (i % 2) ? ROOM_STATE_RUNNING : ROOM_STATE_CREATED;
+    record->collection_interval = 1 + i % 10;
+    record->created_time = 1000 + i;
+}
+
+typedef struct {
+    int rooms;
+    int samples;
+    int mismatches;
+} visit_ctx_t;
+
+static int count_room(const room_record_t *record, const monitor_data_t *history,
+                      int history_count, void *arg) {
+    visit_ctx_t *ctx = arg;
+    room_record_t expected;
+    fill_record(&expected, ctx->rooms);
+    if (strcmp(record->name, expected.name) != 0 || record->state != expected.state ||
+        record->collection_interval != expected.collection_interval) {
+        ctx->mismatches++;
+    }
+    for (int i = 0; i < history_count; i++) {
+        if (history[i].timestamp != (time_t)i) ctx->mismatches++;
+    }
+    ctx->rooms++;
+    ctx->samples += history_count;
+    return 0;
+}
+
+static int write_snapshot(int rooms, int depth) {
+    monitor_data_t history[ROOM_HISTORY_DEPTH];
+    memset(history, 0, sizeof(history));
+    for (int i = 0; i < depth; i++) {
+        history[i].timestamp = (time_t)i;
+        history[i].cpu_usage = (float)i;
+        history[i].valid = 1;
+    }
+
+    state_snapshot_writer_t writer;
+    if (state_snapshot_begin(&writer) != 0) return -1;
+    for (int i = 0; i < rooms; i++) {
+        room_record_t record;
+        fill_record(&record, i);
+        if (state_snapshot_add_room(&writer, &record, history, depth) != 0) {
+            state_snapshot_abort(&writer);
+            return -1;
+        }
+    }
+    return state_snapshot_commit(&writer, TEST_SNAPSHOT_PATH);
+}
+
+static void test_round_trip(void) {
+    assert(write_snapshot(8, 5) == 0 && "Snapshot write failed");
+
+    visit_ctx_t ctx = {0, 0, 0};
+    assert(state_snapshot_load(TEST_SNAPSHOT_PATH, count_room, &ctx) == 8);
+    assert(ctx.rooms == 8 && ctx.samples == 40 && ctx.mismatches == 0);
+    assert(access(TEST_SNAPSHOT_PATH ".tmp", F_OK) != 0 && "Temporary file left behind");
+    printf("✓ Round trip preserves rooms and history\n");
+}
+
+static void test_rejects_corruption(void) {
+    assert(write_snapshot(4, 3) == 0);
+
+    FILE *f = fopen(TEST_SNAPSHOT_PATH, "r+b");
+    assert(f);
+    fseek(f, (long)sizeof(state_snapshot_header_t) + 7, SEEK_SET);
+    fputc(0x5a, f);
+    fclose(f);
+
+    visit_ctx_t ctx = {0, 0, 0};
+    assert(state_snapshot_load(TEST_SNAPSHOT_PATH, count_room, &ctx) == -1);
+    assert(ctx.rooms == 0 && "Corrupt snapshot must not be visited");
+
+    unlink(TEST_SNAPSHOT_PATH);
+    assert(state_snapshot_load(TEST_SNAPSHOT_PATH, count_room, &ctx) == 0);
+    printf("✓ Corrupt and missing snapshots are rejected\n");
+}
+
+static void test_budget_refusal(void) {
+    // The checkpoint buffer is charged to the memory budget while it is built
+    mem_budget_set_limit(16 * 1024);
+    assert(write_snapshot(8, 5) == 0);
+    assert(write_snapshot(64, ROOM_HISTORY_DEPTH) == -1);
+    assert(mem_used(MEM_SNAPSHOT) == 0);
+    mem_budget_set_limit((size_t)MEM_DEFAULT_BUDGET_KB * 1024);
+    assert(write_snapshot(64, ROOM_HISTORY_DEPTH) == 0 && mem_used(MEM_SNAPSHOT) == 0);
+    printf("✓ Snapshots over the memory budget fail without leaking the charge\n");
+}
+
+static void bench_restore(void) {
+    static const int sizes[] = {10, 100, 1000, 10000};
+    // Larger than any daemon room table, so the benchmark runs unbudgeted
+    mem_budget_set_limit(0);
+    for (size_t i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++) {
+        double t0 = now_ms();
+        assert(write_snapshot(sizes[i], ROOM_HISTORY_DEPTH) == 0);
+        double t1 = now_ms();
+        visit_ctx_t ctx = {0, 0, 0};
+        assert(state_snapshot_load(TEST_SNAPSHOT_PATH, count_room, &ctx) == sizes[i]);
+        double t2 = now_ms();
+        printf("  %5d rooms x %d samples: write %.3f ms, load %.3f ms\n",
+               sizes[i], ROOM_HISTORY_DEPTH, t1 - t0, t2 - t1);
+    }
+    unlink(TEST_SNAPSHOT_PATH);
+}
+
+int main() {
+    printf("Testing state snapshot...\n");
+    test_round_trip();
+    test_rejects_corruption();
+    test_budget_refusal();
+    bench_restore();
+    printf("All state snapshot tests passed!\n");
+    return 0;
+}
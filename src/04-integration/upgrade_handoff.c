@@ -0,0 +1,432 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <errno.h>
+#include <poll.h>
+#include <pthread.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <sys/stat.h>
+#include "upgrade_handoff.h"
+#include "main_daemon.h"
+#include "room_history.h"
+#include "metric_schema.h"
+#include "supervisor.h"
+#include "logger.h"
+
+#define UPGRADE_ACK_OK 'K'
+#define UPGRADE_ACK_FAIL 'F'
+#define UPGRADE_RELEASED 'R'    // old process saw the ack and is exiting
+
+typedef struct {
+    int listen_fd;
+    char path[108];
+    pthread_t thread;
+    int running;
+} upgrade_context_t;
+
+static upgrade_context_t upgrade_ctx = {-1, "", 0, 0};
+
+static int send_all(int fd, const void *buf, size_t len) {
+    const char *p = buf;
+    while (len > 0) {
+        ssize_t n = send(fd, p, len, MSG_NOSIGNAL);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            return -1;
+        }
+        p += n;
+        len -= (size_t)n;
+    }
+    return 0;
+}
+
+static int recv_all(int fd, void *buf, size_t len) {
+    char *p = buf;
+    while (len > 0) {
+        ssize_t n = recv(fd, p, len, 0);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return -1;
+        p += n;
+        len -= (size_t)n;
+    }
+    return 0;
+}
+
+// Send descriptors in SCM_RIGHTS batches, each riding on a one-byte payload
+static int send_fds(int channel, const int *fds, int count) {
+    for (int sent = 0; sent < count; ) {
+        int batch = count - sent;
+        if (batch > UPGRADE_FDS_PER_MSG) batch = UPGRADE_FDS_PER_MSG;
+
+        char byte = 'F';
+        struct iovec iov = { .iov_base = &byte, .iov_len = 1 };
+        union {
+            char buf[CMSG_SPACE(sizeof(int) * UPGRADE_FDS_PER_MSG)];
+            struct cmsghdr align;
+        } control;
+        memset(&control, 0, sizeof(control));
+
+        struct msghdr msg = {0};
+        msg.msg_iov = &iov;
+        msg.msg_iovlen = 1;
+        msg.msg_control = control.buf;
+        msg.msg_controllen = CMSG_SPACE(sizeof(int) * batch);
+
+        struct cmsghdr *cmsg = CMSG_FIRSTHDR(&msg);
+        cmsg->cmsg_level = SOL_SOCKET;
+        cmsg->cmsg_type = SCM_RIGHTS;
+        cmsg->cmsg_len = CMSG_LEN(sizeof(int) * batch);
+        memcpy(CMSG_DATA(cmsg), fds + sent, sizeof(int) * batch);
+
+        if (sendmsg(channel, &msg, MSG_NOSIGNAL) != 1) {
+            return -1;
+        }
+        sent += batch;
+    }
+    return 0;
+}
+
+static int recv_fds(int channel, int *fds, int count) {
+    int received = 0;
+    while (received < count) {
+        char byte;
+        struct iovec iov = { .iov_base = &byte, .iov_len = 1 };
+        union {
+            char buf[CMSG_SPACE(sizeof(int) * UPGRADE_FDS_PER_MSG)];
+            struct cmsghdr align;
+        } control;
+
+        struct msghdr msg = {0};
+        msg.msg_iov = &iov;
+        msg.msg_iovlen = 1;
+        msg.msg_control = control.buf;
+        msg.msg_controllen = sizeof(control.buf);
+
+        if (recvmsg(channel, &msg, MSG_CMSG_CLOEXEC) != 1 || (msg.msg_flags & MSG_CTRUNC)) {
+            return -1;
+        }
+        for (struct cmsghdr *cmsg = CMSG_FIRSTHDR(&msg); cmsg; cmsg = CMSG_NXTHDR(&msg, cmsg)) {
+            if (cmsg->cmsg_level != SOL_SOCKET || cmsg->cmsg_type != SCM_RIGHTS) continue;
+            int n = (int)((cmsg->cmsg_len - CMSG_LEN(0)) / sizeof(int));
+            if (n > count - received) return -1;
+            memcpy(fds + received, CMSG_DATA(cmsg), sizeof(int) * n);
+            received += n;
+        }
+    }
+    return 0;
+}
+
+// Old process: ship state and descriptors to the connected successor.
+// On success rooms_mutex stays locked so nothing is collected or published
+// twice before this process exits.
+static int handoff_to(int channel) {
+    suspend_network_io();
+
+    pthread_mutex_lock(&g_daemon_state.rooms_mutex);
+    pthread_mutex_lock(&g_daemon_state.clients_mutex);
+
+    int max_rooms = g_daemon_state.config.max_rooms;
+    int max_clients = g_daemon_state.config.max_clients;
+    room_record_t *rooms = calloc(max_rooms > 0 ? max_rooms : 1, sizeof(room_record_t));
+    uint32_t *history_counts = calloc(max_rooms > 0 ? max_rooms : 1, sizeof(uint32_t));
+    monitor_data_t *history = malloc(sizeof(monitor_data_t) * ROOM_HISTORY_DEPTH *
+                                     (max_rooms > 0 ? max_rooms : 1));
+    upgrade_client_record_t *clients = calloc(max_clients > 0 ? max_clients : 1,
+                                              sizeof(upgrade_client_record_t));
+    int *fds = calloc((size_t)max_clients + 1, sizeof(int));
+
+    upgrade_header_t header;
+    memset(&header, 0, sizeof(header));
+    header.magic = UPGRADE_MAGIC;
+    header.version = UPGRADE_VERSION;
+    header.room_record_size = sizeof(room_record_t);
+    header.client_record_size = sizeof(upgrade_client_record_t);
+    header.sample_size = sizeof(monitor_data_t);
+    header.sample_schema = monitor_schema_id();
+    header.start_time = (int64_t)g_daemon_state.start_time;
+    header.stats = g_daemon_stats;
+
+    int ok = rooms && history_counts && history && clients && fds;
+    if (ok) {
+        for (int i = 0; i < max_rooms; i++) {
+            if (g_daemon_state.rooms[i].state == ROOM_STATE_INACTIVE) continue;
+            room_record_capture(&g_daemon_state.rooms[i], &rooms[header.room_count]);
+            int count = room_history_copy(i, history + header.history_samples, ROOM_HISTORY_DEPTH);
+            history_counts[header.room_count++] = (uint32_t)count;
+            header.history_samples += (uint32_t)count;
+        }
+        fds[0] = g_daemon_state.server_socket;
+        for (int i = 0; i < max_clients; i++) {
+            client_connection_t *client = &g_daemon_state.clients[i];
+            if (!client->active) continue;
+            upgrade_client_record_t *rec = &clients[header.client_count];
+            rec->address = client->address;
+            rec->connect_time = (int64_t)client->connect_time;
+            rec->last_activity = (int64_t)client->last_activity;
+            fds[1 + header.client_count] = client->socket_fd;
+            header.client_count++;
+        }
+    }
+    pthread_mutex_unlock(&g_daemon_state.clients_mutex);
+
+    char ack = UPGRADE_ACK_FAIL;
+    ok = ok &&
+         send_all(channel, &header, sizeof(header)) == 0 &&
+         send_all(channel, rooms, sizeof(room_record_t) * header.room_count) == 0 &&
+         send_all(channel, history_counts, sizeof(uint32_t) * header.room_count) == 0 &&
+         send_all(channel, history, sizeof(monitor_data_t) * header.history_samples) == 0 &&
+         send_all(channel, clients, sizeof(upgrade_client_record_t) * header.client_count) == 0 &&
+         send_fds(channel, fds, 1 + (int)header.client_count) == 0 &&
+         recv_all(channel, &ack, 1) == 0 &&
+         ack == UPGRADE_ACK_OK;
+    // Only a successor that reads this serves, so an ack that arrives after
+    // the timeout cannot leave both processes on the sockets
+    char released = UPGRADE_RELEASED;
+    ok = ok && send_all(channel, &released, 1) == 0;
+
+    if (ok) {
+        log_info("Handed off %u rooms with %u history samples and %u clients",
+                 header.room_count, header.history_samples, header.client_count);
+    } else {
+        log_error("Upgrade handoff failed, resuming service");
+        pthread_mutex_unlock(&g_daemon_state.rooms_mutex);
+        resume_network_io();
+    }
+
+    free(rooms);
+    free(history_counts);
+    free(history);
+    free(clients);
+    free(fds);
+    return ok ? 0 : -1;
+}
+
+// A supervised daemon cannot be replaced: the supervisor only watches its
+// own child and would take the clean exit after the handoff for a stop
+static void refuse_handoff(int channel) {
+    upgrade_header_t header;
+    memset(&header, 0, sizeof(header));
+    header.magic = UPGRADE_REFUSED;
+    header.version = UPGRADE_VERSION;
+    send_all(channel, &header, sizeof(header));
+    log_warn("Refusing upgrade: daemon is running under --supervise");
+}
+
+// Only the same user may take over the daemon
+static int peer_allowed(int channel) {
+    struct ucred cred;
+    socklen_t len = sizeof(cred);
+    if (getsockopt(channel, SOL_SOCKET, SO_PEERCRED, &cred, &len) != 0) {
+        return 0;
+    }
+    if (cred.uid != getuid()) {
+        log_warn("Rejecting upgrade request from uid %d", (int)cred.uid);
+        return 0;
+    }
+    log_info("Upgrade requested by pid %d", (int)cred.pid);
+    return 1;
+}
+
+static void* upgrade_listener_thread(void *arg) {
+    (void)arg;
+    while (upgrade_ctx.running && g_daemon_state.running) {
+        struct pollfd pfd = { .fd = upgrade_ctx.listen_fd, .events = POLLIN };
+        if (poll(&pfd, 1, 500) <= 0) continue;
+
+        int channel = accept(upgrade_ctx.listen_fd, NULL, NULL);
+        if (channel < 0) continue;
+
+        struct timeval tv = { .tv_sec = UPGRADE_ACK_TIMEOUT_SEC, .tv_usec = 0 };
+        setsockopt(channel, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+
+        if (!peer_allowed(channel)) {
+            close(channel);
+            continue;
+        }
+        if (supervisor_active()) {
+            refuse_handoff(channel);
+        } else if (handoff_to(channel) == 0) {
+            // The successor owns every socket, the FIFO, shared memory and
+            // the PID file now; leave without running cleanup_on_exit()
+            log_info("=== Process Monitor Integration Daemon exiting after upgrade ===");
+            _exit(0);
+        }
+        close(channel);
+    }
+    return NULL;
+}
+
+int upgrade_listener_start(const char *socket_path) {
+    int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (fd < 0) {
+        log_error("Failed to create upgrade socket: %s", strerror(errno));
+        return -1;
+    }
+
+    struct sockaddr_un addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    strncpy(addr.sun_path, socket_path, sizeof(addr.sun_path) - 1);
+
+    // A predecessor may still be bound to the path; the name is ours now
+    unlink(socket_path);
+    if (bind(fd, (struct sockaddr *)&addr, sizeof(addr)) < 0 || listen(fd, 1) < 0) {
+        log_error("Failed to bind upgrade socket %s: %s", socket_path, strerror(errno));
+        close(fd);
+        return -1;
+    }
+    chmod(socket_path, 0600);
+
+    upgrade_ctx.listen_fd = fd;
+    strncpy(upgrade_ctx.path, socket_path, sizeof(upgrade_ctx.path) - 1);
+    upgrade_ctx.running = 1;
+    if (pthread_create(&upgrade_ctx.thread, NULL, upgrade_listener_thread, NULL) != 0) {
+        log_error("Failed to create upgrade listener thread");
+        upgrade_ctx.running = 0;
+        close(fd);
+        unlink(socket_path);
+        upgrade_ctx.listen_fd = -1;
+        return -1;
+    }
+    log_info("Upgrade socket listening at %s", socket_path);
+    return 0;
+}
+
+void upgrade_listener_stop(void) {
+    if (upgrade_ctx.listen_fd < 0) return;
+    upgrade_ctx.running = 0;
+    pthread_join(upgrade_ctx.thread, NULL);
+    close(upgrade_ctx.listen_fd);
+    unlink(upgrade_ctx.path);
+    upgrade_ctx.listen_fd = -1;
+}
+
+// New process: connect to the running daemon and receive its state
+int upgrade_receive_state(const char *socket_path, upgrade_state_t *state) {
+    memset(state, 0, sizeof(*state));
+    state->channel_fd = -1;
+    state->listen_fd = -1;
+
+    int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (fd < 0) return -1;
+
+    struct sockaddr_un addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    strncpy(addr.sun_path, socket_path, sizeof(addr.sun_path) - 1);
+    if (connect(fd, (struct sockaddr *)&addr, sizeof(addr)) < 0) {
+        log_error("No running daemon at %s: %s", socket_path, strerror(errno));
+        close(fd);
+        return -1;
+    }
+    state->channel_fd = fd;
+
+    upgrade_header_t *hdr = &state->header;
+    int received = recv_all(fd, hdr, sizeof(*hdr)) == 0;
+    if (received && hdr->magic == UPGRADE_REFUSED) {
+        log_error("Running daemon is supervised; stop its supervisor and start "
+                  "the new binary with --supervise instead of using --upgrade");
+        upgrade_complete(state, 0);
+        return -1;
+    }
+    if (!received || hdr->magic != UPGRADE_MAGIC || hdr->version != UPGRADE_VERSION ||
+        hdr->room_record_size != sizeof(room_record_t) ||
+        hdr->client_record_size != sizeof(upgrade_client_record_t) ||
+        hdr->sample_size != sizeof(monitor_data_t) ||
+        hdr->sample_schema != monitor_schema_id() ||
+        hdr->history_samples > (uint64_t)hdr->room_count * ROOM_HISTORY_DEPTH) {
+        log_error("Incompatible upgrade handoff from running daemon");
+        upgrade_complete(state, 0);
+        return -1;
+    }
+
+    state->rooms = calloc(hdr->room_count + 1, sizeof(room_record_t));
+    state->history_counts = calloc(hdr->room_count + 1, sizeof(uint32_t));
+    state->history = calloc(hdr->history_samples + 1, sizeof(monitor_data_t));
+    state->clients = calloc(hdr->client_count + 1, sizeof(upgrade_client_record_t));
+    int *fds = calloc(hdr->client_count + 1, sizeof(int));
+    if (!state->rooms || !state->history_counts || !state->history || !state->clients || !fds ||
+        recv_all(fd, state->rooms, sizeof(room_record_t) * hdr->room_count) != 0 ||
+        recv_all(fd, state->history_counts, sizeof(uint32_t) * hdr->room_count) != 0 ||
+        recv_all(fd, state->history, sizeof(monitor_data_t) * hdr->history_samples) != 0 ||
+        recv_all(fd, state->clients, sizeof(upgrade_client_record_t) * hdr->client_count) != 0 ||
+        recv_fds(fd, fds, 1 + (int)hdr->client_count) != 0) {
+        log_error("Failed to receive upgrade state");
+        free(fds);
+        upgrade_complete(state, 0);
+        return -1;
+    }
+
+    state->listen_fd = fds[0];
+    uint64_t samples = 0;
+    for (uint32_t i = 0; i < hdr->room_count; i++) {
+        if (state->history_counts[i] > ROOM_HISTORY_DEPTH) samples = UINT64_MAX;
+        else samples += state->history_counts[i];
+    }
+    if (samples != hdr->history_samples) {
+        log_error("Inconsistent room history in upgrade handoff");
+        free(fds);
+        upgrade_complete(state, 0);
+        return -1;
+    }
+    state->client_fds = malloc(sizeof(int) * (hdr->client_count + 1));
+    if (!state->client_fds) {
+        free(fds);
+        upgrade_complete(state, 0);
+        return -1;
+    }
+    memcpy(state->client_fds, fds + 1, sizeof(int) * hdr->client_count);
+    free(fds);
+
+    log_info("Received %u rooms with %u history samples and %u clients from running daemon",
+             hdr->room_count, hdr->history_samples, hdr->client_count);
+    return 0;
+}
+
+// Tell the old process whether we take over. On success, wait for it to
+// confirm it is letting go; -1 means it kept serving and the received
+// sockets are closed again. Records are freed on failure only; after a
+// successful takeover the caller restores them and calls upgrade_release().
+int upgrade_complete(upgrade_state_t *state, int success) {
+    int rc = 0;
+    if (state->channel_fd >= 0) {
+        char ack = success ? UPGRADE_ACK_OK : UPGRADE_ACK_FAIL;
+        char released = 0;
+        rc = send_all(state->channel_fd, &ack, 1);
+        if (success && rc == 0) {
+            struct timeval tv = { .tv_sec = UPGRADE_ACK_TIMEOUT_SEC, .tv_usec = 0 };
+            setsockopt(state->channel_fd, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+            if (recv_all(state->channel_fd, &released, 1) != 0 || released != UPGRADE_RELEASED) {
+                rc = -1;
+            }
+        }
+        close(state->channel_fd);
+        state->channel_fd = -1;
+    }
+    if (!success || rc != 0) {
+        // The old process still serves these sockets
+        if (state->listen_fd >= 0) close(state->listen_fd);
+        for (uint32_t i = 0; state->client_fds && i < state->header.client_count; i++) {
+            close(state->client_fds[i]);
+        }
+        state->listen_fd = -1;
+        upgrade_release(state);
+    }
+    return rc;
+}
+
+// Free the records received with the state
+void upgrade_release(upgrade_state_t *state) {
+    free(state->rooms);
+    free(state->history_counts);
+    free(state->history);
+    free(state->clients);
+    free(state->client_fds);
+    state->rooms = NULL;
+    state->history_counts = NULL;
+    state->history = NULL;
+    state->clients = NULL;
+    state->client_fds = NULL;
+}
@@ -0,0 +1,64 @@
+#ifndef UPGRADE_HANDOFF_H
+#define UPGRADE_HANDOFF_H
+
+#include <stdint.h>
+#include <netinet/in.h>
+#include "../commom/data_structures.h"
+#include "room_record.h"
+
+// Local control socket the running daemon listens on for `--upgrade`
+#define UPGRADE_SOCKET_PATH "/tmp/monitor_upgrade.sock"
+#define UPGRADE_MAGIC 0x55504752u   // "UPGR"
+#define UPGRADE_REFUSED 0x55505246u // "UPRF", header-sized reply with no state
+#define UPGRADE_VERSION 3
+#define UPGRADE_FDS_PER_MSG 64
+#define UPGRADE_ACK_TIMEOUT_SEC 5
+
+// Wire header; followed by room records, a history count per room, the
+// history samples of every room (oldest first), client records, then the
+// descriptors (listening socket first) as SCM_RIGHTS batches. The
+// successor answers with an ack byte and the old process confirms a
+// positive ack before exiting.
+typedef struct {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t room_record_size;
+    uint32_t client_record_size;
+    uint32_t room_count;
+    uint32_t client_count;
+    uint32_t sample_size;
+    uint32_t sample_schema;     // monitor_schema_id() of the samples
+    uint32_t history_samples;   // total over all rooms
+    uint32_t reserved;
+    int64_t start_time;
+    daemon_stats_t stats;
+} upgrade_header_t;
+
+typedef struct {
+    struct sockaddr_in address;
+    int64_t connect_time;
+    int64_t last_activity;
+} upgrade_client_record_t;
+
+// State received by the new process
+typedef struct {
+    int channel_fd;
+    int listen_fd;
+    upgrade_header_t header;
+    room_record_t *rooms;
+    uint32_t *history_counts;       // per room, in room order
+    monitor_data_t *history;
+    upgrade_client_record_t *clients;
+    int *client_fds;
+} upgrade_state_t;
+
+// Old process side
+int upgrade_listener_start(const char *socket_path);
+void upgrade_listener_stop(void);
+
+// New process side
+int upgrade_receive_state(const char *socket_path, upgrade_state_t *state);
+int upgrade_complete(upgrade_state_t *state, int success);
+void upgrade_release(upgrade_state_t *state);
+
+#endif /* UPGRADE_HANDOFF_H */
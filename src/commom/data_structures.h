@@ -0,0 +1,138 @@
+#ifndef DATA_STRUCTURES_H
+#define DATA_STRUCTURES_H
+
+#include <stdint.h>
+#include <time.h>
+#include <pthread.h>
+#include <netinet/in.h>
+#include "../04-integration/logger.h"
+
+// Table and buffer limits
+#define MAX_ROOM_NAME 64
+#define MAX_MESSAGE_SIZE 1024
+#define MAX_ROOMS 64
+#define MAX_CLIENTS 64
+
+// Kernel module interfaces
+#define DEFAULT_FIFO_PATH "/tmp/monitor_fifo"
+#define DEFAULT_PROCFS_PATH "/proc/sysmonitor"
+
+// Room lifecycle
+typedef enum {
+    ROOM_STATE_INACTIVE = 0,    // slot is free
+    ROOM_STATE_CREATED = 1,
+    ROOM_STATE_RUNNING = 2,
+    ROOM_STATE_STOPPED = 3,
+    ROOM_STATE_ERROR = 4        // monitor thread gave up after repeated errors
+} room_state_t;
+
+// Client commands
+typedef enum {
+    CMD_CREATE_ROOM = 1,
+    CMD_START_ROOM = 2,
+    CMD_STOP_ROOM = 3,
+    CMD_DELETE_ROOM = 4,
+    CMD_SHOW_ROOM = 5,
+    CMD_LIST_ROOMS = 6,
+    CMD_STATUS = 7
+} command_type_t;
+
+// Reply status
+typedef enum {
+    RESP_SUCCESS = 0,
+    RESP_ERROR = 1,
+    RESP_ROOM_NOT_FOUND = 2,
+    RESP_INVALID_COMMAND = 3
+} response_type_t;
+
+// One sample of a room
+typedef struct {
+    char room_name[MAX_ROOM_NAME];
+    float cpu_usage;            // percent
+    float memory_usage;         // percent
+    unsigned long memory_free;  // kB
+    int process_count;
+    time_t timestamp;
+    int valid;
+} monitor_data_t;
+
+// Parsed client command
+typedef struct {
+    command_type_t type;
+    char room_name[MAX_ROOM_NAME];
+    int param1;
+    int param2;
+    char param_str[256];
+    time_t timestamp;
+} command_t;
+
+// Reply to one command
+typedef struct {
+    response_type_t type;
+    char message[MAX_MESSAGE_SIZE];
+    char data[MAX_MESSAGE_SIZE];
+    time_t timestamp;
+} response_t;
+
+// Room slot, guarded by daemon_state_t.rooms_mutex
+typedef struct {
+    char name[MAX_ROOM_NAME];
+    room_state_t state;
+    time_t created_time;
+    time_t last_update;
+    int collection_interval;    // seconds
+    volatile int active;        // cleared to stop the monitor thread
+    int error_count;
+    pthread_t monitor_thread;
+    monitor_data_t latest_data;
+} room_info_t;
+
+// Client slot, guarded by daemon_state_t.clients_mutex
+typedef struct {
+    int socket_fd;
+    struct sockaddr_in address;
+    time_t connect_time;
+    time_t last_activity;
+    int authenticated;
+    volatile int active;
+    pthread_t thread;
+} client_connection_t;
+
+// Daemon configuration
+typedef struct {
+    char log_path[256];
+    log_level_t log_level;
+    int structured_logging;
+    int daemon_port;
+    int max_rooms;              // at most MAX_ROOMS
+    int max_clients;            // at most MAX_CLIENTS
+    int collection_interval;    // default for new rooms, seconds
+    char fifo_path[256];
+    char procfs_path[256];
+    char pid_file[256];
+} config_t;
+
+// Global daemon state
+typedef struct {
+    config_t config;
+    room_info_t rooms[MAX_ROOMS];
+    int room_count;
+    client_connection_t clients[MAX_CLIENTS];
+    int client_count;
+    pthread_mutex_t rooms_mutex;
+    pthread_mutex_t clients_mutex;
+    volatile int running;
+    time_t start_time;
+    int server_socket;
+    pthread_t network_thread;
+} daemon_state_t;
+
+// Counters reported by `status`
+typedef struct {
+    unsigned long commands_processed;
+    unsigned long data_points_collected;
+    unsigned long rooms_created;
+    unsigned long rooms_deleted;
+} daemon_stats_t;
+
+#endif /* DATA_STRUCTURES_H */